@@ -7,7 +7,11 @@ namespace core {
 
 struct GeometryFunctionLocalState : FunctionLocalState {
 public:
+	static constexpr auto PART_INDEX_SETTING = "geometry_part_index";
+
 	ArenaAllocator arena;
+	//! Whether large collections are written in the version 1 format, see the geometry_part_index setting
+	bool write_part_index;
 
 public:
 	explicit GeometryFunctionLocalState(ClientContext &context);
@@ -16,6 +20,9 @@ public:
 	static unique_ptr<FunctionLocalState> InitCast(CastLocalStateParameters &context);
 	static GeometryFunctionLocalState &ResetAndGet(ExpressionState &state);
 	static GeometryFunctionLocalState &ResetAndGet(CastParameters &parameters);
+
+	//! Register the geometry_part_index setting
+	static void Register(DatabaseInstance &db);
 };
 
 } // namespace core
@@ -17,6 +17,7 @@ public:
 		RegisterStCentroid(db);
 		RegisterStCollect(db);
 		RegisterStCollectionExtract(db);
+		RegisterStCompress(db);
 		RegisterStContains(db);
 		RegisterStDimension(db);
 		RegisterStDistance(db);
@@ -26,6 +27,7 @@ public:
 		RegisterStExteriorRing(db);
 		RegisterStFlipCoordinates(db);
 		RegisterStForce(db);
+		RegisterStGeometryN(db);
 		RegisterStGeometryType(db);
 		RegisterStGeomFromHEXWKB(db);
 		RegisterStGeomFromText(db);
@@ -94,6 +96,9 @@ private:
 	// ST_CollectionExtract
 	static void RegisterStCollectionExtract(DatabaseInstance &db);
 
+	// ST_Compress
+	static void RegisterStCompress(DatabaseInstance &db);
+
 	// ST_Contains
 	static void RegisterStContains(DatabaseInstance &db);
 
@@ -121,6 +126,9 @@ private:
 	// ST_Force(2D/3D)
 	static void RegisterStForce(DatabaseInstance &db);
 
+	// ST_GeometryN
+	static void RegisterStGeometryN(DatabaseInstance &db);
+
 	// ST_GeometryType
 	static void RegisterStGeometryType(DatabaseInstance &db);
 
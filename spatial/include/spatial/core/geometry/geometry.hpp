@@ -207,8 +207,21 @@ public:
 	static Geometry Create(ArenaAllocator &alloc, GeometryType type, uint32_t count, bool has_z, bool has_m);
 	static Geometry CreateEmpty(GeometryType type, bool has_z, bool has_m);
 
-	static geometry_t Serialize(const Geometry &geom, Vector &result);
+	// Large collections are only written in the version 1 format (with a part index) if write_part_index is set
+	static geometry_t Serialize(const Geometry &geom, Vector &result, bool write_part_index = false);
 	static Geometry Deserialize(ArenaAllocator &arena, const geometry_t &data);
+	// Deserialize a single part of a serialized geometry, see GeometryPartReader
+	static Geometry DeserializePart(ArenaAllocator &arena, const geometry_t &data, const_data_ptr_t part_ptr);
+
+	// Compress a serialized geometry by rounding its coordinates to the given number of decimal digits. Returns false
+	// if the coordinates can't be represented at that precision, or if the result wouldn't be smaller.
+	static bool TryCompress(const geometry_t &data, uint8_t precision, Vector &result, geometry_t &compressed);
+	// Decompress a compressed geometry into the arena, uncompressed geometries are returned as is
+	static geometry_t Decompress(ArenaAllocator &arena, const geometry_t &data);
+	static uint32_t GetDecompressedSize(const geometry_t &data);
+	static void Decompress(const geometry_t &data, data_ptr_t target);
+	// Deserialize a compressed geometry, decoding the vertices directly into the arena (see Deserialize)
+	static Geometry DeserializeCompressed(ArenaAllocator &arena, const geometry_t &data);
 
 	static bool IsEmpty(const Geometry &geom);
 	static uint32_t GetDimension(const Geometry &geom, bool recurse);
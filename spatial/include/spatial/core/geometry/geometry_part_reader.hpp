@@ -0,0 +1,64 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_type.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// GeometryPartReader
+//------------------------------------------------------------------------
+// Provides access to the parts of a serialized collection (Multi*/GeometryCollection) without deserializing it.
+// Version 1 geometries have a part index, so any part (and its bounding box) can be found in constant time.
+// For version 0 geometries the parts are found by skipping over the parts before them, since the reader remembers
+// where the last part it returned ended, iterating over all parts in order is still linear.
+// Compressed geometries have to be decompressed (with Geometry::Decompress) first.
+//------------------------------------------------------------------------
+class GeometryPartReader {
+public:
+	explicit GeometryPartReader(const geometry_t &geom);
+
+	// Returns true if the geometry is a collection
+	bool IsCollection() const {
+		return is_collection;
+	}
+	// Returns the number of parts of the collection, or 0 if the geometry is not a collection
+	uint32_t PartCount() const {
+		return part_count;
+	}
+	// Returns true if the parts and their bounds can be accessed in constant time
+	bool HasPartIndex() const {
+		return offsets_ptr != nullptr;
+	}
+
+	// Returns a pointer to the serialized data of the part, to be passed to GeometryProcessor::ProcessPart
+	const_data_ptr_t GetPart(uint32_t index);
+
+	// Get the (float precision, rounded outwards) 2D bounds of the part, only possible if the geometry has a part index.
+	// Empty parts have inverted bounds that don't contain or intersect anything.
+	bool TryGetPartBounds(uint32_t index, Box2D<double> &bbox) const;
+
+	// Deserialize a single part
+	Geometry ReadPart(ArenaAllocator &arena, uint32_t index);
+
+private:
+	geometry_t geom;
+	uint32_t vertex_size = 0;
+	bool is_collection = false;
+	uint32_t part_count = 0;
+
+	// The part index (version 1 only)
+	const_data_ptr_t offsets_ptr = nullptr;
+	const_data_ptr_t bounds_ptr = nullptr;
+
+	// The first part, and the part after the last one we returned (version 0 only)
+	const_data_ptr_t first_ptr = nullptr;
+	const_data_ptr_t next_ptr = nullptr;
+	uint32_t next_index = 0;
+};
+
+} // namespace core
+
+} // namespace spatial
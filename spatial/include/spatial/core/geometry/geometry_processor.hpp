@@ -111,6 +111,8 @@ private:
 	uint32_t nesting_level = 0;
 	GeometryType current_type = GeometryType::POINT;
 	GeometryType parent_type = GeometryType::POINT;
+	// Compressed geometries are decompressed into this buffer before they are processed
+	vector<data_t> decompressed;
 
 protected:
 	bool HasZ() const {
@@ -218,7 +220,15 @@ protected:
 	virtual RESULT ProcessCollection(CollectionState &state, ARGS... args) = 0;
 
 public:
-	RESULT Process(const geometry_t &geom, ARGS... args) {
+	RESULT Process(const geometry_t &input, ARGS... args) {
+
+		auto geom = input;
+		if (geom.GetProperties().IsCompressed()) {
+			// The buffer is reused, so the vertex data is only valid until the next call to Process
+			decompressed.resize(Geometry::GetDecompressedSize(geom));
+			Geometry::Decompress(geom, decompressed.data());
+			geom = geometry_t(string_t(const_char_ptr_cast(decompressed.data()), decompressed.size()));
+		}
 
 		const auto props = geom.GetProperties();
 
@@ -246,6 +256,22 @@ public:
 		return ReadGeometry(cursor, args...);
 	}
 
+	// Process a single part of a serialized geometry, e.g. one located with a GeometryPartReader
+	RESULT ProcessPart(const geometry_t &geom, const_data_ptr_t part_ptr, ARGS... args) {
+		const auto props = geom.GetProperties();
+		D_ASSERT(!props.IsCompressed());
+
+		has_z = props.HasZ();
+		has_m = props.HasM();
+		nesting_level = 0;
+		parent_type = GeometryType::POINT;
+
+		Cursor cursor(geom);
+		cursor.SetPtr(const_cast<data_ptr_t>(part_ptr));
+
+		return ReadGeometry(cursor, args...);
+	}
+
 private:
 	RESULT ReadGeometry(Cursor &cursor, ARGS... args) {
 		auto type = cursor.Peek<SerializedGeometryType>();
@@ -5,7 +5,15 @@ namespace spatial {
 
 namespace core {
 
-static constexpr const uint8_t GEOMETRY_VERSION = 0;
+// The newest serialization format version this library can read (and write)
+static constexpr const uint8_t GEOMETRY_VERSION = 1;
+
+// Collections with at least this many parts are serialized in the version 1 format, with a part index, when enabled by
+// the geometry_part_index setting. Older versions of the extension can only read version 0.
+static constexpr const uint32_t GEOMETRY_PART_INDEX_MIN_PARTS = 32;
+
+// Compressed geometries round their coordinates to at most this many decimal digits
+static constexpr const uint8_t GEOMETRY_MAX_COMPRESSION_PRECISION = 15;
 
 struct GeometryProperties {
 private:
@@ -15,7 +23,7 @@ private:
 	// Example of other useful properties:
 	// static constexpr const uint8_t EMPTY = 0x08;
 	// static constexpr const uint8_t GEODETIC = 0x10;
-	// static constexpr const uint8_t SOLID = 0x20;
+	static constexpr const uint8_t COMPRESSED = 0x20;
 	static constexpr const uint8_t VERSION_1 = 0x40;
 	static constexpr const uint8_t VERSION_0 = 0x80;
 	uint8_t flags = 0;
@@ -28,10 +36,9 @@ public:
 		SetM(has_m);
 	}
 
+	// Version 0 geometries have neither version bit set, version 1 geometries only have the VERSION_1 bit set.
 	inline void CheckVersion() const {
-		const auto v0 = (flags & VERSION_0);
-		const auto v1 = (flags & VERSION_1);
-		if ((v1 | v0) != GEOMETRY_VERSION) {
+		if ((flags & VERSION_0) != 0) {
 			throw NotImplementedException(
 			    "This geometry seems to be written with a newer version of the DuckDB spatial library that is not "
 			    "compatible with this version. Please upgrade your DuckDB installation.");
@@ -57,6 +64,27 @@ public:
 		flags = value ? (flags | BBOX) : (flags & ~BBOX);
 	}
 
+	inline uint8_t GetVersion() const {
+		return (flags & VERSION_1) != 0 ? 1 : 0;
+	}
+	inline void SetVersion(uint8_t version) {
+		D_ASSERT(version <= GEOMETRY_VERSION);
+		flags = version == 1 ? (flags | VERSION_1) : (flags & ~VERSION_1);
+	}
+	// Version 1 geometries store an index of the parts of the top level collection after the geometry data
+	inline bool HasPartIndex() const {
+		return GetVersion() == 1 && !IsCompressed();
+	}
+
+	// Compressed geometries store their coordinates as quantized, delta encoded varints. They are always marked as
+	// version 1 so that older versions of the library refuse to read them, but never have a part index.
+	inline bool IsCompressed() const {
+		return (flags & COMPRESSED) != 0;
+	}
+	inline void SetCompressed(bool value) {
+		flags = value ? (flags | COMPRESSED) : (flags & ~COMPRESSED);
+	}
+
 	uint32_t VertexSize() const {
 		return sizeof(double) * (2 + HasZ() + HasM());
 	}
@@ -120,6 +120,28 @@ public:
 			return true;
 		}
 
+		if (header_type == GeometryType::POINT && properties.IsCompressed()) {
+			cursor.Skip(4); // skip padding
+
+			// The first vertex is stored relative to zero, see Geometry::Compress
+			const auto precision = cursor.Read<uint8_t>();
+			cursor.ReadVarint(); // decompressed size
+			cursor.ReadVarint(); // type
+			if (cursor.ReadVarint() == 0) {
+				return false;
+			}
+			const auto scale = std::pow(10.0, precision);
+			const auto x_bits = cursor.ReadVarint();
+			const auto y_bits = cursor.ReadVarint();
+			const auto x = static_cast<double>(static_cast<int64_t>(x_bits >> 1) ^ -static_cast<int64_t>(x_bits & 1));
+			const auto y = static_cast<double>(static_cast<int64_t>(y_bits >> 1) ^ -static_cast<int64_t>(y_bits & 1));
+			bbox.min.x = x / scale;
+			bbox.min.y = y / scale;
+			bbox.max.x = bbox.min.x;
+			bbox.max.y = bbox.min.y;
+			return true;
+		}
+
 		if (header_type == GeometryType::POINT) {
 			cursor.Skip(4); // skip padding
 
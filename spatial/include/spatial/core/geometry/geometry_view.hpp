@@ -0,0 +1,295 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_type.hpp"
+#include "spatial/core/geometry/vertex.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------
+// GeometryView
+//------------------------------------------------------------------------
+// A read-only view over a serialized geometry, or over one of its parts.
+// Unlike Geometry::Deserialize, creating a view doesn't allocate or copy anything, the parts and vertices are read
+// from the blob as they are iterated. Dispatch on the type with GeometryView::Match, which takes the same tags as
+// Geometry::Match. Like the parts of a deserialized Polygon, the rings of a polygon view are LINESTRING views.
+// Compressed geometries have to be decompressed (with Geometry::Decompress) before they can be viewed.
+//------------------------------------------------------------------------
+class GeometryView {
+private:
+	GeometryType type = GeometryType::POINT;
+	GeometryProperties properties;
+	uint32_t count = 0;
+	// Points and linestrings: the vertex data, polygons: the ring counts, collections: the first part
+	const_data_ptr_t data = nullptr;
+	// The end of the blob, the parts are bounds checked against it
+	const_data_ptr_t blob_end = nullptr;
+
+	GeometryView(GeometryType type, GeometryProperties properties, uint32_t count, const_data_ptr_t data,
+	             const_data_ptr_t blob_end)
+	    : type(type), properties(properties), count(count), data(data), blob_end(blob_end) {
+	}
+
+	static void CheckBounds(const_data_ptr_t ptr, const_data_ptr_t blob_end) {
+		if (ptr > blob_end) {
+			throw SerializationException("Trying to read past end of buffer");
+		}
+	}
+
+	// Create a view of the serialized (part of a) geometry at ptr
+	static GeometryView Read(const_data_ptr_t ptr, GeometryProperties properties, const_data_ptr_t blob_end);
+
+	// Create a view of a polygon ring
+	GeometryView Ring(uint32_t index, const_data_ptr_t ring_data) const {
+		const auto ring_count = Load<uint32_t>(data + index * sizeof(uint32_t));
+		CheckBounds(ring_data + ring_count * properties.VertexSize(), blob_end);
+		return GeometryView(GeometryType::LINESTRING, properties, ring_count, ring_data, blob_end);
+	}
+
+	// The vertex data of the first ring of a polygon
+	const_data_ptr_t RingData() const {
+		return data + (count + count % 2) * sizeof(uint32_t);
+	}
+
+public:
+	GeometryView() = default;
+	explicit GeometryView(const geometry_t &blob);
+
+	GeometryType GetType() const {
+		return type;
+	}
+	const GeometryProperties &GetProperties() const {
+		return properties;
+	}
+	// The number of vertices, rings or parts, like Geometry::Count
+	uint32_t Count() const {
+		return count;
+	}
+	bool IsCollection() const {
+		return GeometryTypes::IsCollection(type);
+	}
+	bool IsMultiPart() const {
+		return GeometryTypes::IsMultiPart(type);
+	}
+	bool IsSinglePart() const {
+		return GeometryTypes::IsSinglePart(type);
+	}
+
+	// The vertex data of a point or linestring
+	const_data_ptr_t GetVertexData() const {
+		D_ASSERT(IsSinglePart());
+		return data;
+	}
+	VertexXY GetVertex(uint32_t index) const {
+		D_ASSERT(IsSinglePart());
+		D_ASSERT(index < count);
+		return Load<VertexXY>(data + index * properties.VertexSize());
+	}
+
+	// The end of the serialized data of this geometry. This is constant time for everything but collections.
+	const_data_ptr_t GetEnd() const;
+
+	//------------------------------------------------------------------------
+	// Parts
+	//------------------------------------------------------------------------
+	class PartIterator {
+		friend class GeometryView;
+
+	private:
+		const GeometryView &parent;
+		uint32_t index;
+		GeometryView current;
+
+		PartIterator(const GeometryView &parent, uint32_t index) : parent(parent), index(index) {
+			if (index < parent.count) {
+				current = parent.type == GeometryType::POLYGON
+				              ? parent.Ring(0, parent.RingData())
+				              : GeometryView::Read(parent.data, parent.properties, parent.blob_end);
+			}
+		}
+
+	public:
+		const GeometryView &operator*() const {
+			return current;
+		}
+		const GeometryView *operator->() const {
+			return &current;
+		}
+		PartIterator &operator++() {
+			const auto next_ptr = current.GetEnd();
+			index++;
+			if (index < parent.count) {
+				current = parent.type == GeometryType::POLYGON
+				              ? parent.Ring(index, next_ptr)
+				              : GeometryView::Read(next_ptr, parent.properties, parent.blob_end);
+			}
+			return *this;
+		}
+		bool operator!=(const PartIterator &other) const {
+			return index != other.index;
+		}
+	};
+
+	// Iterate over the rings of a polygon or the parts of a collection
+	PartIterator begin() const {
+		D_ASSERT(IsMultiPart());
+		return PartIterator(*this, 0);
+	}
+	PartIterator end() const {
+		D_ASSERT(IsMultiPart());
+		return PartIterator(*this, count);
+	}
+
+	//------------------------------------------------------------------------
+	// Dispatch
+	//------------------------------------------------------------------------
+	template <class T, class... ARGS>
+	static auto Match(const GeometryView &view, ARGS &&...args)
+	    -> decltype(T::Case(std::declval<Geometry::Tags::Point>(), std::declval<const GeometryView &>(),
+	                        std::declval<ARGS>()...)) {
+		switch (view.type) {
+		case GeometryType::POINT:
+			return T::Case(Geometry::Tags::Point {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::LINESTRING:
+			return T::Case(Geometry::Tags::LineString {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::POLYGON:
+			return T::Case(Geometry::Tags::Polygon {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::MULTIPOINT:
+			return T::Case(Geometry::Tags::MultiPoint {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::MULTILINESTRING:
+			return T::Case(Geometry::Tags::MultiLineString {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::MULTIPOLYGON:
+			return T::Case(Geometry::Tags::MultiPolygon {}, view, std::forward<ARGS>(args)...);
+		case GeometryType::GEOMETRYCOLLECTION:
+			return T::Case(Geometry::Tags::GeometryCollection {}, view, std::forward<ARGS>(args)...);
+		default:
+			throw NotImplementedException("GeometryView::Match");
+		}
+	}
+
+	//------------------------------------------------------------------------
+	// Properties, same semantics as the Geometry functions with the same name
+	//------------------------------------------------------------------------
+	static bool IsEmpty(const GeometryView &view);
+	static uint32_t GetDimension(const GeometryView &view, bool ignore_empty);
+};
+
+//------------------------------------------------------------------------
+// Inlined Functions
+//------------------------------------------------------------------------
+inline GeometryView::GeometryView(const geometry_t &blob) {
+	const auto props = blob.GetProperties();
+	D_ASSERT(!props.IsCompressed());
+	const string_t str = blob;
+	const auto blob_start = const_data_ptr_cast(str.GetData());
+	const auto end_ptr = blob_start + str.GetSize();
+
+	// Skip the header, padding and bounding box
+	const auto dims = 2 + (props.HasZ() ? 1 : 0) + (props.HasM() ? 1 : 0);
+	const auto bbox_size = props.HasBBox() ? dims * 2 * sizeof(float) : 0;
+	const auto ptr = blob_start + sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) +
+	                 sizeof(uint32_t) + bbox_size;
+
+	*this = Read(ptr, props, end_ptr);
+}
+
+inline GeometryView GeometryView::Read(const_data_ptr_t ptr, GeometryProperties properties,
+                                       const_data_ptr_t blob_end) {
+	CheckBounds(ptr + 2 * sizeof(uint32_t), blob_end);
+	const auto serialized_type = Load<SerializedGeometryType>(ptr);
+	const auto part_count = Load<uint32_t>(ptr + sizeof(uint32_t));
+	const auto part_data = ptr + 2 * sizeof(uint32_t);
+
+	switch (serialized_type) {
+	case SerializedGeometryType::POINT:
+		CheckBounds(part_data + part_count * properties.VertexSize(), blob_end);
+		return GeometryView(GeometryType::POINT, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::LINESTRING:
+		CheckBounds(part_data + part_count * properties.VertexSize(), blob_end);
+		return GeometryView(GeometryType::LINESTRING, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::POLYGON:
+		CheckBounds(part_data + (part_count + part_count % 2) * sizeof(uint32_t), blob_end);
+		return GeometryView(GeometryType::POLYGON, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::MULTIPOINT:
+		return GeometryView(GeometryType::MULTIPOINT, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::MULTILINESTRING:
+		return GeometryView(GeometryType::MULTILINESTRING, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::MULTIPOLYGON:
+		return GeometryView(GeometryType::MULTIPOLYGON, properties, part_count, part_data, blob_end);
+	case SerializedGeometryType::GEOMETRYCOLLECTION:
+		return GeometryView(GeometryType::GEOMETRYCOLLECTION, properties, part_count, part_data, blob_end);
+	default:
+		throw SerializationException("Unknown geometry type (%ud)", static_cast<uint32_t>(serialized_type));
+	}
+}
+
+inline const_data_ptr_t GeometryView::GetEnd() const {
+	switch (type) {
+	case GeometryType::POINT:
+	case GeometryType::LINESTRING:
+		return data + count * properties.VertexSize();
+	case GeometryType::POLYGON: {
+		uint32_t vertex_count = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			vertex_count += Load<uint32_t>(data + i * sizeof(uint32_t));
+		}
+		return RingData() + vertex_count * properties.VertexSize();
+	}
+	default: {
+		auto end_ptr = data;
+		for (auto it = begin(); it != end(); ++it) {
+			end_ptr = it->GetEnd();
+		}
+		return end_ptr;
+	}
+	}
+}
+
+inline bool GeometryView::IsEmpty(const GeometryView &view) {
+	struct op {
+		static bool Case(Geometry::Tags::SinglePartGeometry, const GeometryView &view) {
+			return view.Count() == 0;
+		}
+		static bool Case(Geometry::Tags::MultiPartGeometry, const GeometryView &view) {
+			for (const auto &part : view) {
+				if (!GeometryView::Match<op>(part)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+	return GeometryView::Match<op>(view);
+}
+
+inline uint32_t GeometryView::GetDimension(const GeometryView &view, bool ignore_empty) {
+	if (ignore_empty && GeometryView::IsEmpty(view)) {
+		return 0;
+	}
+	switch (view.GetType()) {
+	case GeometryType::POINT:
+	case GeometryType::MULTIPOINT:
+		return 0;
+	case GeometryType::LINESTRING:
+	case GeometryType::MULTILINESTRING:
+		return 1;
+	case GeometryType::POLYGON:
+	case GeometryType::MULTIPOLYGON:
+		return 2;
+	case GeometryType::GEOMETRYCOLLECTION: {
+		uint32_t max_dimension = 0;
+		for (const auto &part : view) {
+			max_dimension = std::max(max_dimension, GeometryView::GetDimension(part, ignore_empty));
+		}
+		return max_dimension;
+	}
+	default:
+		throw NotImplementedException("GeometryView::GetDimension");
+	}
+}
+
+} // namespace core
+
+} // namespace spatial
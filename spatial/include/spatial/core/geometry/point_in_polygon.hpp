@@ -0,0 +1,33 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_type.hpp"
+
+namespace spatial {
+
+namespace core {
+
+enum class PointLocation : uint8_t { EXTERIOR, BOUNDARY, INTERIOR, UNKNOWN };
+
+// Exact point-in-polygon predicates evaluated directly on serialized geometries, without deserializing them.
+// These follow the semantics of the GEOS predicates, but give up (return UNKNOWN/false) whenever the arguments are
+// not a point and a (multi)polygon, or when the location of the point cannot be decided robustly in double precision,
+// in which case the caller should fall back to GEOS.
+struct PointInPolygon {
+	//! Locate a POINT relative to a POLYGON or MULTIPOLYGON
+	static PointLocation Locate(const geometry_t &point, const geometry_t &polygon);
+
+	//! ST_Contains(polygon, point): the point is in the interior of the polygon
+	static bool TryContains(const geometry_t &polygon, const geometry_t &point, bool &result);
+	//! ST_Within(point, polygon)
+	static bool TryWithin(const geometry_t &point, const geometry_t &polygon, bool &result);
+	//! ST_Covers(polygon, point): the point is in the interior or on the boundary of the polygon
+	static bool TryCovers(const geometry_t &polygon, const geometry_t &point, bool &result);
+	//! ST_CoveredBy(point, polygon)
+	static bool TryCoveredBy(const geometry_t &point, const geometry_t &polygon, bool &result);
+	//! ST_Intersects(left, right), with the point on either side
+	static bool TryIntersects(const geometry_t &left, const geometry_t &right, bool &result);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -12,18 +12,28 @@ struct InsertResult;
 struct DeleteResult;
 
 struct RTreeConfig {
+	//! The maximum and minimum number of children of a branch node
 	idx_t max_node_capacity = 128;
 	idx_t min_node_capacity = 50;
 
-	// TODO: Allow setting leaf capacity separately
-	// idx_t max_leaf_capacity;
-	// idx_t min_leaf_capacity;
+	//! The maximum and minimum number of row ids in a leaf node
+	idx_t max_leaf_capacity = 128;
+	idx_t min_leaf_capacity = 50;
 
 	idx_t GetNodeByteSize() const {
 		return sizeof(RTreeNode) + (sizeof(RTreeEntry) * max_node_capacity);
 	}
 	idx_t GetLeafByteSize() const {
-		return sizeof(RTreeNode) + (sizeof(RTreeEntry) * max_node_capacity);
+		return sizeof(RTreeNode) + (sizeof(RTreeEntry) * max_leaf_capacity);
+	}
+
+	idx_t GetMaxCapacity(RTreeNodeType type) const {
+		D_ASSERT(type == RTreeNodeType::BRANCH_PAGE || type == RTreeNodeType::LEAF_PAGE);
+		return type == RTreeNodeType::LEAF_PAGE ? max_leaf_capacity : max_node_capacity;
+	}
+	idx_t GetMinCapacity(RTreeNodeType type) const {
+		D_ASSERT(type == RTreeNodeType::BRANCH_PAGE || type == RTreeNodeType::LEAF_PAGE);
+		return type == RTreeNodeType::LEAF_PAGE ? min_leaf_capacity : min_node_capacity;
 	}
 };
 
@@ -40,6 +50,23 @@ public:
 		RootInsert(root, entry);
 	}
 
+	//! Insert a batch of entries. The entries are sorted along a hilbert curve first, so that consecutive inserts
+	//! descend into the same part of the tree.
+	void Insert(vector<RTreeEntry> &entries);
+
+	//! Bulk load an empty tree with a set of row entries, using sort-tile-recursive (STR) packing
+	void BulkLoad(vector<RTreeEntry> &entries);
+
+	//! The number of entries per vertical slice when STR packing a layer of the given size
+	static idx_t GetSliceSize(idx_t layer_size, idx_t capacity);
+	//! Sort an STR slice by the y-coordinate of the entry centers
+	static void SortSlice(RTreeEntry *begin, RTreeEntry *end);
+	//! Pack a sorted STR slice into nodes, and append an entry for every node to the result
+	void PackSlice(RTreeNodeType node_type, const RTreeEntry *begin, const RTreeEntry *end,
+	               vector<RTreeEntry> &result) const;
+	//! Pack the layers above the given layer of nodes, until only the root remains, and set the root
+	void PackBranches(vector<RTreeEntry> &layer);
+
 	void Delete(const RTreeEntry &entry) {
 		RootDelete(root, entry);
 	}
@@ -99,7 +126,8 @@ private:
 	RTreeEntry &PickSubtree(RTreeNode &node, const RTreeEntry &new_entry) const;
 
 	RTreeEntry SplitNode(RTreeEntry &entry) const;
-	void RebalanceSplitNodes(RTreeNode &src, RTreeNode &dst, bool split_axis, PointXY<float> &split_point) const;
+	void RebalanceSplitNodes(RTreeNode &src, RTreeNode &dst, idx_t min_capacity, bool split_axis,
+	                         PointXY<float> &split_point) const;
 
 	void RootDelete(RTreeEntry &root, const RTreeEntry &target);
 	DeleteResult NodeDelete(RTreeEntry &entry, const RTreeEntry &target, vector<RTreeEntry> &orphans);
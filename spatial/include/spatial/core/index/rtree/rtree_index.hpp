@@ -1,5 +1,6 @@
 #pragma once
 
+#include "duckdb/common/set.hpp"
 #include "duckdb/execution/index/bound_index.hpp"
 #include "duckdb/execution/index/fixed_size_allocator.hpp"
 #include "duckdb/execution/index/index_pointer.hpp"
@@ -25,8 +26,36 @@ public:
 
 	unique_ptr<RTree> tree;
 
+	//! The rows with an EMPTY geometry. They have no bounds and are not part of the tree, but they are at distance 0
+	//! of everything, so the KNN scan needs to know about them. There are usually few of them.
+	set<row_t> empty_rows;
+
+	//! The FixedSizeAllocators lazily pin their buffers when a node is first dereferenced, which is not safe to do
+	//! from multiple threads at once, or while the index is modified. Every operator that traverses the index holds
+	//! this lock while doing so. It is the same lock that appends and deletes hold (see InitializeLock).
+	mutex &GetNodeLock() const {
+		return const_cast<mutex &>(lock);
+	}
+
 	unique_ptr<IndexScanState> InitializeScan(const Box2D<float> &query) const;
+	//! Initialize a scan over a single subtree of the index, as returned by PartitionScan
+	unique_ptr<IndexScanState> InitializeScan(const Box2D<float> &query, const RTreeEntry &subtree) const;
 	idx_t Scan(IndexScanState &state, Vector &result) const;
+	//! Scan at most 'capacity' row ids into the given buffer
+	idx_t Scan(IndexScanState &state, row_t *row_ids, idx_t capacity) const;
+
+	//! Split the part of the tree that intersects the query into (at least) 'target_count' disjoint subtrees,
+	//! unless the tree is too shallow. The subtrees are returned in the same order a full scan would visit them.
+	void PartitionScan(const Box2D<float> &query, idx_t target_count, vector<RTreeEntry> &result) const;
+
+	//! Initialize a best-first search for the rows nearest to the query point, see KNNScan
+	unique_ptr<IndexScanState> InitializeKNNScan(const PointXY<double> &query) const;
+	//! Emit the next rows of a best-first search, in order of the (squared) minimum distance from the query point to
+	//! their bounds, as long as that distance is at most 'max_distance'. The (squared) maximum distance to the bounds
+	//! of each row is written to 'row_max_distances'. Returns 0 once no rows within 'max_distance' are left.
+	//! The maximum distance may only shrink between calls, entries beyond it are pruned for good.
+	idx_t KNNScan(IndexScanState &state, double max_distance, row_t *row_ids, double *row_max_distances,
+	              idx_t capacity) const;
 
 public:
 	//! Called when data is appended to the index. The lock obtained from InitializeLock must be held
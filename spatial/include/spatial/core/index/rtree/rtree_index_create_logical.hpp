@@ -3,6 +3,9 @@
 #include "duckdb/parser/parsed_data/create_index_info.hpp"
 
 #include "spatial/common.hpp"
+#include "spatial/core/index/rtree/rtree_index_join_logical.hpp"
+#include "spatial/core/join/spatial_join_logical.hpp"
+
 namespace spatial {
 
 namespace core {
@@ -56,7 +59,12 @@ public:
 	}
 	unique_ptr<LogicalExtensionOperator> Deserialize(Deserializer &reader) override {
 		const auto operator_type = reader.ReadPropertyWithDefault<string>(300, "operator_type");
-		// We only have one extension operator type right now
+		if (operator_type == "logical_rtree_index_join") {
+			return LogicalRTreeIndexJoin::Deserialize(reader);
+		}
+		if (operator_type == "logical_spatial_join") {
+			return LogicalSpatialJoin::Deserialize(reader);
+		}
 		if (operator_type != "logical_rtree_create_index") {
 			throw SerializationException("This version of the spatial extension does not support operator type '%s!", operator_type);
 		}
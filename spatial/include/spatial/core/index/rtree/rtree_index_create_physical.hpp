@@ -41,7 +41,9 @@ public:
 public:
 	//! Sink interface, global sink state
 	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
 	SinkResultType Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const override;
+	SinkCombineResultType Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const override;
 	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
 	                          OperatorSinkFinalizeInput &input) const override;
 
@@ -49,8 +51,11 @@ public:
 		return true;
 	}
 	bool ParallelSink() const override {
-		// Not parallel, the sink order is important
-		return false;
+		return true;
+	}
+	bool RequiresBatchIndex() const override {
+		// The input is sorted, the batch index lets us restore the order after sinking in parallel
+		return true;
 	}
 };
 
@@ -0,0 +1,71 @@
+#pragma once
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+class RTreeIndex;
+
+// An index nested loop join that probes the RTree index of a table with the bounding box of every row of its child.
+// This is created by the optimizer from an inner join on a spatial predicate where one side is a plain scan of a
+// table with an RTree index over the predicate argument.
+//
+// expressions[0] = the join predicate
+// expressions[1] = the predicate argument of the probe side
+class LogicalRTreeIndexJoin final : public LogicalExtensionOperator {
+public:
+	//! The indexed (inner) table
+	TableCatalogEntry &table;
+
+	//! The index to probe
+	RTreeIndex &index;
+
+	//! The table index of the inner table scan this join replaced
+	idx_t inner_table_index;
+
+	//! The columns fetched from the inner table
+	vector<column_t> inner_column_ids;
+
+	//! The types of the columns fetched from the inner table
+	vector<LogicalType> inner_types;
+
+	//! The inner columns (indexes into inner_column_ids) that are emitted by the join
+	vector<idx_t> inner_projection_ids;
+
+	//! The probe columns (indexes into the child's columns) that are emitted by the join
+	vector<idx_t> probe_projection_ids;
+
+	//! Whether the inner table was on the left side of the original join.
+	//! If so, the inner columns are emitted before the probe columns.
+	bool inner_is_left;
+
+public:
+	LogicalRTreeIndexJoin(TableCatalogEntry &table_p, RTreeIndex &index_p, idx_t inner_table_index_p,
+	                      vector<column_t> inner_column_ids_p, vector<LogicalType> inner_types_p,
+	                      vector<idx_t> inner_projection_ids_p, vector<idx_t> probe_projection_ids_p,
+	                      bool inner_is_left_p);
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	void ResolveTypes() override;
+	void ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) override;
+
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+
+	void Serialize(Serializer &writer) const override;
+	static unique_ptr<LogicalExtensionOperator> Deserialize(Deserializer &reader);
+
+	string GetExtensionName() const override {
+		return "duckdb_spatial";
+	}
+
+private:
+	//! The bindings the join predicate is resolved against: all probe columns followed by all inner columns
+	vector<ColumnBinding> GetJoinBindings();
+};
+
+} // namespace core
+
+} // namespace spatial
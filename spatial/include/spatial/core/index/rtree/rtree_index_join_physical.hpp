@@ -0,0 +1,60 @@
+#pragma once
+#include "duckdb/execution/physical_operator.hpp"
+#include "spatial/common.hpp"
+
+namespace duckdb {
+class DuckTableEntry;
+}
+
+namespace spatial {
+
+namespace core {
+
+class RTreeIndex;
+
+// Index nested loop join: for every input row, probe the RTree index with the bounding box of the row's geometry,
+// fetch the candidate rows from the indexed table and evaluate the exact join predicate on the pairs.
+class PhysicalRTreeIndexJoin final : public PhysicalOperator {
+public:
+	static constexpr auto TYPE = PhysicalOperatorType::EXTENSION;
+
+public:
+	PhysicalRTreeIndexJoin(LogicalOperator &op, DuckTableEntry &table, RTreeIndex &index,
+	                       const vector<column_t> &inner_column_ids, const vector<LogicalType> &inner_types,
+	                       vector<idx_t> output_columns, unique_ptr<Expression> predicate,
+	                       unique_ptr<Expression> probe_key, idx_t estimated_cardinality);
+
+	//! The indexed table
+	DuckTableEntry &table;
+	//! The index to probe
+	RTreeIndex &index;
+	//! The storage ids of the inner columns to fetch, followed by the row id column
+	vector<storage_t> fetch_ids;
+	//! The types of the fetched columns
+	vector<LogicalType> fetch_types;
+	//! The types of the probe columns followed by the inner columns, the predicate is evaluated on these
+	vector<LogicalType> join_types;
+	//! For every output column, the column of the joined chunk to emit
+	vector<idx_t> output_columns;
+	//! The exact join predicate
+	unique_ptr<Expression> predicate;
+	//! The geometry of the probe side
+	unique_ptr<Expression> probe_key;
+
+public:
+	string GetName() const override {
+		return "RTREE_INDEX_JOIN";
+	}
+
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+	OperatorResultType Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                           GlobalOperatorState &gstate, OperatorState &state) const override;
+
+	bool ParallelOperator() const override {
+		return true;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -35,6 +35,44 @@ public:
 };
 
 struct RTreeIndexScanFunction {
+	//! Setting controlling how many row ids are sorted by storage order before fetching them
+	static constexpr auto SORT_BATCH_SIZE_SETTING = "rtree_index_scan_sort_batch_size";
+	static constexpr idx_t DEFAULT_SORT_BATCH_SIZE = STANDARD_VECTOR_SIZE * 64;
+
+	static TableFunction GetFunction();
+};
+
+// This is created by the optimizer rule for ORDER BY ST_Distance(geom, point) LIMIT k
+struct RTreeIndexKNNScanBindData final : public TableFunctionData {
+	explicit RTreeIndexKNNScanBindData(DuckTableEntry &table, Index &index, column_t geom_column,
+	                                   const PointXY<double> &point, idx_t k)
+	    : table(table), index(index), geom_column(geom_column), point(point), k(k) {
+	}
+
+	//! The table to scan
+	DuckTableEntry &table;
+
+	//! The index to use
+	Index &index;
+
+	//! The (logical) index of the indexed geometry column
+	column_t geom_column;
+
+	//! The point to find the nearest rows to
+	PointXY<double> point;
+
+	//! The number of nearest rows to find
+	idx_t k;
+
+public:
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<RTreeIndexKNNScanBindData>();
+		return &other.table == &table && &other.index == &index && other.geom_column == geom_column &&
+		       other.point.x == point.x && other.point.y == point.y && other.k == k;
+	}
+};
+
+struct RTreeIndexKNNScanFunction {
 	static TableFunction GetFunction();
 };
 
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "spatial/core/index/rtree/rtree_node.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Intersection kernel used when scanning the RTree. Entries are stored interleaved (pointer + bounds) in the node
+// pages, so the kernel loads the bounds of four entries at a time and transposes them in registers into four
+// min_x/min_y/max_x/max_y lanes, which are then compared against the query at once.
+//
+// SSE2 (always available on x86-64) and NEON (always available on aarch64) are used when available, otherwise
+// (or when SPATIAL_RTREE_SCALAR_INTERSECT is defined) we fall back to the scalar implementation.
+struct RTreeIntersect {
+	//! The maximum number of entries that can be tested in a single call
+	static constexpr idx_t MAX_BLOCK_SIZE = 64;
+
+	//! Returns a mask with the i-th bit set if the bounds of the i-th entry intersect the query.
+	//! 'count' must be at most MAX_BLOCK_SIZE
+	static uint64_t Mask(const RTreeEntry *entries, idx_t count, const RTreeBounds &query);
+
+	//! The scalar implementation, always available
+	static uint64_t MaskScalar(const RTreeEntry *entries, idx_t count, const RTreeBounds &query);
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -9,8 +9,10 @@ namespace core {
 struct RTreeModule {
 	static void RegisterIndex(DatabaseInstance &db);
 	static void RegisterIndexScan(DatabaseInstance &db);
+	static void RegisterIndexKNNScan(DatabaseInstance &db);
 	static void RegisterIndexPlanScan(DatabaseInstance &db);
 	static void RegisterIndexPlanCreate(DatabaseInstance &db);
+	static void RegisterIndexPlanJoin(DatabaseInstance &db);
 	static void RegisterIndexPragmas(DatabaseInstance &db);
 };
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "spatial/core/index/rtree/rtree.hpp"
+#include "spatial/core/index/rtree/rtree_intersect.hpp"
+
+#include "duckdb/common/bit_utils.hpp"
 
 namespace spatial {
 
@@ -11,13 +14,23 @@ public:
 	void Init(const RTreeEntry &root);
 	template <class FUNC>
 	void Scan(const RTree &tree, FUNC &&handler);
+	//! Scan the row ids whose bounds intersect the query. The bounds of the entries are tested one block at a time
+	//! with the vectorized intersection kernel. The handler is called for every matching row id entry, and returns
+	//! true to yield.
+	template <class FUNC>
+	void ScanIntersecting(const RTree &tree, const RTreeBounds &query, FUNC &&handler);
 	void Reset();
 
 private:
 	struct NodeScanState {
 		RTreePointer pointer;
 		idx_t entry_idx;
-		explicit NodeScanState(const RTreePointer &pointer_p) : pointer(pointer_p), entry_idx(0) {
+		//! The entries of the current block that intersect the query and have not been visited yet
+		uint64_t block_mask;
+		//! The index of the first entry of the current block
+		idx_t block_offset;
+		explicit NodeScanState(const RTreePointer &pointer_p)
+		    : pointer(pointer_p), entry_idx(0), block_mask(0), block_offset(0) {
 		}
 	};
 	vector<NodeScanState> stack;
@@ -84,6 +97,46 @@ inline void RTreeScanner::Scan(const RTree &tree, FUNC &&handler) {
 	}
 }
 
+template <class FUNC>
+inline void RTreeScanner::ScanIntersecting(const RTree &tree, const RTreeBounds &query, FUNC &&handler) {
+	// Depth-first scan of all intersecting nodes in the RTree with an explicit stack
+	while (!stack.empty()) {
+		auto &frame = stack.back();
+		const auto &node = tree.Ref(frame.pointer);
+
+		if (frame.block_mask == 0) {
+			if (frame.entry_idx >= node.GetCount()) {
+				// We've exhausted the node, pop it from the stack
+				stack.pop_back();
+				level--;
+				continue;
+			}
+			// Test the next block of entries
+			const auto block_size = MinValue<idx_t>(RTreeIntersect::MAX_BLOCK_SIZE, node.GetCount() - frame.entry_idx);
+			frame.block_offset = frame.entry_idx;
+			frame.block_mask = RTreeIntersect::Mask(node.begin() + frame.entry_idx, block_size, query);
+			frame.entry_idx += block_size;
+			continue;
+		}
+
+		// Pop the next intersecting entry from the mask
+		const auto entry_idx = frame.block_offset + CountZeros<uint64_t>::Trailing(frame.block_mask);
+		frame.block_mask &= frame.block_mask - 1;
+		auto &entry = node[entry_idx];
+
+		if (frame.pointer.IsLeafPage()) {
+			if (handler(entry)) {
+				// Yield!
+				return;
+			}
+		} else {
+			D_ASSERT(frame.pointer.IsBranchPage());
+			level++;
+			stack.emplace_back(entry.pointer);
+		}
+	}
+}
+
 } // namespace core
 
 } // namespace spatial
\ No newline at end of file
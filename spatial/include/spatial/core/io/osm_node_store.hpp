@@ -0,0 +1,63 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/util/managed_collection.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// The location of a node, in the fixed point precision used by OSM itself (1e-7 degrees)
+struct OsmNodeLocation {
+	int64_t id;
+	int32_t lat;
+	int32_t lon;
+};
+
+// A sorted id -> location array, used to resolve the node refs of ways when ST_ReadOSM builds geometries.
+// The locations are stored in buffer managed blocks, so that they spill to disk when they don't fit in memory.
+// Only the first id of each block is kept in memory, to find the block to pin for a lookup.
+class OsmNodeStore {
+public:
+	explicit OsmNodeStore(BufferManager &manager);
+
+	// Nodes have to be appended in ascending id order
+	void Append(int64_t id, int32_t lat, int32_t lon);
+
+	// Unpin the last block, no more nodes can be appended after this
+	void Finalize();
+
+	// Move the nodes of another finalized store to the end of this one. The nodes of the other store have to come
+	// after the nodes of this one, e.g. because they were read from a later part of the file.
+	void Combine(OsmNodeStore &other);
+
+	idx_t Count() const {
+		return locations.Count();
+	}
+
+	// Looks up node locations, keeping the last block pinned. The refs of a way are usually close to each other,
+	// so most lookups don't need to pin a new block. Each thread should use its own reader.
+	class Reader {
+	public:
+		explicit Reader(const OsmNodeStore &store) : store(store) {
+		}
+
+		// Returns false if the node is not in the store, e.g. because it was clipped from an extract
+		bool TryGet(int64_t id, double &lat, double &lon);
+
+	private:
+		const OsmNodeStore &store;
+		BufferHandle handle;
+		idx_t block_idx = DConstants::INVALID_INDEX;
+		idx_t block_count = 0;
+	};
+
+private:
+	ManagedCollection<OsmNodeLocation> locations;
+	ManagedCollectionAppendState append_state;
+	vector<int64_t> block_first_ids;
+	int64_t last_id;
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,63 @@
+#pragma once
+#include "spatial/common.hpp"
+#include "spatial/core/util/managed_collection.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// A single node ref of a way
+struct OsmWayRef {
+	int64_t way_id;
+	int64_t node_id;
+};
+
+// The node refs of a set of ways, sorted by way id. Used to resolve the member ways of multipolygon relations when
+// ST_ReadOSM builds geometries. Like the OsmNodeStore, the refs are stored in buffer managed blocks and only the first
+// way id of each block is kept in memory. The refs of a way can continue in the next block.
+class OsmWayStore {
+public:
+	explicit OsmWayStore(BufferManager &manager);
+
+	// Ways have to be appended in ascending id order
+	void Append(int64_t way_id, const int64_t *refs_begin, const int64_t *refs_end);
+
+	// Unpin the last block, no more ways can be appended after this
+	void Finalize();
+
+	// Move the ways of another finalized store to the end of this one. The ways of the other store have to come
+	// after the ways of this one.
+	void Combine(OsmWayStore &other);
+
+	idx_t Count() const {
+		return refs.Count();
+	}
+
+	// Looks up the refs of ways, keeping the last block pinned. Each thread should use its own reader.
+	class Reader {
+	public:
+		explicit Reader(const OsmWayStore &store) : store(store) {
+		}
+
+		// Returns false if the way is not in the store
+		bool TryGet(int64_t way_id, vector<int64_t> &result);
+
+	private:
+		void Pin(idx_t idx);
+
+		const OsmWayStore &store;
+		BufferHandle handle;
+		idx_t block_idx = DConstants::INVALID_INDEX;
+		idx_t block_count = 0;
+	};
+
+private:
+	ManagedCollection<OsmWayRef> refs;
+	ManagedCollectionAppendState append_state;
+	vector<int64_t> block_first_ids;
+	int64_t last_id;
+};
+
+} // namespace core
+
+} // namespace spatial
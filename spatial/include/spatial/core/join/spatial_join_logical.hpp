@@ -0,0 +1,52 @@
+#pragma once
+#include "duckdb/planner/operator/logical_extension_operator.hpp"
+
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// An inner join on a spatial predicate between two arbitrary inputs. The smaller input (the build side) is sorted
+// along a hilbert curve and packed into a temporary RTree, which is then probed with the bounding box of every row
+// of the other input (the probe side).
+//
+// children[0] = the probe side
+// children[1] = the build side
+//
+// expressions[0] = the join predicate
+// expressions[1] = the predicate argument of the probe side
+// expressions[2] = the predicate argument of the build side
+class LogicalSpatialJoin final : public LogicalExtensionOperator {
+public:
+	//! The probe columns (indexes into the probe side's columns) that are emitted by the join
+	vector<idx_t> probe_projection_ids;
+
+	//! The build columns (indexes into the build side's columns) that are emitted by the join
+	vector<idx_t> build_projection_ids;
+
+	//! Whether the build side was on the left side of the original join.
+	//! If so, the build columns are emitted before the probe columns.
+	bool build_is_left;
+
+public:
+	LogicalSpatialJoin(vector<idx_t> probe_projection_ids_p, vector<idx_t> build_projection_ids_p,
+	                   bool build_is_left_p);
+
+	vector<ColumnBinding> GetColumnBindings() override;
+	void ResolveTypes() override;
+	void ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) override;
+
+	unique_ptr<PhysicalOperator> CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) override;
+
+	void Serialize(Serializer &writer) const override;
+	static unique_ptr<LogicalExtensionOperator> Deserialize(Deserializer &reader);
+
+	string GetExtensionName() const override {
+		return "duckdb_spatial";
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
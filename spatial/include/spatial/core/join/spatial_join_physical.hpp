@@ -0,0 +1,79 @@
+#pragma once
+#include "duckdb/execution/operator/join/physical_join.hpp"
+#include "spatial/common.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Spatial join that materializes the build side (children[1]) and packs the bounding boxes of its rows into a
+// temporary RTree. Every probe row (children[0]) is then looked up in the tree, the candidate build rows are
+// gathered and the exact join predicate is evaluated on the pairs.
+//
+// The build side is expected to arrive sorted along a hilbert curve, so that rows that are close in space are also
+// close in the (buffer managed) build collection, and the packed tree needs no further sorting. It is sunk in
+// parallel, and the batch index restores the sorted order once all threads are done.
+class PhysicalSpatialJoin final : public PhysicalJoin {
+public:
+	static constexpr auto TYPE = PhysicalOperatorType::EXTENSION;
+
+public:
+	PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe, unique_ptr<PhysicalOperator> build,
+	                    vector<idx_t> output_columns, unique_ptr<Expression> predicate,
+	                    unique_ptr<Expression> probe_key, unique_ptr<Expression> build_key,
+	                    idx_t estimated_cardinality);
+
+	//! The types of the build side
+	vector<LogicalType> build_types;
+	//! The types of the probe columns followed by the build columns, the predicate is evaluated on these
+	vector<LogicalType> join_types;
+	//! For every output column, the column of the joined chunk to emit
+	vector<idx_t> output_columns;
+	//! The exact join predicate
+	unique_ptr<Expression> predicate;
+	//! The geometry of the probe side
+	unique_ptr<Expression> probe_key;
+	//! The geometry of the build side
+	unique_ptr<Expression> build_key;
+
+public:
+	string GetName() const override {
+		return "SPATIAL_JOIN";
+	}
+
+public:
+	//! Operator interface
+	unique_ptr<OperatorState> GetOperatorState(ExecutionContext &context) const override;
+
+	bool ParallelOperator() const override {
+		return true;
+	}
+
+protected:
+	OperatorResultType ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+	                                   GlobalOperatorState &gstate, OperatorState &state) const override;
+
+public:
+	//! Sink interface, builds the temporary RTree
+	unique_ptr<GlobalSinkState> GetGlobalSinkState(ClientContext &context) const override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) const override;
+	SinkResultType Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const override;
+	SinkCombineResultType Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const override;
+	SinkFinalizeType Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+	                          OperatorSinkFinalizeInput &input) const override;
+
+	bool IsSink() const override {
+		return true;
+	}
+	bool ParallelSink() const override {
+		return true;
+	}
+	bool RequiresBatchIndex() const override {
+		// The build side is sorted, the batch index lets us restore the order after sinking in parallel
+		return true;
+	}
+};
+
+} // namespace core
+
+} // namespace spatial
@@ -28,6 +28,14 @@ public:
 		return ptr;
 	}
 
+	data_ptr_t GetStart() {
+		return start;
+	}
+
+	data_ptr_t GetEnd() {
+		return end;
+	}
+
 	uint32_t Remaining() {
 		D_ASSERT(ptr <= end);
 		return end - ptr;
@@ -91,6 +99,38 @@ public:
 		return Load<T>(ptr);
 	}
 
+	// Read an unsigned LEB128 varint
+	uint64_t ReadVarint() {
+		uint64_t result = 0;
+		for (uint32_t shift = 0; shift < 64; shift += 7) {
+			const auto byte = Read<uint8_t>();
+			result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return result;
+			}
+		}
+		throw SerializationException("Varint is too long");
+	}
+
+	// Write an unsigned LEB128 varint
+	void WriteVarint(uint64_t value) {
+		while (value >= 0x80) {
+			Write<uint8_t>(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		Write<uint8_t>(static_cast<uint8_t>(value));
+	}
+
+	// The number of bytes WriteVarint writes for the value
+	static uint32_t VarintSize(uint64_t value) {
+		uint32_t size = 1;
+		while (value >= 0x80) {
+			value >>= 7;
+			size++;
+		}
+		return size;
+	}
+
 	template <class T>
 	void Skip() {
 		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
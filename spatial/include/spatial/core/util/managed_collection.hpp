@@ -50,15 +50,51 @@ public:
 
 	T Fetch(idx_t idx);
 
+	// Copy the elements starting at the given offset to the output buffer, without modifying the collection.
+	// Returns the number of elements written to the output buffer. Safe to call from multiple threads at once.
+	idx_t Read(idx_t offset, T *begin, T *end) const;
+
 	idx_t Count() const {
 		return size;
 	}
 
+	// The number of elements in each standard block. Element i lives in block i / BlockCapacity(), as long as the
+	// collection was not initialized with a smaller first block or combined with another collection.
+	idx_t BlockCapacity() const {
+		return block_capacity;
+	}
+
+	idx_t BlockCount() const {
+		return blocks.size();
+	}
+
+	// Pin a block, returning the number of elements written to it. Safe to call from multiple threads at once.
+	BufferHandle PinBlock(idx_t block_idx, idx_t &item_count) const {
+		auto block_handle = blocks[block_idx].handle;
+		item_count = blocks[block_idx].item_count;
+		return manager.Pin(block_handle);
+	}
+
 	void Clear() {
 		blocks.clear();
 		size = 0;
 	}
 
+	// Move the blocks of another collection to the end of this one, without copying the elements. Neither collection
+	// can be appended to afterwards. Empty blocks are dropped, so the blocks may hold fewer elements than their capacity.
+	void Combine(ManagedCollection<T> &other) {
+		if (size == 0) {
+			blocks.clear();
+		}
+		for (auto &block : other.blocks) {
+			if (block.item_count != 0) {
+				blocks.push_back(std::move(block));
+			}
+		}
+		size += other.size;
+		other.Clear();
+	}
+
 private:
 	BufferManager &manager;
 	vector<ManagedCollectionBlock> blocks;
@@ -217,6 +253,33 @@ T ManagedCollection<T>::Fetch(idx_t idx) {
 	return Load<T>(ptr);
 }
 
+template <class T>
+idx_t ManagedCollection<T>::Read(idx_t offset, T *begin, T *end) const {
+	auto pos = begin;
+	for (auto &block : blocks) {
+		if (pos == end) {
+			break;
+		}
+		if (offset >= block.item_count) {
+			// Skip this block entirely
+			offset -= block.item_count;
+			continue;
+		}
+
+		const auto to_copy = MinValue<idx_t>(block.item_count - offset, end - pos);
+		auto block_handle = block.handle;
+		auto handle = manager.Pin(block_handle);
+		auto ptr = handle.Ptr() + offset * sizeof(T);
+		for (idx_t i = 0; i < to_copy; i++) {
+			*pos = Load<T>(ptr);
+			++pos;
+			ptr += sizeof(T);
+		}
+		offset = 0;
+	}
+	return pos - begin;
+}
+
 } // namespace core
 
 } // namespace spatial
\ No newline at end of file
@@ -6,10 +6,53 @@ namespace spatial {
 
 namespace geos {
 
+//! A small per-thread LRU cache of prepared geometries, keyed by the serialized geometry.
+//! Joins on spatial predicates repeat the same (build side) geometry across many rows and chunks as flat vectors.
+//! Geometries are only prepared the second time they are seen, so streams of unique geometries never pay for it.
+//! The hit and miss counts of the caches are flushed into per-database statistics when the caches are destroyed.
+struct GEOSPreparedCacheStats;
+
+class GEOSPreparedCache {
+public:
+	static constexpr auto SIZE_SETTING = "geos_prepared_cache_size";
+	static constexpr idx_t DEFAULT_SIZE = 16;
+
+	GEOSPreparedCache(idx_t capacity, shared_ptr<GEOSPreparedCacheStats> stats);
+	~GEOSPreparedCache();
+
+	//! Returns the prepared geometry for the blob, or nullptr if the blob has not been seen recently
+	const GEOSPreparedGeometry *Get(GeosContextWrapper &ctx, const geometry_t &blob);
+
+	//! Register the cache size setting and the cache statistics function
+	static void Register(DatabaseInstance &db);
+
+public:
+	//! The number of lookups that returned a prepared geometry, and the number that did not
+	idx_t hits = 0;
+	idx_t misses = 0;
+
+private:
+	struct Entry {
+		hash_t hash = 0;
+		idx_t last_used = 0;
+		//! The serialized geometry, only copied once the geometry is seen again
+		string blob;
+		GeometryPtr geom;
+		unique_ptr<const GEOSPreparedGeometry, GeosDeleter<const GEOSPreparedGeometry>> prepared;
+	};
+
+	idx_t capacity;
+	shared_ptr<GEOSPreparedCacheStats> stats;
+	idx_t tick = 0;
+	vector<Entry> entries;
+};
+
 struct GEOSFunctionLocalState : FunctionLocalState {
 public:
 	GeosContextWrapper ctx;
 	ArenaAllocator arena;
+	//! Declared after the context, the prepared geometries must be destroyed before it
+	GEOSPreparedCache cache;
 
 public:
 	explicit GEOSFunctionLocalState(ClientContext &context);
@@ -22,4 +65,4 @@ public:
 
 } // namespace geos
 
-} // namespace spatial
\ No newline at end of file
+} // namespace spatial
@@ -10,7 +10,6 @@ public:
 	static void Register(DatabaseInstance &db) {
 		RegisterStBoundary(db);
 		RegisterStBuffer(db);
-		RegisterStCentroid(db);
 		RegisterStContains(db);
 		RegisterStContainsProperly(db);
 		RegisterStConvexHull(db);
@@ -47,7 +46,6 @@ public:
 private:
 	static void RegisterStBoundary(DatabaseInstance &db);
 	static void RegisterStBuffer(DatabaseInstance &db);
-	static void RegisterStCentroid(DatabaseInstance &db);
 	static void RegisterStContains(DatabaseInstance &db);
 	static void RegisterStContainsProperly(DatabaseInstance &db);
 	static void RegisterStConvexHull(DatabaseInstance &db);
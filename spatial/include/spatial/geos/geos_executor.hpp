@@ -2,6 +2,7 @@
 
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/common.hpp"
 #include "spatial/geos/geos_wrappers.hpp"
@@ -21,43 +22,110 @@ namespace geos {
 
 // Optimize binary predicate helper which use prepared geometry when one of the arguments is a constant
 // This is much more common than you would think, e.g. joins produce a lot of constant vectors.
+// Otherwise, geometries that repeat across rows are prepared through the per-thread GEOSPreparedCache.
+// Points tested against polygons skip GEOS entirely when a native predicate is provided.
+// Before anything is deserialized, the cached bounding boxes in the two headers are compared. Geometries whose bounding
+// boxes don't intersect (or that are empty) are disjoint, which decides every predicate without calling GEOS.
 typedef char (*GEOSBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSGeometry *left, const GEOSGeometry *right);
 typedef char (*GEOSPreparedBinaryPredicate)(GEOSContextHandle_t ctx, const GEOSPreparedGeometry *left,
                                             const GEOSGeometry *right);
 
+// Predicates that can be evaluated directly on the serialized geometries for some combinations of arguments
+// (e.g. a point and a polygon, see PointInPolygon). Returns false if GEOS has to be used instead.
+typedef bool (*NativeBinaryPredicate)(const geometry_t &left, const geometry_t &right, bool &result);
+
 struct GEOSExecutor {
+	// Decide the predicate from the cached bounding boxes if they (or an empty geometry) make the geometries disjoint.
+	// disjoint_result is the result of the predicate for disjoint geometries, i.e. true for ST_Disjoint only.
+	// The bounds of a constant side are only read once, has_bounds is false if it is empty.
+	static bool TryDecideFromBounds(bool has_bounds, const Box2D<double> &bounds, const geometry_t &other,
+	                                bool disjoint_result, bool &result) {
+		Box2D<double> other_bounds;
+		if (!has_bounds || !other.TryGetCachedBounds(other_bounds) || !bounds.Intersects(other_bounds)) {
+			result = disjoint_result;
+			return true;
+		}
+		return false;
+	}
+
+	static bool TryDecideFromBounds(const geometry_t &left, const geometry_t &right, bool disjoint_result,
+	                                bool &result) {
+		Box2D<double> left_bounds;
+		const auto has_left_bounds = left.TryGetCachedBounds(left_bounds);
+		return TryDecideFromBounds(has_left_bounds, left_bounds, right, disjoint_result, result);
+	}
+
+	// Whether it is worth preparing the constant side of a predicate
+	static bool ShouldPrepare(Vector &constant, Vector &other, NativeBinaryPredicate native) {
+		if (constant.GetVectorType() != VectorType::CONSTANT_VECTOR ||
+		    other.GetVectorType() == VectorType::CONSTANT_VECTOR || ConstantVector::IsNull(constant)) {
+			return false;
+		}
+		// A constant point is cheaper to test natively against each row
+		return !native || ConstantVector::GetData<geometry_t>(constant)[0].GetType() != GeometryType::POINT;
+	}
+
 	// Symmetric: left and right can be swapped
 	// So we prepare either if one is constant
 	static void ExecuteSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right, idx_t count,
 	                                           Vector &result, GEOSBinaryPredicate normal,
-	                                           GEOSPreparedBinaryPredicate prepared) {
+	                                           GEOSPreparedBinaryPredicate prepared,
+	                                           NativeBinaryPredicate native = nullptr, bool disjoint_result = false) {
 		auto &ctx = lstate.ctx.GetCtx();
 
-		if (left.GetVectorType() == VectorType::CONSTANT_VECTOR &&
-		    right.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(left)) {
+		if (ShouldPrepare(left, right, native)) {
 			auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
 			auto left_geom = lstate.ctx.Deserialize(left_blob);
 			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+			Box2D<double> left_bounds;
+			const auto has_left_bounds = left_blob.TryGetCachedBounds(left_bounds);
 
 			UnaryExecutor::Execute<geometry_t, bool>(right, result, count, [&](geometry_t &right_blob) {
+				bool bounds_result;
+				if (TryDecideFromBounds(has_left_bounds, left_bounds, right_blob, disjoint_result, bounds_result)) {
+					return bounds_result;
+				}
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
 				return ok == 1;
 			});
-		} else if (right.GetVectorType() == VectorType::CONSTANT_VECTOR &&
-		           left.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(right)) {
+		} else if (ShouldPrepare(right, left, native)) {
 			auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
 			auto right_geom = lstate.ctx.Deserialize(right_blob);
 			auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+			Box2D<double> right_bounds;
+			const auto has_right_bounds = right_blob.TryGetCachedBounds(right_bounds);
 
 			UnaryExecutor::Execute<geometry_t, bool>(left, result, count, [&](geometry_t &left_blob) {
+				bool bounds_result;
+				if (TryDecideFromBounds(has_right_bounds, right_bounds, left_blob, disjoint_result, bounds_result)) {
+					return bounds_result;
+				}
 				auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				auto ok = prepared(ctx, right_prepared.get(), left_geometry.get());
 				return ok == 1;
 			});
 		} else {
+			// Neither side is constant, but either side may repeat across rows (e.g. the build side of a join)
 			BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
 			    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+				    bool native_result;
+				    if (TryDecideFromBounds(left_blob, right_blob, disjoint_result, native_result)) {
+					    return native_result;
+				    }
+				    if (native && native(left_blob, right_blob, native_result)) {
+					    return native_result;
+				    }
+				    auto left_prepared = lstate.cache.Get(lstate.ctx, left_blob);
+				    if (left_prepared) {
+					    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+					    return prepared(ctx, left_prepared, right_geometry.get()) == 1;
+				    }
+				    auto right_prepared = lstate.cache.Get(lstate.ctx, right_blob);
+				    if (right_prepared) {
+					    auto left_geometry = lstate.ctx.Deserialize(left_blob);
+					    return prepared(ctx, right_prepared, left_geometry.get()) == 1;
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
@@ -67,27 +135,72 @@ struct GEOSExecutor {
 	}
 
 	// Non symmetric: left and right cannot be swapped
-	// So we only prepare left if left is constant
+	// So we only prepare right if there is a converse predicate, i.e. prepared(right, left) == predicate(left, right)
+	// (e.g. contains for within, covers for covered_by)
 	static void ExecuteNonSymmetricPreparedBinary(GEOSFunctionLocalState &lstate, Vector &left, Vector &right,
 	                                              idx_t count, Vector &result, GEOSBinaryPredicate normal,
-	                                              GEOSPreparedBinaryPredicate prepared) {
+	                                              GEOSPreparedBinaryPredicate prepared,
+	                                              NativeBinaryPredicate native = nullptr,
+	                                              GEOSPreparedBinaryPredicate converse = nullptr,
+	                                              bool disjoint_result = false) {
 		auto &ctx = lstate.ctx.GetCtx();
 
 		// Optimize: if one of the arguments is a constant, we can prepare it once and reuse it
-		if (left.GetVectorType() == VectorType::CONSTANT_VECTOR &&
-		    right.GetVectorType() != VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(left)) {
+		if (ShouldPrepare(left, right, native)) {
 			auto &left_blob = ConstantVector::GetData<geometry_t>(left)[0];
 			auto left_geom = lstate.ctx.Deserialize(left_blob);
 			auto left_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, left_geom.get()));
+			Box2D<double> left_bounds;
+			const auto has_left_bounds = left_blob.TryGetCachedBounds(left_bounds);
 
 			UnaryExecutor::Execute<geometry_t, bool>(right, result, count, [&](geometry_t &right_blob) {
+				bool bounds_result;
+				if (TryDecideFromBounds(has_left_bounds, left_bounds, right_blob, disjoint_result, bounds_result)) {
+					return bounds_result;
+				}
 				auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				auto ok = prepared(ctx, left_prepared.get(), right_geometry.get());
 				return ok == 1;
 			});
+		} else if (converse && ShouldPrepare(right, left, native)) {
+			auto &right_blob = ConstantVector::GetData<geometry_t>(right)[0];
+			auto right_geom = lstate.ctx.Deserialize(right_blob);
+			auto right_prepared = make_uniq_geos(ctx, GEOSPrepare_r(ctx, right_geom.get()));
+			Box2D<double> right_bounds;
+			const auto has_right_bounds = right_blob.TryGetCachedBounds(right_bounds);
+
+			UnaryExecutor::Execute<geometry_t, bool>(left, result, count, [&](geometry_t &left_blob) {
+				bool bounds_result;
+				if (TryDecideFromBounds(has_right_bounds, right_bounds, left_blob, disjoint_result, bounds_result)) {
+					return bounds_result;
+				}
+				auto left_geometry = lstate.ctx.Deserialize(left_blob);
+				auto ok = converse(ctx, right_prepared.get(), left_geometry.get());
+				return ok == 1;
+			});
 		} else {
+			// Neither side is constant, but either side may repeat across rows (e.g. the build side of a join)
 			BinaryExecutor::Execute<geometry_t, geometry_t, bool>(
 			    left, right, result, count, [&](geometry_t &left_blob, geometry_t &right_blob) {
+				    bool native_result;
+				    if (TryDecideFromBounds(left_blob, right_blob, disjoint_result, native_result)) {
+					    return native_result;
+				    }
+				    if (native && native(left_blob, right_blob, native_result)) {
+					    return native_result;
+				    }
+				    auto left_prepared = lstate.cache.Get(lstate.ctx, left_blob);
+				    if (left_prepared) {
+					    auto right_geometry = lstate.ctx.Deserialize(right_blob);
+					    return prepared(ctx, left_prepared, right_geometry.get()) == 1;
+				    }
+				    if (converse) {
+					    auto right_prepared = lstate.cache.Get(lstate.ctx, right_blob);
+					    if (right_prepared) {
+						    auto left_geometry = lstate.ctx.Deserialize(left_blob);
+						    return converse(ctx, right_prepared, left_geometry.get()) == 1;
+					    }
+				    }
 				    auto left_geometry = lstate.ctx.Deserialize(left_blob);
 				    auto right_geometry = lstate.ctx.Deserialize(right_blob);
 				    auto ok = normal(ctx, left_geometry.get(), right_geometry.get());
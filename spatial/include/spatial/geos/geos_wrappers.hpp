@@ -166,18 +166,18 @@ struct WKTWriter {
 	}
 };
 
+class GEOSDeserializer;
+
 struct GeosContextWrapper {
 private:
 	GEOSContextHandle_t ctx;
+	//! Reused by Deserialize, so that its scratch buffers are only allocated once per context
+	unique_ptr<GEOSDeserializer> deserializer;
 
 public:
-	GeosContextWrapper() {
-		ctx = GEOS_init_r();
-		GEOSContext_setErrorMessageHandler_r(ctx, ErrorHandler, (void *)nullptr);
-	}
-	~GeosContextWrapper() {
-		GEOS_finish_r(ctx);
-	}
+	// Defined out of line, GEOSDeserializer is incomplete here
+	GeosContextWrapper();
+	~GeosContextWrapper();
 
 	static void ErrorHandler(const char *message, void *userdata) {
 		throw InvalidInputException(message);
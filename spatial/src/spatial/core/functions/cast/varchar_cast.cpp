@@ -325,7 +325,7 @@ static bool TextToGeometryCast(Vector &source, Vector &result, idx_t count, Cast
 	    source, result, count, [&](string_t &wkt, ValidityMask &mask, idx_t idx) {
 		    try {
 			    auto geom = reader.Parse(wkt);
-			    return Geometry::Serialize(geom, result);
+			    return Geometry::Serialize(geom, result, lstate.write_part_index);
 		    } catch (InvalidInputException &e) {
 			    if (success) {
 				    success = false;
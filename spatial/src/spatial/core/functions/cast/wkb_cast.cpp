@@ -26,7 +26,7 @@ static bool WKBToGeometryCast(Vector &source, Vector &result, idx_t count, CastP
 	    source, result, count, [&](string_t input, ValidityMask &mask, idx_t idx) {
 		    try {
 			    auto geom = reader.Deserialize(input);
-			    return Geometry::Serialize(geom, result);
+			    return Geometry::Serialize(geom, result, lstate.write_part_index);
 		    } catch (SerializationException &e) {
 			    if (success) {
 				    success = false;
@@ -1,11 +1,22 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/common.hpp"
 
+#include "duckdb/main/config.hpp"
+
 namespace spatial {
 
 namespace core {
 
-GeometryFunctionLocalState::GeometryFunctionLocalState(ClientContext &context) : arena(BufferAllocator::Get(context)) {
+static bool GetWritePartIndex(ClientContext &context) {
+	Value enabled;
+	if (context.TryGetCurrentSetting(GeometryFunctionLocalState::PART_INDEX_SETTING, enabled)) {
+		return enabled.GetValue<bool>();
+	}
+	return false;
+}
+
+GeometryFunctionLocalState::GeometryFunctionLocalState(ClientContext &context)
+    : arena(BufferAllocator::Get(context)), write_part_index(GetWritePartIndex(context)) {
 }
 
 unique_ptr<FunctionLocalState>
@@ -29,6 +40,14 @@ GeometryFunctionLocalState &GeometryFunctionLocalState::ResetAndGet(ExpressionSt
 	return local_state;
 }
 
+void GeometryFunctionLocalState::Register(DatabaseInstance &db) {
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption(PART_INDEX_SETTING,
+	                          "Write GEOMETRY collections with many parts in the version 1 format, which includes an "
+	                          "index of the parts. Older versions of the spatial extension can not read this format.",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+}
+
 } // namespace core
 
 } // namespace spatial
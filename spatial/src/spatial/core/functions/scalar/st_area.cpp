@@ -5,7 +5,7 @@
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
 #include "spatial/core/types.hpp"
-#include "spatial/core/geometry/geometry_processor.hpp"
+#include "spatial/core/geometry/geometry_view.hpp"
 
 namespace spatial {
 
@@ -98,80 +98,71 @@ static void BoxAreaFunction(DataChunk &args, ExpressionState &state, Vector &res
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-class AreaProcessor final : GeometryProcessor<double> {
-	static double ProcessVertices(const VertexData &vertices) {
-		if (vertices.count < 3) {
-			return 0.0;
-		}
-
-		const auto count = vertices.count;
-		const auto x_data = vertices.data[0];
-		const auto y_data = vertices.data[1];
-		const auto x_stride = vertices.stride[0];
-		const auto y_stride = vertices.stride[1];
-
-		double signed_area = 0.0;
+static double RingArea(const GeometryView &ring) {
+	const auto count = ring.Count();
+	if (count < 3) {
+		return 0.0;
+	}
 
-		auto x0 = Load<double>(x_data);
+	const auto data = ring.GetVertexData();
+	const auto stride = ring.GetProperties().VertexSize();
 
-		for (uint32_t i = 1; i < count - 1; ++i) {
-			auto x1 = Load<double>(x_data + i * x_stride);
-			auto y1 = Load<double>(y_data + (i + 1) * y_stride);
-			auto y2 = Load<double>(y_data + (i - 1) * y_stride);
-			signed_area += (x1 - x0) * (y2 - y1);
-		}
+	double signed_area = 0.0;
 
-		signed_area *= 0.5;
+	auto x0 = Load<double>(data);
 
-		return std::abs(signed_area);
+	for (uint32_t i = 1; i < count - 1; ++i) {
+		auto x1 = Load<double>(data + i * stride);
+		auto y1 = Load<double>(data + (i + 1) * stride + sizeof(double));
+		auto y2 = Load<double>(data + (i - 1) * stride + sizeof(double));
+		signed_area += (x1 - x0) * (y2 - y1);
 	}
 
-	double ProcessPoint(const VertexData &vertices) override {
-		return 0.0;
-	}
+	signed_area *= 0.5;
 
-	double ProcessLineString(const VertexData &vertices) override {
-		return 0.0;
-	}
+	return std::abs(signed_area);
+}
 
-	double ProcessPolygon(PolygonState &state) override {
-		double sum = 0.0;
-		if (!state.IsDone()) {
-			sum += ProcessVertices(state.Next());
+static double GeometryArea(const GeometryView &geom) {
+	struct op {
+		static double Case(Geometry::Tags::Polygon, const GeometryView &polygon) {
+			double sum = 0.0;
+			bool is_shell = true;
+			for (const auto &ring : polygon) {
+				sum += is_shell ? RingArea(ring) : -RingArea(ring);
+				is_shell = false;
+			}
+			return std::abs(sum);
 		}
-		while (!state.IsDone()) {
-			sum -= ProcessVertices(state.Next());
+		static double Case(Geometry::Tags::MultiPolygon, const GeometryView &collection) {
+			double sum = 0.0;
+			for (const auto &part : collection) {
+				sum += GeometryView::Match<op>(part);
+			}
+			return sum;
 		}
-		return std::abs(sum);
-	}
-
-	double ProcessCollection(CollectionState &state) override {
-		switch (CurrentType()) {
-		case GeometryType::MULTIPOLYGON:
-		case GeometryType::GEOMETRYCOLLECTION: {
-			double sum = 0;
-			while (!state.IsDone()) {
-				sum += state.Next();
+		static double Case(Geometry::Tags::GeometryCollection, const GeometryView &collection) {
+			double sum = 0.0;
+			for (const auto &part : collection) {
+				sum += GeometryView::Match<op>(part);
 			}
 			return sum;
 		}
-		default:
+		static double Case(Geometry::Tags::AnyGeometry, const GeometryView &) {
 			return 0.0;
 		}
-	}
-
-public:
-	double Execute(const geometry_t &geometry) {
-		return Process(geometry);
-	}
-};
+	};
+	return GeometryView::Match<op>(geom);
+}
 
 static void GeometryAreaFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	// The arena is only used to decompress compressed geometries
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
 	auto &input = args.data[0];
 	auto count = args.size();
-	AreaProcessor processor;
-	UnaryExecutor::Execute<geometry_t, double>(input, result, count,
-	                                           [&](const geometry_t &input) { return processor.Execute(input); });
+	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](const geometry_t &input) {
+		return GeometryArea(GeometryView(Geometry::Decompress(lstate.arena, input)));
+	});
 }
 
 //------------------------------------------------------------------------------
@@ -203,7 +194,8 @@ void CoreScalarFunctions::RegisterStArea(DatabaseInstance &db) {
 	set.AddFunction(ScalarFunction({GeoTypes::POINT_2D()}, LogicalType::DOUBLE, PointAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::LINESTRING_2D()}, LogicalType::DOUBLE, LineStringAreaFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, LogicalType::DOUBLE, PolygonAreaFunction));
-	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryAreaFunction));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, LogicalType::DOUBLE, GeometryAreaFunction, nullptr,
+	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, LogicalType::DOUBLE, BoxAreaFunction));
 
 	ExtensionUtil::RegisterFunction(db, set);
@@ -4,6 +4,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_view.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -198,6 +199,158 @@ static void BoxCentroidFunction(DataChunk &args, ExpressionState &state, Vector
 	}
 }
 
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+// Computes the centroid the same way (and in the same order of operations) as GEOS, which we used to call: the
+// centroid of the highest dimension components, where polygons are weighted by area, lines by length and points are
+// averaged.
+class GeometryCentroid {
+private:
+	//! The apex of the triangles the rings are split into, the first vertex of the first shell (like in GEOS)
+	VertexXY area_base {0};
+	bool has_area_base = false;
+	VertexXY triangle_sum {0};
+	double area_sum = 0;
+	VertexXY line_sum {0};
+	double line_length = 0;
+	VertexXY point_sum {0};
+	idx_t point_count = 0;
+
+	static bool IsCCW(const GeometryView &ring) {
+		const auto origin = ring.GetVertex(0);
+		double signed_area = 0;
+		for (uint32_t i = 1; i + 1 < ring.Count(); i++) {
+			const auto p1 = ring.GetVertex(i);
+			const auto p2 = ring.GetVertex(i + 1);
+			signed_area += (p1.x - origin.x) * (p2.y - origin.y) - (p2.x - origin.x) * (p1.y - origin.y);
+		}
+		return signed_area > 0;
+	}
+
+	void AddPoint(const VertexXY &point) {
+		point_count++;
+		point_sum.x += point.x;
+		point_sum.y += point.y;
+	}
+
+	void AddLineSegments(const GeometryView &line) {
+		double length = 0.0;
+		for (uint32_t i = 0; i + 1 < line.Count(); i++) {
+			const auto p1 = line.GetVertex(i);
+			const auto p2 = line.GetVertex(i + 1);
+			const auto dx = p1.x - p2.x;
+			const auto dy = p1.y - p2.y;
+			const auto segment_length = std::sqrt(dx * dx + dy * dy);
+			if (segment_length == 0.0) {
+				continue;
+			}
+			length += segment_length;
+			line_sum.x += segment_length * ((p1.x + p2.x) / 2);
+			line_sum.y += segment_length * ((p1.y + p2.y) / 2);
+		}
+		line_length += length;
+		if (length == 0.0 && line.Count() > 0) {
+			AddPoint(line.GetVertex(0));
+		}
+	}
+
+	void AddRing(const GeometryView &ring, bool is_shell) {
+		if (ring.Count() == 0) {
+			return;
+		}
+		if (is_shell && !has_area_base) {
+			area_base = ring.GetVertex(0);
+			has_area_base = true;
+		}
+		// Shells add area and holes subtract it, regardless of their orientation
+		const auto sign = IsCCW(ring) == is_shell ? -1.0 : 1.0;
+		for (uint32_t i = 0; i + 1 < ring.Count(); i++) {
+			const auto p1 = ring.GetVertex(i);
+			const auto p2 = ring.GetVertex(i + 1);
+			const auto area2 = (p1.x - area_base.x) * (p2.y - area_base.y) - (p2.x - area_base.x) * (p1.y - area_base.y);
+			triangle_sum.x += sign * area2 * (area_base.x + p1.x + p2.x);
+			triangle_sum.y += sign * area2 * (area_base.y + p1.y + p2.y);
+			area_sum += sign * area2;
+		}
+		AddLineSegments(ring);
+	}
+
+public:
+	void Add(const GeometryView &geom) {
+		if (GeometryView::IsEmpty(geom)) {
+			return;
+		}
+		switch (geom.GetType()) {
+		case GeometryType::POINT:
+			AddPoint(geom.GetVertex(0));
+			break;
+		case GeometryType::LINESTRING:
+			AddLineSegments(geom);
+			break;
+		case GeometryType::POLYGON: {
+			bool is_shell = true;
+			for (const auto &ring : geom) {
+				AddRing(ring, is_shell);
+				is_shell = false;
+			}
+		} break;
+		default:
+			for (const auto &part : geom) {
+				Add(part);
+			}
+			break;
+		}
+	}
+
+	bool TryGetCentroid(VertexXY &centroid) const {
+		if (std::abs(area_sum) > 0.0) {
+			centroid.x = triangle_sum.x / 3 / area_sum;
+			centroid.y = triangle_sum.y / 3 / area_sum;
+		} else if (line_length > 0.0) {
+			centroid.x = line_sum.x / line_length;
+			centroid.y = line_sum.y / line_length;
+		} else if (point_count > 0) {
+			centroid.x = point_sum.x / static_cast<double>(point_count);
+			centroid.y = point_sum.y / static_cast<double>(point_count);
+		} else {
+			return false;
+		}
+		return true;
+	}
+};
+
+static void GeometryCentroidFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &arena = lstate.arena;
+
+	UnaryExecutor::Execute<geometry_t, geometry_t>(args.data[0], result, args.size(), [&](geometry_t input) {
+		GeometryCentroid centroid;
+		centroid.Add(GeometryView(Geometry::Decompress(arena, input)));
+
+		VertexXY vertex;
+		if (!centroid.TryGetCentroid(vertex)) {
+			return Geometry::Serialize(Point::CreateEmpty(false, false), result);
+		}
+		return Geometry::Serialize(Point::CreateFromVertex(arena, vertex), result);
+	});
+}
+
+//------------------------------------------------------------------------------
+// Documentation
+//------------------------------------------------------------------------------
+static constexpr const char *DOC_DESCRIPTION = R"(
+Calculates the centroid of a geometry
+)";
+
+static constexpr const char *DOC_EXAMPLE = R"(
+select st_centroid('POLYGON((0 0, 0 1, 1 1, 1 0, 0 0))'::geometry);
+----
+ POINT(0.5 0.5)
+)";
+
+static constexpr DocTag DOC_TAGS[] = {{"ext", "spatial"}, {"category", "property"}};
+
 //------------------------------------------------------------------------------
 // Register functions
 //------------------------------------------------------------------------------
@@ -208,8 +361,11 @@ void CoreScalarFunctions::RegisterStCentroid(DatabaseInstance &db) {
 	set.AddFunction(ScalarFunction({GeoTypes::POLYGON_2D()}, GeoTypes::POINT_2D(), PolygonCentroidFunction));
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2D()}, GeoTypes::POINT_2D(), BoxCentroidFunction<double>));
 	set.AddFunction(ScalarFunction({GeoTypes::BOX_2DF()}, GeoTypes::POINT_2D(), BoxCentroidFunction<float>));
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY()}, GeoTypes::GEOMETRY(), GeometryCentroidFunction, nullptr,
+	                               nullptr, nullptr, GeometryFunctionLocalState::Init));
 
 	ExtensionUtil::RegisterFunction(db, set);
+	DocUtil::AddDocumentation(db, "ST_Centroid", DOC_DESCRIPTION, DOC_EXAMPLE, DOC_TAGS);
 }
 
 } // namespace core
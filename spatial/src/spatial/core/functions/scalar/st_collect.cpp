@@ -66,13 +66,17 @@ static void CollectFunction(DataChunk &args, ExpressionState &state, Vector &res
 
 		// TODO: Dont upcast the children, just append them.
 		if (all_points) {
-			return Geometry::Serialize(MultiPoint::Create(arena, geometries, has_z, has_m), result);
+			return Geometry::Serialize(MultiPoint::Create(arena, geometries, has_z, has_m), result,
+			                           lstate.write_part_index);
 		} else if (all_lines) {
-			return Geometry::Serialize(MultiLineString::Create(arena, geometries, has_z, has_m), result);
+			return Geometry::Serialize(MultiLineString::Create(arena, geometries, has_z, has_m), result,
+			                           lstate.write_part_index);
 		} else if (all_polygons) {
-			return Geometry::Serialize(MultiPolygon::Create(arena, geometries, has_z, has_m), result);
+			return Geometry::Serialize(MultiPolygon::Create(arena, geometries, has_z, has_m), result,
+			                           lstate.write_part_index);
 		} else {
-			return Geometry::Serialize(GeometryCollection::Create(arena, geometries, has_z, has_m), result);
+			return Geometry::Serialize(GeometryCollection::Create(arena, geometries, has_z, has_m), result,
+			                           lstate.write_part_index);
 		}
 	});
 }
@@ -0,0 +1,75 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryCompressFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &arena = lstate.arena;
+	auto &geom_vec = args.data[0];
+	auto &precision_vec = args.data[1];
+
+	auto count = args.size();
+
+	BinaryExecutor::Execute<geometry_t, int32_t, geometry_t>(
+	    geom_vec, precision_vec, result, count, [&](geometry_t input, int32_t precision) {
+		    if (precision < 0 || precision > GEOMETRY_MAX_COMPRESSION_PRECISION) {
+			    throw InvalidInputException("ST_Compress: precision must be between 0 and %d, got %d",
+			                                GEOMETRY_MAX_COMPRESSION_PRECISION, precision);
+		    }
+		    // Already compressed geometries are compressed again at the new precision
+		    auto blob = Geometry::Decompress(arena, input);
+		    geometry_t compressed;
+		    if (Geometry::TryCompress(blob, static_cast<uint8_t>(precision), result, compressed)) {
+			    return compressed;
+		    }
+		    // The coordinates are too large for the precision, or compressing doesn't make the geometry smaller
+		    return geometry_t(StringVector::AddStringOrBlob(result, blob));
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Documentation
+//------------------------------------------------------------------------------
+static constexpr const char *DOC_DESCRIPTION = R"(
+    Returns a compressed copy of the geometry, with all coordinates rounded to the given number of decimal digits (0 to 15).
+    Compressed geometries store their coordinates as delta encoded variable length integers, which usually takes a fraction of the space. All functions accept compressed geometries, which are decompressed on the fly.
+    If the coordinates are too large to be represented at the given precision, or if compressing the geometry would not make it smaller, the geometry is returned uncompressed (and unrounded).
+)";
+
+static constexpr const char *DOC_EXAMPLE = R"(
+SELECT ST_Compress('LINESTRING (4.8952 52.3702, 4.8961 52.3712)'::GEOMETRY, 4);
+----
+LINESTRING (4.8952 52.3702, 4.8961 52.3712)
+)";
+
+static constexpr DocTag DOC_TAGS[] = {{"ext", "spatial"}, {"category", "conversion"}};
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStCompress(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_Compress");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, GeoTypes::GEOMETRY(),
+	                               GeometryCompressFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+	DocUtil::AddDocumentation(db, "ST_Compress", DOC_DESCRIPTION, DOC_EXAMPLE, DOC_TAGS);
+}
+
+} // namespace core
+
+} // namespace spatial
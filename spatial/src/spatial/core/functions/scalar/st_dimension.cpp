@@ -3,6 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_view.hpp"
 
 #include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
@@ -16,14 +17,14 @@ namespace core {
 // GEOMETRY
 //------------------------------------------------------------------------------
 static void DimensionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	// The arena is only used to decompress compressed geometries
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-
 	auto count = args.size();
 	auto &input = args.data[0];
 
 	UnaryExecutor::Execute<geometry_t, int32_t>(input, result, count, [&](geometry_t input) {
-		auto geometry = Geometry::Deserialize(lstate.arena, input);
-		return Geometry::GetDimension(geometry, false);
+		auto geom = Geometry::Decompress(lstate.arena, input);
+		return static_cast<int32_t>(GeometryView::GetDimension(GeometryView(geom), false));
 	});
 }
 
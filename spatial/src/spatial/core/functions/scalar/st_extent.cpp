@@ -125,80 +125,79 @@ static void WKBExtFunction(DataChunk &args, ExpressionState &state, Vector &resu
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static void ExtentFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-
-	auto count = args.size();
-	auto &input = args.data[0];
-	auto &struct_vec = StructVector::GetEntries(result);
-	auto min_x_data = FlatVector::GetData<double>(*struct_vec[0]);
-	auto min_y_data = FlatVector::GetData<double>(*struct_vec[1]);
-	auto max_x_data = FlatVector::GetData<double>(*struct_vec[2]);
-	auto max_y_data = FlatVector::GetData<double>(*struct_vec[3]);
-
-	UnifiedVectorFormat input_vdata;
-	input.ToUnifiedFormat(count, input_vdata);
-	auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_vdata);
-
-	for (idx_t i = 0; i < count; i++) {
-		auto row_idx = input_vdata.sel->get_index(i);
-		if (input_vdata.validity.RowIsValid(row_idx)) {
-			auto &blob = input_data[row_idx];
-
-			// Try to get the cached bounding box from the blob
-			Box2D<double> bbox;
-			if (blob.TryGetCachedBounds(bbox)) {
-				min_x_data[i] = bbox.min.x;
-				min_y_data[i] = bbox.min.y;
-				max_x_data[i] = bbox.max.x;
-				max_y_data[i] = bbox.max.y;
-			} else {
-				// No bounding box, return null
-				FlatVector::SetNull(result, i, true);
-			}
-		} else {
-			// Null input, return null
-			FlatVector::SetNull(result, i, true);
-		}
+// Rounding of the bounds for BOX_2D (double) and BOX_2DF (float) results
+struct DoubleBounds {
+	using TYPE = double;
+	static double Min(double value) {
+		return value;
+	}
+	static double Max(double value) {
+		return value;
 	}
+};
 
-	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
-		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+struct FloatBounds {
+	using TYPE = float;
+	static float Min(double value) {
+		return MathUtil::DoubleToFloatDown(value);
 	}
-}
+	static float Max(double value) {
+		return MathUtil::DoubleToFloatUp(value);
+	}
+};
 
-static void ExtentCachedFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+// Extract the cached bounds of a whole vector of geometries. The float bounding box is read straight out of the
+// header of the blobs that have one, only points (and empty geometries) go through geometry_t::TryGetCachedBounds.
+// Empty geometries have no bounds and produce NULL.
+template <class OP>
+static void ExtractCachedBounds(Vector &input, Vector &result, idx_t count) {
+	using T = typename OP::TYPE;
 
-	auto count = args.size();
-	auto &input = args.data[0];
 	auto &struct_vec = StructVector::GetEntries(result);
-	auto min_x_data = FlatVector::GetData<float>(*struct_vec[0]);
-	auto min_y_data = FlatVector::GetData<float>(*struct_vec[1]);
-	auto max_x_data = FlatVector::GetData<float>(*struct_vec[2]);
-	auto max_y_data = FlatVector::GetData<float>(*struct_vec[3]);
+	auto min_x_data = FlatVector::GetData<T>(*struct_vec[0]);
+	auto min_y_data = FlatVector::GetData<T>(*struct_vec[1]);
+	auto max_x_data = FlatVector::GetData<T>(*struct_vec[2]);
+	auto max_y_data = FlatVector::GetData<T>(*struct_vec[3]);
 
 	UnifiedVectorFormat input_vdata;
 	input.ToUnifiedFormat(count, input_vdata);
 	const auto input_data = UnifiedVectorFormat::GetData<geometry_t>(input_vdata);
 
+	// The header (4 bytes), padding (4 bytes) and the bounding box (16 bytes) make blobs with a bounding box too long
+	// to be inlined, so the bounding box is always 8 bytes into the data pointer
+	static constexpr idx_t BBOX_OFFSET = sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) +
+	                                     sizeof(uint32_t);
+
 	for (idx_t i = 0; i < count; i++) {
 		const auto row_idx = input_vdata.sel->get_index(i);
-		if (input_vdata.validity.RowIsValid(row_idx)) {
-			auto &blob = input_data[row_idx];
-
-			// Try to get the cached bounding box from the blob
-			Box2D<double> bbox;
-			if (blob.TryGetCachedBounds(bbox)) {
-				min_x_data[i] = MathUtil::DoubleToFloatDown(bbox.min.x);
-				min_y_data[i] = MathUtil::DoubleToFloatDown(bbox.min.y);
-				max_x_data[i] = MathUtil::DoubleToFloatUp(bbox.max.x);
-				max_y_data[i] = MathUtil::DoubleToFloatUp(bbox.max.y);
-			} else {
-				// No bounding box, return null
-				FlatVector::SetNull(result, i, true);
-			}
-		} else {
+		if (!input_vdata.validity.RowIsValid(row_idx)) {
 			// Null input, return null
 			FlatVector::SetNull(result, i, true);
+			continue;
+		}
+
+		const string_t blob = input_data[row_idx];
+		const auto properties = Load<GeometryProperties>(const_data_ptr_cast(blob.GetPrefix()) + sizeof(GeometryType));
+		properties.CheckVersion();
+
+		if (properties.HasBBox()) {
+			const auto bbox_ptr = const_data_ptr_cast(blob.GetData()) + BBOX_OFFSET;
+			min_x_data[i] = OP::Min(Load<float>(bbox_ptr));
+			min_y_data[i] = OP::Min(Load<float>(bbox_ptr + sizeof(float)));
+			max_x_data[i] = OP::Max(Load<float>(bbox_ptr + 2 * sizeof(float)));
+			max_y_data[i] = OP::Max(Load<float>(bbox_ptr + 3 * sizeof(float)));
+			continue;
+		}
+
+		Box2D<double> bbox;
+		if (geometry_t(blob).TryGetCachedBounds(bbox)) {
+			min_x_data[i] = OP::Min(bbox.min.x);
+			min_y_data[i] = OP::Min(bbox.min.y);
+			max_x_data[i] = OP::Max(bbox.max.x);
+			max_y_data[i] = OP::Max(bbox.max.y);
+		} else {
+			// No bounding box, return null
+			FlatVector::SetNull(result, i, true);
 		}
 	}
 
@@ -207,6 +206,14 @@ static void ExtentCachedFunction(DataChunk &args, ExpressionState &state, Vector
 	}
 }
 
+static void ExtentFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	ExtractCachedBounds<DoubleBounds>(args.data[0], result, args.size());
+}
+
+static void ExtentCachedFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	ExtractCachedBounds<FloatBounds>(args.data[0], result, args.size());
+}
+
 //------------------------------------------------------------------------------
 // Documentation
 //------------------------------------------------------------------------------
@@ -0,0 +1,84 @@
+#include "spatial/common.hpp"
+#include "spatial/core/types.hpp"
+#include "spatial/core/functions/scalar.hpp"
+#include "spatial/core/functions/common.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_part_reader.hpp"
+
+#include "duckdb/parser/parsed_data/create_scalar_function_info.hpp"
+#include "duckdb/common/vector_operations/binary_executor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// GEOMETRY
+//------------------------------------------------------------------------------
+static void GeometryGeometryNFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
+	auto &arena = lstate.arena;
+	auto &geom_vec = args.data[0];
+	auto &index_vec = args.data[1];
+
+	auto count = args.size();
+
+	BinaryExecutor::ExecuteWithNulls<geometry_t, int32_t, geometry_t>(
+	    geom_vec, index_vec, result, count, [&](geometry_t input, int32_t index, ValidityMask &mask, idx_t row_idx) {
+		    GeometryPartReader reader(Geometry::Decompress(arena, input));
+		    if (!reader.IsCollection()) {
+			    // Non-collections are their own first and only part
+			    if (index != 1 && index != -1) {
+				    mask.SetInvalid(row_idx);
+				    return geometry_t {};
+			    }
+			    return geometry_t(StringVector::AddStringOrBlob(result, input));
+		    }
+
+		    auto part_count = reader.PartCount();
+		    if (part_count == 0 || index == 0 || index < -static_cast<int64_t>(part_count) ||
+		        index > static_cast<int64_t>(part_count)) {
+			    mask.SetInvalid(row_idx);
+			    return geometry_t {};
+		    }
+
+		    auto actual_index = index < 0 ? part_count + index : index - 1;
+		    // Only the requested part is deserialized
+		    auto part = reader.ReadPart(arena, actual_index);
+		    return Geometry::Serialize(part, result);
+	    });
+}
+
+//------------------------------------------------------------------------------
+// Documentation
+//------------------------------------------------------------------------------
+static constexpr const char *DOC_DESCRIPTION = R"(
+    Returns the n'th (1-based) component geometry of a collection geometry. Negative indices count from the end.
+    If the input geometry is not a collection, the geometry itself is returned for index 1 (or -1), and NULL otherwise.
+)";
+
+static constexpr const char *DOC_EXAMPLE = R"(
+SELECT ST_GeometryN('MULTIPOINT (1 2, 3 4)'::GEOMETRY, 2);
+----
+POINT (3 4)
+)";
+
+static constexpr DocTag DOC_TAGS[] = {{"ext", "spatial"}, {"category", "construction"}};
+//------------------------------------------------------------------------------
+// Register functions
+//------------------------------------------------------------------------------
+void CoreScalarFunctions::RegisterStGeometryN(DatabaseInstance &db) {
+
+	ScalarFunctionSet set("ST_GeometryN");
+
+	set.AddFunction(ScalarFunction({GeoTypes::GEOMETRY(), LogicalType::INTEGER}, GeoTypes::GEOMETRY(),
+	                               GeometryGeometryNFunction, nullptr, nullptr, nullptr,
+	                               GeometryFunctionLocalState::Init));
+
+	ExtensionUtil::RegisterFunction(db, set);
+	DocUtil::AddDocumentation(db, "ST_GeometryN", DOC_DESCRIPTION, DOC_EXAMPLE, DOC_TAGS);
+}
+
+} // namespace core
+
+} // namespace spatial
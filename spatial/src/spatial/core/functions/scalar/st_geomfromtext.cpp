@@ -45,7 +45,8 @@ static void GeometryFromWKTFunction(DataChunk &args, ExpressionState &state, Vec
 	                                                      [&](string_t &wkt, ValidityMask &mask, idx_t idx) {
 		                                                      try {
 			                                                      auto geom = reader.Parse(wkt);
-			                                                      return Geometry::Serialize(geom, result);
+			                                                      return Geometry::Serialize(geom, result,
+			                                                                                 lstate.write_part_index);
 		                                                      } catch (InvalidInputException &error) {
 			                                                      if (!info.ignore_invalid) {
 				                                                      throw;
@@ -275,7 +275,7 @@ static void GeometryFromWKBFunction(DataChunk &args, ExpressionState &state, Vec
 	WKBReader reader(arena);
 	UnaryExecutor::Execute<string_t, geometry_t>(input, result, count, [&](string_t input) {
 		auto geom = reader.Deserialize(input);
-		return Geometry::Serialize(geom, result);
+		return Geometry::Serialize(geom, result, lstate.write_part_index);
 	});
 }
 
@@ -3,6 +3,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_view.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -46,19 +47,46 @@ static void LineLengthFunction(DataChunk &args, ExpressionState &state, Vector &
 //------------------------------------------------------------------------------
 // GEOMETRY
 //------------------------------------------------------------------------------
-static void GeometryLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+static double GeometryLength(const GeometryView &geom) {
+	struct op {
+		static double Case(Geometry::Tags::LineString, const GeometryView &line) {
+			double length = 0;
+			for (uint32_t i = 1; i < line.Count(); i++) {
+				auto p1 = line.GetVertex(i - 1);
+				auto p2 = line.GetVertex(i);
+				length += sqrt((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y));
+			}
+			return length;
+		}
+		static double Case(Geometry::Tags::MultiLineString, const GeometryView &collection) {
+			double length = 0;
+			for (const auto &part : collection) {
+				length += Case(Geometry::Tags::LineString {}, part);
+			}
+			return length;
+		}
+		static double Case(Geometry::Tags::GeometryCollection, const GeometryView &collection) {
+			double length = 0;
+			for (const auto &part : collection) {
+				length += GeometryView::Match<op>(part);
+			}
+			return length;
+		}
+		static double Case(Geometry::Tags::AnyGeometry, const GeometryView &) {
+			return 0;
+		}
+	};
+	return GeometryView::Match<op>(geom);
+}
 
+static void GeometryLengthFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	// The arena is only used to decompress compressed geometries
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-	auto &arena = lstate.arena;
-
 	auto &input = args.data[0];
 	auto count = args.size();
 
 	UnaryExecutor::Execute<geometry_t, double>(input, result, count, [&](geometry_t input) {
-		auto geom = Geometry::Deserialize(arena, input);
-		double length = 0.0;
-		Geometry::ExtractLines(geom, [&](const Geometry &line) { length += LineString::Length(line); });
-		return length;
+		return GeometryLength(GeometryView(Geometry::Decompress(lstate.arena, input)));
 	});
 
 	if (count == 1) {
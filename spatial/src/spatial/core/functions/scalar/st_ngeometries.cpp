@@ -4,6 +4,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_part_reader.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -21,10 +22,11 @@ static void GeometryNGeometriesFunction(DataChunk &args, ExpressionState &state,
 	auto count = args.size();
 
 	UnaryExecutor::Execute<geometry_t, int32_t>(input, result, count, [&](geometry_t input) {
+		if (GeometryTypes::IsCollection(input.GetType())) {
+			// The number of parts is stored in the collection header, no need to deserialize all of them
+			return static_cast<int32_t>(GeometryPartReader(Geometry::Decompress(ctx.arena, input)).PartCount());
+		}
 		struct op {
-			static int32_t Case(Geometry::Tags::CollectionGeometry, const Geometry &collection) {
-				return static_cast<int32_t>(CollectionGeometry::PartCount(collection));
-			}
 			static int32_t Case(Geometry::Tags::Polygon, const Geometry &geom) {
 				return Polygon::IsEmpty(geom) ? 0 : 1;
 			}
@@ -4,6 +4,7 @@
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/common.hpp"
 #include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/geometry/geometry_view.hpp"
 #include "spatial/core/types.hpp"
 
 namespace spatial {
@@ -69,29 +70,26 @@ static void BoxNumPointsFunction(DataChunk &args, ExpressionState &state, Vector
 //------------------------------------------------------------------------------
 
 static void GeometryNumPointsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	// The arena is only used to decompress compressed geometries
 	auto &lstate = GeometryFunctionLocalState::ResetAndGet(state);
-	auto &arena = lstate.arena;
-
 	auto &input = args.data[0];
 	auto count = args.size();
 
 	struct op {
-		static uint32_t Case(Geometry::Tags::SinglePartGeometry, const Geometry &geom) {
+		static uint32_t Case(Geometry::Tags::SinglePartGeometry, const GeometryView &geom) {
 			return geom.Count();
 		}
-		static uint32_t Case(Geometry::Tags::MultiPartGeometry, const Geometry &geom) {
+		static uint32_t Case(Geometry::Tags::MultiPartGeometry, const GeometryView &geom) {
 			uint32_t count = 0;
-			for (uint32_t i = 0; i < MultiPartGeometry::PartCount(geom); i++) {
-				auto part = MultiPartGeometry::Part(geom, i);
-				count += Geometry::Match<op>(part);
+			for (const auto &part : geom) {
+				count += GeometryView::Match<op>(part);
 			}
 			return count;
 		}
 	};
 
 	UnaryExecutor::Execute<geometry_t, uint32_t>(input, result, count, [&](geometry_t input) {
-		auto geom = Geometry::Deserialize(arena, input);
-		return Geometry::Match<op>(geom);
+		return GeometryView::Match<op>(GeometryView(Geometry::Decompress(lstate.arena, input)));
 	});
 }
 
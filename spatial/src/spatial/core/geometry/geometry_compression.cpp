@@ -0,0 +1,414 @@
+#include "spatial/common.hpp"
+#include "spatial/core/util/cursor.hpp"
+#include "spatial/core/util/math.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//----------------------------------------------------------------------
+// Compression
+//----------------------------------------------------------------------
+// Compressed geometries (the COMPRESSED property flag is set) have the same header and bounding box as uncompressed
+// geometries, but the bounding box is widened by half the quantization step so that it still contains the rounded
+// vertices. The rest of the blob is a byte stream of unsigned LEB128 varints:
+//    Precision (1 byte), the number of decimal digits the coordinates are rounded to
+//    DecompressedSize (varint), the size of the uncompressed blob
+//    Geometry
+// -- Point/LineString
+//    Type (varint)
+//    Count (varint)
+//    Vertices
+// -- Polygon
+//    Type (varint)
+//    NumRings (varint)
+//    RingLengths (varint per ring)
+//    Vertices of all rings
+// -- Multi/Point/LineString/Polygon & GeometryCollection
+//    Type (varint)
+//    NumGeometries (varint)
+//    Geometries
+//
+// Every coordinate is multiplied by 10^precision, rounded to an integer and stored as the zig-zag encoded difference to
+// the same coordinate of the previous vertex (in any part), the first vertex is stored relative to zero.
+// Compressed geometries never have a part index, they decompress into version 0 geometries.
+
+static uint64_t ZigZagEncode(int64_t value) {
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t ZigZagDecode(uint64_t value) {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Computes the size of (WRITE = false) or writes (WRITE = true) the compressed geometry data
+template <bool WRITE>
+class CompressedGeometryWriter {
+	// Keep the quantized coordinates well inside the int64 range so that the deltas can't overflow
+	static constexpr double MAX_QUANTIZED = 4611686018427387904.0; // 2^62
+
+	Cursor *out;
+	uint32_t size = 0;
+	double scale;
+	uint32_t dims;
+	int64_t previous[4] = {0, 0, 0, 0};
+
+	void WriteVarint(uint64_t value) {
+		if (WRITE) {
+			out->WriteVarint(value);
+		}
+		size += Cursor::VarintSize(value);
+	}
+
+	bool WriteVertices(Cursor &cursor, uint32_t count) {
+		for (uint32_t i = 0; i < count; i++) {
+			for (uint32_t d = 0; d < dims; d++) {
+				const auto scaled = std::round(cursor.Read<double>() * scale);
+				// Also rejects NaN
+				if (!(std::abs(scaled) < MAX_QUANTIZED)) {
+					return false;
+				}
+				const auto quantized = static_cast<int64_t>(scaled);
+				WriteVarint(ZigZagEncode(quantized - previous[d]));
+				previous[d] = quantized;
+			}
+		}
+		return true;
+	}
+
+public:
+	CompressedGeometryWriter(Cursor *out, double scale, uint32_t dims) : out(out), scale(scale), dims(dims) {
+	}
+
+	uint32_t Size() const {
+		return size;
+	}
+
+	bool Write(Cursor &cursor, uint32_t depth) {
+		if (depth > 256) {
+			throw SerializationException("GeometryCollection depth exceeded 256!");
+		}
+		const auto type = cursor.Read<SerializedGeometryType>();
+		const auto count = cursor.Read<uint32_t>();
+		WriteVarint(static_cast<uint32_t>(type));
+		WriteVarint(count);
+
+		switch (type) {
+		case SerializedGeometryType::POINT:
+		case SerializedGeometryType::LINESTRING:
+			return WriteVertices(cursor, count);
+		case SerializedGeometryType::POLYGON: {
+			uint32_t vertex_count = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				const auto ring_count = cursor.Read<uint32_t>();
+				WriteVarint(ring_count);
+				vertex_count += ring_count;
+			}
+			if (count % 2 == 1) {
+				cursor.Skip(sizeof(uint32_t)); // padding
+			}
+			return WriteVertices(cursor, vertex_count);
+		}
+		case SerializedGeometryType::MULTIPOINT:
+		case SerializedGeometryType::MULTILINESTRING:
+		case SerializedGeometryType::MULTIPOLYGON:
+		case SerializedGeometryType::GEOMETRYCOLLECTION:
+			for (uint32_t i = 0; i < count; i++) {
+				if (!Write(cursor, depth + 1)) {
+					return false;
+				}
+			}
+			return true;
+		default:
+			throw SerializationException("Unknown geometry type (%ud)", static_cast<uint32_t>(type));
+		}
+	}
+};
+
+class CompressedGeometryReader {
+	double scale;
+	uint32_t dims;
+	// Unsigned so that corrupt deltas wrap around instead of overflowing
+	uint64_t previous[4] = {0, 0, 0, 0};
+
+	void ReadVertices(Cursor &in, Cursor &out, uint32_t count) {
+		for (uint32_t i = 0; i < count; i++) {
+			for (uint32_t d = 0; d < dims; d++) {
+				previous[d] += static_cast<uint64_t>(ZigZagDecode(in.ReadVarint()));
+				out.Write<double>(static_cast<double>(static_cast<int64_t>(previous[d])) / scale);
+			}
+		}
+	}
+
+public:
+	CompressedGeometryReader(double scale, uint32_t dims) : scale(scale), dims(dims) {
+	}
+
+	void Read(Cursor &in, Cursor &out, uint32_t depth) {
+		if (depth > 256) {
+			throw SerializationException("GeometryCollection depth exceeded 256!");
+		}
+		const auto type = static_cast<SerializedGeometryType>(in.ReadVarint());
+		const auto count = static_cast<uint32_t>(in.ReadVarint());
+		out.Write<SerializedGeometryType>(type);
+		out.Write<uint32_t>(count);
+
+		switch (type) {
+		case SerializedGeometryType::POINT:
+		case SerializedGeometryType::LINESTRING:
+			ReadVertices(in, out, count);
+			break;
+		case SerializedGeometryType::POLYGON: {
+			uint32_t vertex_count = 0;
+			for (uint32_t i = 0; i < count; i++) {
+				const auto ring_count = static_cast<uint32_t>(in.ReadVarint());
+				out.Write<uint32_t>(ring_count);
+				vertex_count += ring_count;
+			}
+			if (count % 2 == 1) {
+				out.Write<uint32_t>(0); // padding
+			}
+			ReadVertices(in, out, vertex_count);
+		} break;
+		case SerializedGeometryType::MULTIPOINT:
+		case SerializedGeometryType::MULTILINESTRING:
+		case SerializedGeometryType::MULTIPOLYGON:
+		case SerializedGeometryType::GEOMETRYCOLLECTION:
+			for (uint32_t i = 0; i < count; i++) {
+				Read(in, out, depth + 1);
+			}
+			break;
+		default:
+			throw SerializationException("Unknown geometry type (%ud)", static_cast<uint32_t>(type));
+		}
+	}
+};
+
+// Decodes the compressed vertices straight into the vertex arrays of arena allocated geometries, without going through
+// the uncompressed blob (see Geometry::Deserialize)
+class CompressedGeometryDeserializer {
+	ArenaAllocator &arena;
+	double scale;
+	bool has_z;
+	bool has_m;
+	uint32_t dims;
+	uint64_t previous[4] = {0, 0, 0, 0};
+
+	void ReadVertices(Cursor &in, data_ptr_t target, uint32_t count) {
+		for (uint32_t i = 0; i < count; i++) {
+			for (uint32_t d = 0; d < dims; d++) {
+				previous[d] += static_cast<uint64_t>(ZigZagDecode(in.ReadVarint()));
+				Store<double>(static_cast<double>(static_cast<int64_t>(previous[d])) / scale, target);
+				target += sizeof(double);
+			}
+		}
+	}
+
+	Geometry ReadSinglePart(Cursor &in, GeometryType type, uint32_t count) {
+		if (count == 0) {
+			return Geometry::CreateEmpty(type, has_z, has_m);
+		}
+		auto geom = Geometry::Create(arena, type, count, has_z, has_m);
+		ReadVertices(in, geom.GetData(), count);
+		return geom;
+	}
+
+public:
+	CompressedGeometryDeserializer(ArenaAllocator &arena, double scale, bool has_z, bool has_m)
+	    : arena(arena), scale(scale), has_z(has_z), has_m(has_m), dims(2 + (has_z ? 1 : 0) + (has_m ? 1 : 0)) {
+	}
+
+	Geometry Read(Cursor &in, uint32_t depth) {
+		if (depth > 256) {
+			throw SerializationException("GeometryCollection depth exceeded 256!");
+		}
+		const auto type = static_cast<SerializedGeometryType>(in.ReadVarint());
+		const auto count = static_cast<uint32_t>(in.ReadVarint());
+
+		switch (type) {
+		case SerializedGeometryType::POINT:
+			return ReadSinglePart(in, GeometryType::POINT, count);
+		case SerializedGeometryType::LINESTRING:
+			return ReadSinglePart(in, GeometryType::LINESTRING, count);
+		case SerializedGeometryType::POLYGON: {
+			if (count == 0) {
+				return Polygon::CreateEmpty(has_z, has_m);
+			}
+			// The ring lengths come before the vertices of all rings
+			auto polygon = Polygon::Create(arena, count, has_z, has_m);
+			for (uint32_t i = 0; i < count; i++) {
+				const auto ring_count = static_cast<uint32_t>(in.ReadVarint());
+				if (ring_count != 0) {
+					Polygon::Part(polygon, i) = LineString::Create(arena, ring_count, has_z, has_m);
+				}
+			}
+			for (auto &ring : Polygon::Parts(polygon)) {
+				ReadVertices(in, ring.GetData(), LineString::VertexCount(ring));
+			}
+			return polygon;
+		}
+		case SerializedGeometryType::MULTIPOINT:
+		case SerializedGeometryType::MULTILINESTRING:
+		case SerializedGeometryType::MULTIPOLYGON:
+		case SerializedGeometryType::GEOMETRYCOLLECTION: {
+			const auto geom_type = static_cast<GeometryType>(type);
+			if (count == 0) {
+				return Geometry::CreateEmpty(geom_type, has_z, has_m);
+			}
+			auto collection = Geometry::Create(arena, geom_type, count, has_z, has_m);
+			for (uint32_t i = 0; i < count; i++) {
+				// Placement new, the parts are not initialized yet
+				new (&CollectionGeometry::Part(collection, i)) Geometry(Read(in, depth + 1));
+			}
+			return collection;
+		}
+		default:
+			throw SerializationException("Unknown geometry type (%ud)", static_cast<uint32_t>(type));
+		}
+	}
+};
+
+bool Geometry::TryCompress(const geometry_t &data, uint8_t precision, Vector &result, geometry_t &compressed) {
+	D_ASSERT(precision <= GEOMETRY_MAX_COMPRESSION_PRECISION);
+
+	auto properties = data.GetProperties();
+	D_ASSERT(!properties.IsCompressed());
+	const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+	const auto bbox_size = properties.HasBBox() ? dims * 2 * sizeof(float) : 0;
+	const auto header_size = sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) + sizeof(uint32_t);
+	const auto scale = std::pow(10.0, precision);
+
+	// First compute the size, this also checks that all coordinates can be quantized
+	Cursor cursor(data);
+	cursor.Skip(header_size + bbox_size);
+	CompressedGeometryWriter<false> size_writer(nullptr, scale, dims);
+	if (!size_writer.Write(cursor, 0)) {
+		return false;
+	}
+	// Any part index is dropped, so the geometry decompresses into a version 0 geometry
+	const auto decompressed_size = static_cast<uint32_t>(cursor.GetPtr() - cursor.GetStart());
+	const auto size =
+	    header_size + bbox_size + sizeof(uint8_t) + Cursor::VarintSize(decompressed_size) + size_writer.Size();
+	if (size >= static_cast<string_t>(data).GetSize()) {
+		return false;
+	}
+
+	auto blob = StringVector::EmptyString(result, size);
+	Cursor in(data);
+	Cursor out(blob);
+
+	// Write the header
+	properties.SetCompressed(true);
+	properties.SetVersion(1);
+	out.Write<GeometryType>(in.Read<GeometryType>());
+	in.Skip<GeometryProperties>();
+	out.Write<GeometryProperties>(properties);
+	out.Write<uint16_t>(in.Read<uint16_t>());
+	out.Write<uint32_t>(in.Read<uint32_t>());
+
+	// Widen the bounding box so that it still contains the rounded coordinates. The axes are stored as
+	// min x, min y, max x, max y, followed by min/max pairs for the Z and M axes.
+	if (properties.HasBBox()) {
+		const auto half_step = 0.5 / scale;
+		for (uint32_t i = 0; i < dims * 2; i++) {
+			const auto is_min = i < 4 ? i < 2 : i % 2 == 0;
+			const auto value = static_cast<double>(in.Read<float>());
+			out.Write<float>(is_min ? MathUtil::DoubleToFloatDown(value - half_step)
+			                        : MathUtil::DoubleToFloatUp(value + half_step));
+		}
+	}
+
+	out.Write<uint8_t>(precision);
+	out.WriteVarint(decompressed_size);
+	CompressedGeometryWriter<true> writer(&out, scale, dims);
+	writer.Write(in, 0);
+	D_ASSERT(out.GetPtr() == out.GetEnd());
+
+	blob.Finalize();
+	compressed = geometry_t(blob);
+	return true;
+}
+
+uint32_t Geometry::GetDecompressedSize(const geometry_t &data) {
+	const auto properties = data.GetProperties();
+	D_ASSERT(properties.IsCompressed());
+	const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+	const auto bbox_size = properties.HasBBox() ? dims * 2 * sizeof(float) : 0;
+
+	Cursor cursor(data);
+	cursor.Skip(sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) + sizeof(uint32_t) + bbox_size);
+	cursor.Skip<uint8_t>(); // precision
+	return static_cast<uint32_t>(cursor.ReadVarint());
+}
+
+void Geometry::Decompress(const geometry_t &data, data_ptr_t target) {
+	auto properties = data.GetProperties();
+	D_ASSERT(properties.IsCompressed());
+	const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+
+	Cursor in(data);
+	in.Skip(sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) + sizeof(uint32_t) +
+	        (properties.HasBBox() ? dims * 2 * sizeof(float) : 0));
+	const auto precision = in.Read<uint8_t>();
+	const auto size = static_cast<uint32_t>(in.ReadVarint());
+	if (precision > GEOMETRY_MAX_COMPRESSION_PRECISION) {
+		throw SerializationException("Invalid compressed geometry precision (%d)", precision);
+	}
+	const auto body_ptr = in.GetPtr();
+
+	// Copy the header and the bounding box
+	properties.SetCompressed(false);
+	properties.SetVersion(0);
+	in.SetPtr(in.GetStart());
+	Cursor out(target, target + size);
+	out.Write<GeometryType>(in.Read<GeometryType>());
+	in.Skip<GeometryProperties>();
+	out.Write<GeometryProperties>(properties);
+	out.Write<uint16_t>(in.Read<uint16_t>());
+	out.Write<uint32_t>(in.Read<uint32_t>());
+	if (properties.HasBBox()) {
+		for (uint32_t i = 0; i < dims * 2; i++) {
+			out.Write<float>(in.Read<float>());
+		}
+	}
+
+	in.SetPtr(body_ptr);
+	CompressedGeometryReader reader(std::pow(10.0, precision), dims);
+	reader.Read(in, out, 0);
+	if (out.GetPtr() != out.GetEnd()) {
+		throw SerializationException("Compressed geometry does not match its decompressed size");
+	}
+}
+
+Geometry Geometry::DeserializeCompressed(ArenaAllocator &arena, const geometry_t &data) {
+	const auto properties = data.GetProperties();
+	D_ASSERT(properties.IsCompressed());
+	const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+
+	Cursor in(data);
+	in.Skip(sizeof(GeometryType) + sizeof(GeometryProperties) + sizeof(uint16_t) + sizeof(uint32_t) +
+	        (properties.HasBBox() ? dims * 2 * sizeof(float) : 0));
+	const auto precision = in.Read<uint8_t>();
+	if (precision > GEOMETRY_MAX_COMPRESSION_PRECISION) {
+		throw SerializationException("Invalid compressed geometry precision (%d)", precision);
+	}
+	in.ReadVarint(); // decompressed size
+
+	CompressedGeometryDeserializer deserializer(arena, std::pow(10.0, precision), properties.HasZ(), properties.HasM());
+	return deserializer.Read(in, 0);
+}
+
+geometry_t Geometry::Decompress(ArenaAllocator &arena, const geometry_t &data) {
+	if (!data.GetProperties().IsCompressed()) {
+		return data;
+	}
+	const auto size = GetDecompressedSize(data);
+	const auto ptr = arena.AllocateAligned(size);
+	Decompress(data, ptr);
+	return geometry_t(string_t(const_char_ptr_cast(ptr), size));
+}
+
+} // namespace core
+
+} // namespace spatial
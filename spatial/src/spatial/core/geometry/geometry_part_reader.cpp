@@ -0,0 +1,128 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/geometry_part_reader.hpp"
+#include "spatial/core/util/cursor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+// Move the cursor past the serialized geometry at the cursor
+static void SkipGeometry(Cursor &cursor, uint32_t vertex_size, uint32_t depth) {
+	if (depth > 256) {
+		throw SerializationException("GeometryCollection depth exceeded 256!");
+	}
+	const auto type = cursor.Read<SerializedGeometryType>();
+	const auto count = cursor.Read<uint32_t>();
+	switch (type) {
+	case SerializedGeometryType::POINT:
+	case SerializedGeometryType::LINESTRING:
+		cursor.Skip(count * vertex_size);
+		break;
+	case SerializedGeometryType::POLYGON: {
+		uint32_t vertex_count = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			vertex_count += cursor.Read<uint32_t>();
+		}
+		if (count % 2 == 1) {
+			cursor.Skip(sizeof(uint32_t)); // padding
+		}
+		cursor.Skip(vertex_count * vertex_size);
+	} break;
+	case SerializedGeometryType::MULTIPOINT:
+	case SerializedGeometryType::MULTILINESTRING:
+	case SerializedGeometryType::MULTIPOLYGON:
+	case SerializedGeometryType::GEOMETRYCOLLECTION:
+		for (uint32_t i = 0; i < count; i++) {
+			SkipGeometry(cursor, vertex_size, depth + 1);
+		}
+		break;
+	default:
+		throw SerializationException("Unknown geometry type (%ud)", static_cast<uint32_t>(type));
+	}
+}
+
+GeometryPartReader::GeometryPartReader(const geometry_t &geom_p) : geom(geom_p) {
+	const auto properties = geom.GetProperties();
+	D_ASSERT(!properties.IsCompressed());
+	is_collection = GeometryTypes::IsCollection(geom.GetType());
+	vertex_size = properties.VertexSize();
+	if (!is_collection) {
+		return;
+	}
+
+	Cursor cursor(geom);
+	cursor.Skip<GeometryType>();
+	cursor.Skip<GeometryProperties>();
+	cursor.Skip<uint16_t>();
+	cursor.Skip<uint32_t>();
+	if (properties.HasBBox()) {
+		const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+		cursor.Skip(dims * 2 * sizeof(float));
+	}
+	cursor.Skip<SerializedGeometryType>();
+	part_count = cursor.Read<uint32_t>();
+
+	first_ptr = cursor.GetPtr();
+	next_ptr = first_ptr;
+	next_index = 0;
+
+	if (properties.HasPartIndex()) {
+		const auto index_size = part_count * (sizeof(uint32_t) + 4 * sizeof(float));
+		if (index_size > cursor.Remaining()) {
+			throw SerializationException("Geometry part index is out of bounds");
+		}
+		offsets_ptr = cursor.GetEnd() - index_size;
+		bounds_ptr = offsets_ptr + part_count * sizeof(uint32_t);
+	}
+}
+
+const_data_ptr_t GeometryPartReader::GetPart(uint32_t index) {
+	D_ASSERT(index < part_count);
+
+	if (HasPartIndex()) {
+		const auto offset = Load<uint32_t>(offsets_ptr + index * sizeof(uint32_t));
+		const auto part_ptr = const_data_ptr_cast(static_cast<string_t>(geom).GetData()) + offset;
+		if (part_ptr < first_ptr || part_ptr >= offsets_ptr) {
+			throw SerializationException("Geometry part offset is out of bounds");
+		}
+		return part_ptr;
+	}
+
+	// No index, walk forward from the last part we returned (or from the start)
+	if (index < next_index) {
+		next_ptr = first_ptr;
+		next_index = 0;
+	}
+	Cursor cursor(geom);
+	cursor.SetPtr(const_cast<data_ptr_t>(next_ptr));
+	while (next_index < index) {
+		SkipGeometry(cursor, vertex_size, 0);
+		next_index++;
+	}
+	const auto part_ptr = cursor.GetPtr();
+	SkipGeometry(cursor, vertex_size, 0);
+	next_ptr = cursor.GetPtr();
+	next_index = index + 1;
+	return part_ptr;
+}
+
+bool GeometryPartReader::TryGetPartBounds(uint32_t index, Box2D<double> &bbox) const {
+	D_ASSERT(index < part_count);
+	if (!HasPartIndex()) {
+		return false;
+	}
+	const auto part_bounds_ptr = bounds_ptr + index * 4 * sizeof(float);
+	bbox.min.x = Load<float>(part_bounds_ptr);
+	bbox.min.y = Load<float>(part_bounds_ptr + sizeof(float));
+	bbox.max.x = Load<float>(part_bounds_ptr + 2 * sizeof(float));
+	bbox.max.y = Load<float>(part_bounds_ptr + 3 * sizeof(float));
+	return true;
+}
+
+Geometry GeometryPartReader::ReadPart(ArenaAllocator &arena, uint32_t index) {
+	return Geometry::DeserializePart(arena, geom, GetPart(index));
+}
+
+} // namespace core
+
+} // namespace spatial
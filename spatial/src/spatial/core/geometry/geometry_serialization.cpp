@@ -35,6 +35,17 @@ namespace core {
 //    Type (4 bytes)
 //    NumGeometries (4 bytes)
 //    Geometries (variable length)
+//
+// Version 1 (the VERSION_1 property flag is set) is the same as version 0, but a top level collection is followed by a
+// part index, so that a single part can be accessed without walking all the parts before it.
+// Collections with fewer than GEOMETRY_PART_INDEX_MIN_PARTS parts are still written as version 0.
+// -- Part Index
+//    PartOffsets (4 bytes per part, offset of the part from the start of the blob)
+//    PartBounds (16 bytes per part, min x, min y, max x, max y as floats rounded outwards)
+// Because the data before it is always a multiple of 8 bytes, the part index starts at
+// blob size - NumGeometries * 20 bytes.
+//
+// Compressed geometries (the COMPRESSED property flag is set) are described in geometry_compression.cpp.
 
 template <class VERTEX>
 struct GetRequiredSizeOp {
@@ -229,7 +240,7 @@ struct SerializeOp {
 };
 
 template <class V>
-void SerializeTemplated(const Geometry &geom, Cursor &cursor, bool has_bbox, uint32_t bbox_size) {
+void SerializeTemplated(const Geometry &geom, Cursor &cursor, bool has_bbox, uint32_t bbox_size, bool has_part_index) {
 
 	// All geometries except points have a bounding box
 	Box<V> bbox;
@@ -238,8 +249,36 @@ void SerializeTemplated(const Geometry &geom, Cursor &cursor, bool has_bbox, uin
 	auto bbox_ptr = cursor.GetPtr();
 	cursor.Skip(bbox_size);
 
-	// Serialize the geometry
-	Geometry::Match<SerializeOp<V>>(geom, cursor, bbox, 0);
+	if (has_part_index) {
+		// Serialize the parts one by one so that we can record their offsets and bounds
+		// The serialized collection types have the same values as the geometry types
+		const auto part_count = CollectionGeometry::PartCount(geom);
+		cursor.Write<SerializedGeometryType>(static_cast<SerializedGeometryType>(geom.GetType()));
+		cursor.Write<uint32_t>(part_count);
+
+		// The part index is at the end of the blob
+		const auto offsets_ptr = cursor.GetEnd() - part_count * (sizeof(uint32_t) + 4 * sizeof(float));
+		const auto bounds_ptr = offsets_ptr + part_count * sizeof(uint32_t);
+
+		for (uint32_t i = 0; i < part_count; i++) {
+			const auto part_offset = static_cast<uint32_t>(cursor.GetPtr() - cursor.GetStart());
+
+			Box<V> part_bbox;
+			Geometry::Match<SerializeOp<V>>(CollectionGeometry::Part(geom, i), cursor, part_bbox, 1);
+			bbox.Union(part_bbox);
+
+			Store<uint32_t>(part_offset, offsets_ptr + i * sizeof(uint32_t));
+			const auto part_bounds_ptr = bounds_ptr + i * 4 * sizeof(float);
+			Store<float>(MathUtil::DoubleToFloatDown(part_bbox.min.x), part_bounds_ptr);
+			Store<float>(MathUtil::DoubleToFloatDown(part_bbox.min.y), part_bounds_ptr + sizeof(float));
+			Store<float>(MathUtil::DoubleToFloatUp(part_bbox.max.x), part_bounds_ptr + 2 * sizeof(float));
+			Store<float>(MathUtil::DoubleToFloatUp(part_bbox.max.y), part_bounds_ptr + 3 * sizeof(float));
+		}
+		D_ASSERT(cursor.GetPtr() == offsets_ptr);
+	} else {
+		// Serialize the geometry
+		Geometry::Match<SerializeOp<V>>(geom, cursor, bbox, 0);
+	}
 
 	// Now write the bounding box
 	if (has_bbox) {
@@ -260,14 +299,19 @@ void SerializeTemplated(const Geometry &geom, Cursor &cursor, bool has_bbox, uin
 	}
 }
 
-geometry_t Geometry::Serialize(const Geometry &geom, Vector &result) {
+geometry_t Geometry::Serialize(const Geometry &geom, Vector &result, bool write_part_index) {
 	auto type = geom.GetType();
 	bool has_bbox = type != GeometryType::POINT && !Geometry::IsEmpty(geom);
 
+	// Only large collections benefit from the part index, everything else is written in the version 0 format
+	bool has_part_index = write_part_index && GeometryTypes::IsCollection(type) &&
+	                      CollectionGeometry::PartCount(geom) >= GEOMETRY_PART_INDEX_MIN_PARTS;
+
 	auto properties = geom.GetProperties();
 	auto has_z = properties.HasZ();
 	auto has_m = properties.HasM();
 	properties.SetBBox(has_bbox);
+	properties.SetVersion(has_part_index ? 1 : 0);
 
 	uint32_t geom_size = 0;
 	if (has_z && has_m) {
@@ -283,7 +327,8 @@ geometry_t Geometry::Serialize(const Geometry &geom, Vector &result) {
 	auto header_size = 4;
 	auto dims = 2 + (has_z ? 1 : 0) + (has_m ? 1 : 0);
 	auto bbox_size = has_bbox ? (sizeof(float) * 2 * dims) : 0;
-	auto size = header_size + 4 + bbox_size + geom_size; // + 4 for padding, + 16 for bbox
+	auto index_size = has_part_index ? CollectionGeometry::PartCount(geom) * (sizeof(uint32_t) + 4 * sizeof(float)) : 0;
+	auto size = header_size + 4 + bbox_size + geom_size + index_size; // + 4 for padding, + 16 for bbox
 	auto blob = StringVector::EmptyString(result, size);
 
 	Cursor cursor(blob);
@@ -296,13 +341,13 @@ geometry_t Geometry::Serialize(const Geometry &geom, Vector &result) {
 	cursor.Write<uint32_t>(0);
 
 	if (has_z && has_m) {
-		SerializeTemplated<VertexXYZM>(geom, cursor, has_bbox, bbox_size);
+		SerializeTemplated<VertexXYZM>(geom, cursor, has_bbox, bbox_size, has_part_index);
 	} else if (has_z) {
-		SerializeTemplated<VertexXYZ>(geom, cursor, has_bbox, bbox_size);
+		SerializeTemplated<VertexXYZ>(geom, cursor, has_bbox, bbox_size, has_part_index);
 	} else if (has_m) {
-		SerializeTemplated<VertexXYM>(geom, cursor, has_bbox, bbox_size);
+		SerializeTemplated<VertexXYM>(geom, cursor, has_bbox, bbox_size, has_part_index);
 	} else {
-		SerializeTemplated<VertexXY>(geom, cursor, has_bbox, bbox_size);
+		SerializeTemplated<VertexXY>(geom, cursor, has_bbox, bbox_size, has_part_index);
 	}
 
 	blob.Finalize();
@@ -384,13 +429,24 @@ public:
 	Geometry Execute(const geometry_t &data) {
 		return Process(data);
 	}
+	Geometry ExecutePart(const geometry_t &data, const_data_ptr_t part_ptr) {
+		return ProcessPart(data, part_ptr);
+	}
 };
 
 Geometry Geometry::Deserialize(ArenaAllocator &arena, const geometry_t &data) {
+	if (data.GetProperties().IsCompressed()) {
+		return DeserializeCompressed(arena, data);
+	}
 	GeometryDeserializer deserializer(arena);
 	return deserializer.Execute(data);
 }
 
+Geometry Geometry::DeserializePart(ArenaAllocator &arena, const geometry_t &data, const_data_ptr_t part_ptr) {
+	GeometryDeserializer deserializer(arena);
+	return deserializer.ExecutePart(data, part_ptr);
+}
+
 } // namespace core
 
 } // namespace spatial
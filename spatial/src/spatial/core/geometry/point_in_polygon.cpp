@@ -0,0 +1,302 @@
+#include "spatial/common.hpp"
+#include "spatial/core/geometry/bbox.hpp"
+#include "spatial/core/geometry/geometry_part_reader.hpp"
+#include "spatial/core/geometry/point_in_polygon.hpp"
+#include "spatial/core/util/cursor.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//------------------------------------------------------------------------------
+// Orientation
+//------------------------------------------------------------------------------
+// Same filter as GEOS uses before it falls back to extended precision. Returns 1 if (x, y) is to the left of the
+// segment, -1 if it is to the right, 0 if it is on the line and AMBIGUOUS if we can't tell in double precision.
+static constexpr int32_t AMBIGUOUS_ORIENTATION = 2;
+
+static int32_t OrientationIndex(double x1, double y1, double x2, double y2, double x, double y) {
+	static constexpr double DP_SAFE_EPSILON = 1e-15;
+
+	const auto det_left = (x1 - x) * (y2 - y);
+	const auto det_right = (y1 - y) * (x2 - x);
+	const auto det = det_left - det_right;
+	const auto sign = (det > 0) - (det < 0);
+
+	double det_sum;
+	if (det_left > 0) {
+		if (det_right <= 0) {
+			return sign;
+		}
+		det_sum = det_left + det_right;
+	} else if (det_left < 0) {
+		if (det_right >= 0) {
+			return sign;
+		}
+		det_sum = -det_left - det_right;
+	} else {
+		return sign;
+	}
+
+	const auto err_bound = DP_SAFE_EPSILON * det_sum;
+	if (det >= err_bound || -det >= err_bound) {
+		return sign;
+	}
+	return AMBIGUOUS_ORIENTATION;
+}
+
+//------------------------------------------------------------------------------
+// Ring Location
+//------------------------------------------------------------------------------
+// Count the crossings of a ray from the point towards positive x, like the GEOS RayCrossingCounter
+static PointLocation LocateInRing(const_data_ptr_t vertex_data, uint32_t vertex_count, uint32_t vertex_size, double x,
+                                  double y) {
+	if (vertex_count == 0) {
+		return PointLocation::EXTERIOR;
+	}
+
+	idx_t crossings = 0;
+	bool ambiguous = false;
+
+	auto x1 = Load<double>(vertex_data);
+	auto y1 = Load<double>(vertex_data + sizeof(double));
+
+	for (uint32_t i = 1; i < vertex_count; i++) {
+		const auto vertex_ptr = vertex_data + i * vertex_size;
+		const auto x2 = Load<double>(vertex_ptr);
+		const auto y2 = Load<double>(vertex_ptr + sizeof(double));
+
+		// Segments strictly to the left of the point can't cross the ray
+		if (x1 < x && x2 < x) {
+			x1 = x2;
+			y1 = y2;
+			continue;
+		}
+
+		if (x == x2 && y == y2) {
+			return PointLocation::BOUNDARY;
+		}
+
+		// Horizontal segment on the ray
+		if (y1 == y && y2 == y) {
+			if (x >= MinValue(x1, x2) && x <= MaxValue(x1, x2)) {
+				return PointLocation::BOUNDARY;
+			}
+			x1 = x2;
+			y1 = y2;
+			continue;
+		}
+
+		// Segments that straddle the ray, the upper endpoint is exclusive
+		if ((y1 > y && y2 <= y) || (y2 > y && y1 <= y)) {
+			auto orientation = OrientationIndex(x1, y1, x2, y2, x, y);
+			if (orientation == AMBIGUOUS_ORIENTATION) {
+				// Keep going, the point might still be exactly on another segment
+				ambiguous = true;
+			} else if (orientation == 0) {
+				return PointLocation::BOUNDARY;
+			} else {
+				if (y2 < y1) {
+					orientation = -orientation;
+				}
+				if (orientation > 0) {
+					crossings++;
+				}
+			}
+		}
+
+		x1 = x2;
+		y1 = y2;
+	}
+
+	if (ambiguous) {
+		return PointLocation::UNKNOWN;
+	}
+	return crossings % 2 == 1 ? PointLocation::INTERIOR : PointLocation::EXTERIOR;
+}
+
+// Locate the point in a serialized polygon, leaves the cursor at the end of the polygon
+static PointLocation LocateInPolygon(Cursor &cursor, uint32_t vertex_size, double x, double y) {
+	const auto type = cursor.Read<SerializedGeometryType>();
+	if (type != SerializedGeometryType::POLYGON) {
+		return PointLocation::UNKNOWN;
+	}
+
+	const auto ring_count = cursor.Read<uint32_t>();
+	const auto ring_counts_ptr = cursor.GetPtr();
+	cursor.Skip(ring_count * sizeof(uint32_t));
+	if (ring_count % 2 == 1) {
+		cursor.Skip(sizeof(uint32_t)); // padding
+	}
+
+	auto result = PointLocation::INTERIOR;
+	for (uint32_t ring_idx = 0; ring_idx < ring_count; ring_idx++) {
+		const auto vertex_count = Load<uint32_t>(ring_counts_ptr + ring_idx * sizeof(uint32_t));
+		const auto vertex_data = cursor.GetPtr();
+		cursor.Skip(vertex_count * vertex_size);
+
+		if (result != PointLocation::INTERIOR) {
+			// Already decided, but we still need to move past the remaining rings
+			continue;
+		}
+
+		const auto location = LocateInRing(vertex_data, vertex_count, vertex_size, x, y);
+		if (location == PointLocation::UNKNOWN || location == PointLocation::BOUNDARY) {
+			result = location;
+		} else if (ring_idx == 0) {
+			// Outside the shell
+			result = location;
+		} else if (location == PointLocation::INTERIOR) {
+			// Inside a hole
+			result = PointLocation::EXTERIOR;
+		}
+	}
+
+	if (ring_count == 0) {
+		return PointLocation::EXTERIOR;
+	}
+	return result;
+}
+
+PointLocation PointInPolygon::Locate(const geometry_t &point, const geometry_t &polygon) {
+	if (point.GetType() != GeometryType::POINT) {
+		return PointLocation::UNKNOWN;
+	}
+	const auto polygon_type = polygon.GetType();
+	if (polygon_type != GeometryType::POLYGON && polygon_type != GeometryType::MULTIPOLYGON) {
+		return PointLocation::UNKNOWN;
+	}
+	if (polygon.GetProperties().IsCompressed()) {
+		// The vertices have to be decompressed first, let GEOS deal with it
+		return PointLocation::UNKNOWN;
+	}
+
+	Box2D<double> point_bbox;
+	if (!point.TryGetCachedBounds(point_bbox)) {
+		// Empty point
+		return PointLocation::EXTERIOR;
+	}
+	const auto x = point_bbox.min.x;
+	const auto y = point_bbox.min.y;
+
+	// Reject on the cached bounding box first. The bounding box is rounded outwards, so this is conservative.
+	Box2D<double> polygon_bbox;
+	if (!polygon.TryGetCachedBounds(polygon_bbox)) {
+		// Empty polygon
+		return PointLocation::EXTERIOR;
+	}
+	if (!polygon_bbox.Contains(point_bbox.min)) {
+		return PointLocation::EXTERIOR;
+	}
+
+	Cursor cursor(polygon);
+	cursor.Skip(sizeof(GeometryType));
+	const auto properties = cursor.Read<GeometryProperties>();
+	cursor.Skip(sizeof(uint16_t)); // hash
+	cursor.Skip(sizeof(uint32_t)); // padding
+	const auto dims = 2 + (properties.HasZ() ? 1 : 0) + (properties.HasM() ? 1 : 0);
+	if (properties.HasBBox()) {
+		cursor.Skip(sizeof(float) * 2 * dims);
+	}
+	const auto vertex_size = properties.VertexSize();
+
+	if (polygon_type == GeometryType::POLYGON) {
+		return LocateInPolygon(cursor, vertex_size, x, y);
+	}
+
+	// Like GEOS, the point is on the boundary if it is on the boundary of one of the polygons, and otherwise in the
+	// interior if it is in the interior of any of them. If the point is on the boundary of more than one polygon, GEOS
+	// applies the mod-2 boundary rule, let GEOS deal with that.
+	idx_t boundary_count = 0;
+	bool is_interior = false;
+	auto locate_part = [&]() {
+		switch (LocateInPolygon(cursor, vertex_size, x, y)) {
+		case PointLocation::UNKNOWN:
+			return false;
+		case PointLocation::INTERIOR:
+			is_interior = true;
+			break;
+		case PointLocation::BOUNDARY:
+			boundary_count++;
+			break;
+		default:
+			break;
+		}
+		return true;
+	};
+
+	GeometryPartReader reader(polygon);
+	if (reader.HasPartIndex()) {
+		// Only look at the polygons whose bounds contain the point
+		for (uint32_t part_idx = 0; part_idx < reader.PartCount(); part_idx++) {
+			Box2D<double> part_bbox;
+			reader.TryGetPartBounds(part_idx, part_bbox);
+			if (!part_bbox.Contains(point_bbox.min)) {
+				continue;
+			}
+			cursor.SetPtr(const_cast<data_ptr_t>(reader.GetPart(part_idx)));
+			if (!locate_part()) {
+				return PointLocation::UNKNOWN;
+			}
+		}
+	} else {
+		const auto type = cursor.Read<SerializedGeometryType>();
+		if (type != SerializedGeometryType::MULTIPOLYGON) {
+			return PointLocation::UNKNOWN;
+		}
+		const auto part_count = cursor.Read<uint32_t>();
+		for (uint32_t part_idx = 0; part_idx < part_count; part_idx++) {
+			if (!locate_part()) {
+				return PointLocation::UNKNOWN;
+			}
+		}
+	}
+
+	if (boundary_count > 1) {
+		return PointLocation::UNKNOWN;
+	}
+	if (boundary_count == 1) {
+		return PointLocation::BOUNDARY;
+	}
+	return is_interior ? PointLocation::INTERIOR : PointLocation::EXTERIOR;
+}
+
+//------------------------------------------------------------------------------
+// Predicates
+//------------------------------------------------------------------------------
+bool PointInPolygon::TryContains(const geometry_t &polygon, const geometry_t &point, bool &result) {
+	const auto location = Locate(point, polygon);
+	if (location == PointLocation::UNKNOWN) {
+		return false;
+	}
+	result = location == PointLocation::INTERIOR;
+	return true;
+}
+
+bool PointInPolygon::TryWithin(const geometry_t &point, const geometry_t &polygon, bool &result) {
+	return TryContains(polygon, point, result);
+}
+
+bool PointInPolygon::TryCovers(const geometry_t &polygon, const geometry_t &point, bool &result) {
+	const auto location = Locate(point, polygon);
+	if (location == PointLocation::UNKNOWN) {
+		return false;
+	}
+	result = location != PointLocation::EXTERIOR;
+	return true;
+}
+
+bool PointInPolygon::TryCoveredBy(const geometry_t &point, const geometry_t &polygon, bool &result) {
+	return TryCovers(polygon, point, result);
+}
+
+bool PointInPolygon::TryIntersects(const geometry_t &left, const geometry_t &right, bool &result) {
+	if (left.GetType() == GeometryType::POINT) {
+		return TryCovers(right, left, result);
+	}
+	return TryCovers(left, right, result);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -1,5 +1,9 @@
 #include "spatial/core/index/rtree/rtree.hpp"
 #include "duckdb/common/printer.hpp"
+#include "spatial/core/util/hilbert.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace spatial {
 
@@ -72,11 +76,12 @@ void RTree::Free(RTreePointer &pointer) {
 //------------------------------------------------------------------------------
 // Split
 //------------------------------------------------------------------------------
-void RTree::RebalanceSplitNodes(RTreeNode &src, RTreeNode &dst, bool split_axis, PointXY<float> &split_point) const {
+void RTree::RebalanceSplitNodes(RTreeNode &src, RTreeNode &dst, idx_t min_capacity, bool split_axis,
+                                PointXY<float> &split_point) const {
 	D_ASSERT(src.GetCount() > dst.GetCount());
 
 	// How many entries to we need to move until we have the minimum capacity?
-	const auto remaining = config.min_node_capacity - dst.GetCount();
+	const auto remaining = min_capacity - dst.GetCount();
 
 	// Setup a min heap to keep track of the entries that are closest to the split point
 	vector<pair<float, idx_t>> diff_heap;
@@ -115,8 +120,11 @@ void RTree::RebalanceSplitNodes(RTreeNode &src, RTreeNode &dst, bool split_axis,
 
 RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 
+	const auto max_capacity = config.GetMaxCapacity(entry.pointer.GetType());
+	const auto min_capacity = config.GetMinCapacity(entry.pointer.GetType());
+
 	auto &left_node = RefMutable(entry.pointer);
-	D_ASSERT(left_node.GetCount() == config.max_node_capacity);
+	D_ASSERT(left_node.GetCount() == max_capacity);
 
 	/*
 	 *  C1 | C2
@@ -134,11 +142,11 @@ RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 
 	idx_t q_counts[4] = {0, 0, 0, 0};
 	RTreeBounds q_bounds[4];
-	const auto q_assign = make_unsafe_uniq_array<uint8_t>(config.max_node_capacity);
+	const auto q_assign = make_unsafe_uniq_array<uint8_t>(max_capacity);
 	uint8_t q_node[4] = {0, 0, 0, 0};
 
 	// Figure out which quadrant each entry in the node belongs to
-	for (idx_t i = 0; i < config.max_node_capacity; i++) {
+	for (idx_t i = 0; i < max_capacity; i++) {
 		auto child_center = left_node[i].bounds.Center();
 		auto found = false;
 		for (idx_t q_idx = 0; q_idx < 4; q_idx++) {
@@ -156,8 +164,8 @@ RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 
 	// Create a temporary node for the first split
 	// Create a buffer to hold all the entries we are going to move
-	const auto entry_buffer = make_unsafe_uniq_array<RTreeEntry>(config.max_node_capacity);
-	for (idx_t i = 0; i < config.max_node_capacity; i++) {
+	const auto entry_buffer = make_unsafe_uniq_array<RTreeEntry>(max_capacity);
+	for (idx_t i = 0; i < max_capacity; i++) {
 		entry_buffer[i] = left_node[i];
 	}
 	left_node.Clear();
@@ -221,7 +229,7 @@ RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 	}
 
 	// Distribute the entries to the two nodes
-	for (idx_t i = 0; i < config.max_node_capacity; i++) {
+	for (idx_t i = 0; i < max_capacity; i++) {
 		const auto q_idx = q_assign[i];
 		const auto n_idx = q_node[q_idx];
 		auto &dst = node_ref[n_idx];
@@ -240,14 +248,14 @@ RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 
 	// If one of the nodes have less than the minimum capacity, we need to move entries from the other node
 	// but do so by moving the entries that are closest to the splitting line
-	if (left_node.GetCount() < config.min_node_capacity) {
-		RebalanceSplitNodes(right_node, left_node, perp_split_axis, center);
-	} else if (right_node.GetCount() < config.min_node_capacity) {
-		RebalanceSplitNodes(left_node, right_node, perp_split_axis, center);
+	if (left_node.GetCount() < min_capacity) {
+		RebalanceSplitNodes(right_node, left_node, min_capacity, perp_split_axis, center);
+	} else if (right_node.GetCount() < min_capacity) {
+		RebalanceSplitNodes(left_node, right_node, min_capacity, perp_split_axis, center);
 	}
 
-	D_ASSERT(left_node.GetCount() >= config.min_node_capacity);
-	D_ASSERT(right_node.GetCount() >= config.min_node_capacity);
+	D_ASSERT(left_node.GetCount() >= min_capacity);
+	D_ASSERT(right_node.GetCount() >= min_capacity);
 
 	// TODO: Reuse q_bounds if we didnt have to rebalance the nodes
 	entry.bounds = left_node.GetBounds();
@@ -263,8 +271,8 @@ RTreeEntry RTree::SplitNode(RTreeEntry &entry) const {
 		right_node.SortEntriesByRowId();
 	}
 
-	left_node.Verify(config.max_node_capacity);
-	right_node.Verify(config.max_node_capacity);
+	left_node.Verify(max_capacity);
+	right_node.Verify(max_capacity);
 
 	// Return a new entry for the second node
 	return RTreeEntry {right_ptr, right_node.GetBounds()};
@@ -312,7 +320,7 @@ InsertResult RTree::LeafInsert(RTreeEntry &entry, const RTreeEntry &new_entry) {
 	auto &node = RefMutable(entry.pointer);
 
 	// Is this leaf full?
-	if (node.GetCount() == config.max_node_capacity) {
+	if (node.GetCount() == config.max_leaf_capacity) {
 		return InsertResult {true, false};
 	}
 	// Otherwise, insert at the end
@@ -412,6 +420,122 @@ void RTree::RootInsert(RTreeEntry &root_entry, const RTreeEntry &new_entry) {
 	}
 }
 
+//------------------------------------------------------------------------------
+// Batch Insert
+//------------------------------------------------------------------------------
+void RTree::Insert(vector<RTreeEntry> &entries) {
+	if (entries.empty()) {
+		return;
+	}
+
+	// Compute the bounds of the batch
+	RTreeBounds bounds;
+	for (auto &entry : entries) {
+		bounds.Union(entry.bounds);
+	}
+
+	// Map the center of every entry onto a hilbert curve covering the batch
+	constexpr auto max_hilbert = static_cast<double>(std::numeric_limits<uint16_t>::max());
+	const auto width = static_cast<double>(bounds.max.x) - static_cast<double>(bounds.min.x);
+	const auto height = static_cast<double>(bounds.max.y) - static_cast<double>(bounds.min.y);
+	const auto scale_x = width > 0 ? max_hilbert / width : 0;
+	const auto scale_y = height > 0 ? max_hilbert / height : 0;
+
+	vector<pair<uint32_t, idx_t>> keys;
+	keys.reserve(entries.size());
+	for (idx_t i = 0; i < entries.size(); i++) {
+		auto &entry_bounds = entries[i].bounds;
+		const auto cx = (static_cast<double>(entry_bounds.min.x) + static_cast<double>(entry_bounds.max.x)) / 2;
+		const auto cy = (static_cast<double>(entry_bounds.min.y) + static_cast<double>(entry_bounds.max.y)) / 2;
+		const auto hx = static_cast<uint32_t>((cx - bounds.min.x) * scale_x);
+		const auto hy = static_cast<uint32_t>((cy - bounds.min.y) * scale_y);
+		keys.emplace_back(HilbertEncode(16, hx, hy), i);
+	}
+	std::sort(keys.begin(), keys.end());
+
+	for (auto &key : keys) {
+		RootInsert(root, entries[key.second]);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Bulk Load
+//------------------------------------------------------------------------------
+// Sort-tile-recursive packing: the entries are sorted by the x-coordinate of their centers and cut into vertical
+// slices, each slice is sorted by the y-coordinate and packed into full nodes. The layers above are packed the same way.
+idx_t RTree::GetSliceSize(idx_t layer_size, idx_t capacity) {
+	// The square root of the number of nodes in the layer, rounded up, times the capacity of a node
+	const auto node_count = (layer_size + capacity - 1) / capacity;
+	return ExactNumericCast<idx_t>(std::ceil(std::sqrt(static_cast<double>(node_count)))) * capacity;
+}
+
+void RTree::SortSlice(RTreeEntry *begin, RTreeEntry *end) {
+	std::sort(begin, end, [&](const RTreeEntry &a, const RTreeEntry &b) {
+		return a.bounds.Center().y < b.bounds.Center().y;
+	});
+}
+
+void RTree::PackSlice(RTreeNodeType node_type, const RTreeEntry *begin, const RTreeEntry *end,
+                      vector<RTreeEntry> &result) const {
+	const auto capacity = config.GetMaxCapacity(node_type);
+	while (begin != end) {
+		const auto node_ptr = MakePage(node_type);
+		auto &node = RefMutable(node_ptr);
+
+		const auto count = MinValue<idx_t>(capacity, end - begin);
+		for (idx_t i = 0; i < count; i++) {
+			node.PushEntry(*begin++);
+		}
+		if (node_type == RTreeNodeType::LEAF_PAGE) {
+			// If the node is a leaf node, sort it by row id
+			node.SortEntriesByRowId();
+		}
+		node.Verify(capacity);
+
+		result.emplace_back(node_ptr, node.GetBounds());
+	}
+}
+
+void RTree::PackBranches(vector<RTreeEntry> &layer) {
+	D_ASSERT(!layer.empty());
+	vector<RTreeEntry> next_layer;
+	while (layer.size() != 1) {
+		const auto slice_size = GetSliceSize(layer.size(), config.max_node_capacity);
+		for (idx_t slice_offset = 0; slice_offset < layer.size(); slice_offset += slice_size) {
+			const auto slice_begin = layer.data() + slice_offset;
+			const auto slice_end = slice_begin + MinValue<idx_t>(slice_size, layer.size() - slice_offset);
+			SortSlice(slice_begin, slice_end);
+			PackSlice(RTreeNodeType::BRANCH_PAGE, slice_begin, slice_end, next_layer);
+		}
+		std::swap(layer, next_layer);
+		next_layer.clear();
+	}
+
+	D_ASSERT(layer[0].pointer.IsPage());
+	SetRoot(layer[0]);
+}
+
+void RTree::BulkLoad(vector<RTreeEntry> &entries) {
+	D_ASSERT(!root.pointer.IsSet());
+	if (entries.empty()) {
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end(), [&](const RTreeEntry &a, const RTreeEntry &b) {
+		return a.bounds.Center().x < b.bounds.Center().x;
+	});
+
+	vector<RTreeEntry> leaves;
+	const auto slice_size = GetSliceSize(entries.size(), config.max_leaf_capacity);
+	for (idx_t slice_offset = 0; slice_offset < entries.size(); slice_offset += slice_size) {
+		const auto slice_begin = entries.data() + slice_offset;
+		const auto slice_end = slice_begin + MinValue<idx_t>(slice_size, entries.size() - slice_offset);
+		SortSlice(slice_begin, slice_end);
+		PackSlice(RTreeNodeType::LEAF_PAGE, slice_begin, slice_end, leaves);
+	}
+	PackBranches(leaves);
+}
+
 //------------------------------------------------------------------------------
 // Delete
 //------------------------------------------------------------------------------
@@ -512,7 +636,7 @@ DeleteResult RTree::LeafDelete(RTreeEntry &entry, const RTreeEntry &target, vect
 	D_ASSERT(child.pointer.IsRowId());
 
 	// If we remove the entry, will this node now have too few children?
-	if (node.GetCount() - 1 < config.min_node_capacity) {
+	if (node.GetCount() - 1 < config.min_leaf_capacity) {
 		// Yes, orphan all children and signal that this node should be removed
 
 		// But first, remove the actual entry. We dont care about preserving the order here
@@ -521,7 +645,7 @@ DeleteResult RTree::LeafDelete(RTreeEntry &entry, const RTreeEntry &target, vect
 
 		orphans.insert(orphans.end(), node.begin(), node.end());
 		node.Clear();
-		node.Verify(config.max_node_capacity);
+		node.Verify(config.max_leaf_capacity);
 		return {true, true, true};
 	}
 
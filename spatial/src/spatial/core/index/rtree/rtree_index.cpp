@@ -10,6 +10,9 @@
 #include "spatial/core/index/rtree/rtree_node.hpp"
 #include "spatial/core/util/math.hpp"
 
+#include <functional>
+#include <queue>
+
 namespace spatial {
 
 namespace core {
@@ -27,6 +30,28 @@ public:
 // RTree Configuration
 //------------------------------------------------------------------------------
 
+static idx_t ParseMinCapacity(const case_insensitive_map_t<Value> &options, const char *name, idx_t max_capacity,
+                              double min_fill, idx_t default_min_capacity) {
+	const auto search = options.find(name);
+	if (search != options.end()) {
+		const auto val = search->second.GetValue<int32_t>();
+		if (val < 0) {
+			throw InvalidInputException("RTree: %s must be at least 0", name);
+		}
+		if (UnsafeNumericCast<idx_t>(val) > max_capacity / 2) {
+			throw InvalidInputException("RTree: %s must be at most '%s / 2'", name,
+			                            StringUtil::Replace(name, "min_", "max_"));
+		}
+		return UnsafeNumericCast<idx_t>(val);
+	}
+	if (min_fill < 0) {
+		return default_min_capacity;
+	}
+	// Never exceed half the capacity, or we can't split a full node in two
+	return MinValue<idx_t>(static_cast<idx_t>(std::ceil(static_cast<double>(max_capacity) * min_fill)),
+	                       max_capacity / 2);
+}
+
 static RTreeConfig ParseOptions(const case_insensitive_map_t<Value> &options) {
 	RTreeConfig config = {};
 
@@ -42,26 +67,73 @@ static RTreeConfig ParseOptions(const case_insensitive_map_t<Value> &options) {
 		config.max_node_capacity = UnsafeNumericCast<idx_t>(val);
 	}
 
-	const auto min_cap_search = options.find("min_node_capacity");
-	if (min_cap_search != options.end()) {
-		const auto val = min_cap_search->second.GetValue<int32_t>();
-		if (val < 0) {
-			throw InvalidInputException("RTree: min_node_capacity must be at least 0");
+	// Leaves default to the same capacity as the branch nodes. Leaves are not limited to 255 entries, they are only
+	// bound by the segment size of the allocator (which is checked when the index is created).
+	config.max_leaf_capacity = config.max_node_capacity;
+	const auto max_leaf_search = options.find("max_leaf_capacity");
+	if (max_leaf_search != options.end()) {
+		const auto val = max_leaf_search->second.GetValue<int32_t>();
+		if (val < 4) {
+			throw InvalidInputException("RTree: max_leaf_capacity must be at least 4");
 		}
-		if (val > config.max_node_capacity / 2) {
-			throw InvalidInputException("RTree: min_node_capacity must be at most 'max_node_capacity / 2'");
+		config.max_leaf_capacity = UnsafeNumericCast<idx_t>(val);
+	}
+
+	// The minimum fill factor of a node, as a fraction of its capacity
+	auto min_fill = -1.0;
+	const auto min_fill_search = options.find("min_fill");
+	if (min_fill_search != options.end()) {
+		min_fill = min_fill_search->second.GetValue<double>();
+		if (min_fill < 0 || min_fill > 0.5) {
+			throw InvalidInputException("RTree: min_fill must be between 0 and 0.5");
 		}
-		config.min_node_capacity = UnsafeNumericCast<idx_t>(val);
-	} else {
+	} else if (max_cap_param_search != options.end() || max_leaf_search != options.end()) {
 		// If no min capacity is set, set it to 40% of the max capacity
-		if (max_cap_param_search != options.end()) {
-			config.min_node_capacity = std::ceil(static_cast<double>(config.max_node_capacity) * 0.4);
-		}
+		min_fill = 0.4;
 	}
 
+	config.min_node_capacity =
+	    ParseMinCapacity(options, "min_node_capacity", config.max_node_capacity, min_fill, config.min_node_capacity);
+	config.min_leaf_capacity =
+	    ParseMinCapacity(options, "min_leaf_capacity", config.max_leaf_capacity, min_fill, config.min_leaf_capacity);
+
 	return config;
 }
 
+// Store the configuration in the index options, so that it is persisted together with the index
+static void StoreOptions(const RTreeConfig &config, case_insensitive_map_t<Value> &options) {
+	options["max_node_capacity"] = Value::INTEGER(NumericCast<int32_t>(config.max_node_capacity));
+	options["min_node_capacity"] = Value::INTEGER(NumericCast<int32_t>(config.min_node_capacity));
+	options["max_leaf_capacity"] = Value::INTEGER(NumericCast<int32_t>(config.max_leaf_capacity));
+	options["min_leaf_capacity"] = Value::INTEGER(NumericCast<int32_t>(config.min_leaf_capacity));
+}
+
+// The rows with an EMPTY geometry are not part of the tree, they are persisted with the options as well
+static constexpr const char *EMPTY_ROWS_OPTION = "empty_row_ids";
+
+static void StoreEmptyRows(const set<row_t> &empty_rows, case_insensitive_map_t<Value> &options) {
+	if (empty_rows.empty()) {
+		options.erase(EMPTY_ROWS_OPTION);
+		return;
+	}
+	vector<Value> values;
+	values.reserve(empty_rows.size());
+	for (const auto &row_id : empty_rows) {
+		values.push_back(Value::BIGINT(row_id));
+	}
+	options[EMPTY_ROWS_OPTION] = Value::LIST(LogicalType::BIGINT, std::move(values));
+}
+
+static void LoadEmptyRows(const case_insensitive_map_t<Value> &options, set<row_t> &empty_rows) {
+	const auto search = options.find(EMPTY_ROWS_OPTION);
+	if (search == options.end()) {
+		return;
+	}
+	for (const auto &value : ListValue::GetChildren(search->second)) {
+		empty_rows.insert(value.GetValue<int64_t>());
+	}
+}
+
 //------------------------------------------------------------------------------
 // RTreeIndex Methods
 //------------------------------------------------------------------------------
@@ -78,17 +150,22 @@ RTreeIndex::RTreeIndex(const string &name, IndexConstraintType index_constraint_
 		throw NotImplementedException("RTree indexes do not support unique or primary key constraints");
 	}
 
-	// Create the configuration from the options
-	RTreeConfig config = ParseOptions(options);
+	// Create the configuration from the options. Indexes loaded from storage carry their configuration in the
+	// storage info, older databases don't, in which case they were created with the options.
+	const auto has_stored_options = info.IsValid() && info.options.find("max_node_capacity") != info.options.end();
+	RTreeConfig config = ParseOptions(has_stored_options ? info.options : options);
 
 	// Create the RTree
 	auto &block_manager = table_io_manager.GetIndexBlockManager();
 
+	// The FixedSizeAllocator needs room for at least one segment and its validity mask in every buffer
 	const auto max_alloc_size = block_manager.GetBlockSize() - sizeof(validity_t);
 	if (config.GetNodeByteSize() > max_alloc_size || config.GetLeafByteSize() > max_alloc_size) {
+		const auto max_capacity = (max_alloc_size - sizeof(RTreeNode)) / sizeof(RTreeEntry);
 		throw InvalidInputException("Cannot instantiate RTree index: The node and/or leaf capacity of RTree index '%s' "
-		                            "is too large to fit within the configured block size of this database",
-		                            name);
+		                            "is too large to fit within the configured block size of this database "
+		                            "(the maximum capacity is %llu)",
+		                            name, max_capacity);
 	}
 
 	tree = make_uniq<RTree>(block_manager, config);
@@ -100,6 +177,7 @@ RTreeIndex::RTreeIndex(const string &name, IndexConstraintType index_constraint_
 		tree->GetNodeAllocator().Init(info.allocator_infos[1]);
 		// Set the root node and recalculate the bounds
 		tree->SetRoot(info.root);
+		LoadEmptyRows(info.options, empty_rows);
 	}
 }
 
@@ -113,34 +191,154 @@ unique_ptr<IndexScanState> RTreeIndex::InitializeScan(const RTreeBounds &query)
 	return std::move(state);
 }
 
+unique_ptr<IndexScanState> RTreeIndex::InitializeScan(const RTreeBounds &query, const RTreeEntry &subtree) const {
+	D_ASSERT(subtree.pointer.IsPage());
+	auto state = make_uniq<RTreeIndexScanState>();
+	state->query_bounds = query;
+	if (state->query_bounds.Intersects(subtree.bounds)) {
+		state->scanner.Init(subtree);
+	}
+	return std::move(state);
+}
+
+void RTreeIndex::PartitionScan(const RTreeBounds &query, idx_t target_count, vector<RTreeEntry> &result) const {
+	result.clear();
+
+	auto &root = tree->GetRoot();
+	if (!root.pointer.IsSet() || !query.Intersects(root.bounds)) {
+		return;
+	}
+	result.push_back(root);
+
+	// Expand the frontier one level at a time until we either have enough subtrees, or only leaves are left.
+	// Expanding each level left-to-right preserves the order in which a depth-first scan would visit the rowids.
+	vector<RTreeEntry> next;
+	while (result.size() < target_count) {
+		bool expanded = false;
+		next.clear();
+		for (auto &entry : result) {
+			if (!entry.pointer.IsBranchPage()) {
+				next.push_back(entry);
+				continue;
+			}
+			auto &node = tree->Ref(entry.pointer);
+			for (auto &child : node) {
+				if (query.Intersects(child.bounds)) {
+					next.push_back(child);
+				}
+			}
+			expanded = true;
+		}
+		if (!expanded) {
+			// Only leaves left, we cant split any further
+			break;
+		}
+		std::swap(result, next);
+	}
+}
+
 idx_t RTreeIndex::Scan(IndexScanState &state, Vector &result) const {
+	return Scan(state, FlatVector::GetData<row_t>(result), STANDARD_VECTOR_SIZE);
+}
+
+idx_t RTreeIndex::Scan(IndexScanState &state, row_t *row_ids, const idx_t capacity) const {
 	auto &sstate = state.Cast<RTreeIndexScanState>();
-	const auto row_ids = FlatVector::GetData<row_t>(result);
+	if (capacity == 0) {
+		return 0;
+	}
+
+	idx_t output_idx = 0;
+	sstate.scanner.ScanIntersecting(*tree, sstate.query_bounds, [&](const RTreeEntry &entry) {
+		D_ASSERT(entry.pointer.IsRowId());
+		row_ids[output_idx++] = entry.pointer.GetRowId();
+		// Have we filled the result buffer?
+		return output_idx == capacity;
+	});
+	return output_idx;
+}
+
+//------------------------------------------------------------------------------
+// KNN Search
+//------------------------------------------------------------------------------
+// The squared distance from the point to the closest point of the box
+static double MinDistanceSquared(const PointXY<double> &point, const RTreeBounds &bounds) {
+	const auto dx = MaxValue(MaxValue(bounds.min.x - point.x, point.x - bounds.max.x), 0.0);
+	const auto dy = MaxValue(MaxValue(bounds.min.y - point.y, point.y - bounds.max.y), 0.0);
+	return dx * dx + dy * dy;
+}
+
+// The squared distance from the point to the farthest point of the box
+static double MaxDistanceSquared(const PointXY<double> &point, const RTreeBounds &bounds) {
+	const auto dx = MaxValue(std::abs(point.x - bounds.min.x), std::abs(point.x - bounds.max.x));
+	const auto dy = MaxValue(std::abs(point.y - bounds.min.y), std::abs(point.y - bounds.max.y));
+	return dx * dx + dy * dy;
+}
+
+// The entries left to visit in a KNN search, closest first
+struct RTreeKNNQueueEntry {
+	double min_distance;
+	RTreeEntry entry;
+
+	RTreeKNNQueueEntry(double min_distance, const RTreeEntry &entry) : min_distance(min_distance), entry(entry) {
+	}
+
+	bool operator>(const RTreeKNNQueueEntry &other) const {
+		return min_distance > other.min_distance;
+	}
+};
+
+class RTreeIndexKNNScanState final : public IndexScanState {
+public:
+	PointXY<double> query;
+	std::priority_queue<RTreeKNNQueueEntry, vector<RTreeKNNQueueEntry>, std::greater<RTreeKNNQueueEntry>> queue;
+};
+
+unique_ptr<IndexScanState> RTreeIndex::InitializeKNNScan(const PointXY<double> &query) const {
+	auto state = make_uniq<RTreeIndexKNNScanState>();
+	state->query = query;
+	auto &root = tree->GetRoot();
+	if (root.pointer.IsSet()) {
+		state->queue.emplace(MinDistanceSquared(query, root.bounds), root);
+	}
+	return std::move(state);
+}
+
+idx_t RTreeIndex::KNNScan(IndexScanState &state, const double max_distance, row_t *row_ids,
+                          double *row_max_distances, const idx_t capacity) const {
+	auto &kstate = state.Cast<RTreeIndexKNNScanState>();
+	auto &queue = kstate.queue;
 
 	idx_t output_idx = 0;
-	sstate.scanner.Scan(*tree, [&](const RTreeEntry &entry, const idx_t &) {
-		// Does this entry intersect with the query bounds?
-		if (!sstate.query_bounds.Intersects(entry.bounds)) {
-			// No, skip it
-			return RTreeScanResult::SKIP;
+	while (output_idx < capacity && !queue.empty()) {
+		const auto top = queue.top();
+		if (top.min_distance > max_distance) {
+			// Everything left in the queue is too far away
+			break;
 		}
-		// Is this a row id?
-		if (entry.pointer.IsRowId()) {
-			row_ids[output_idx++] = entry.pointer.GetRowId();
-			// Have we filled the result vector?
-			if (output_idx == STANDARD_VECTOR_SIZE) {
-				return RTreeScanResult::YIELD;
+		queue.pop();
+
+		if (top.entry.pointer.IsRowId()) {
+			row_ids[output_idx] = top.entry.pointer.GetRowId();
+			row_max_distances[output_idx] = MaxDistanceSquared(kstate.query, top.entry.bounds);
+			output_idx++;
+			continue;
+		}
+
+		auto &node = tree->Ref(top.entry.pointer);
+		for (auto &child : node) {
+			const auto min_distance = MinDistanceSquared(kstate.query, child.bounds);
+			if (min_distance <= max_distance) {
+				queue.emplace(min_distance, child);
 			}
 		}
-		// Continue scanning
-		return RTreeScanResult::CONTINUE;
-	});
+	}
 	return output_idx;
 }
 
 void RTreeIndex::CommitDrop(IndexLock &index_lock) {
 	// TODO: Maybe we can drop these much earlier?
 	tree->Reset();
+	empty_rows.clear();
 }
 
 ErrorData RTreeIndex::Insert(IndexLock &lock, DataChunk &input, Vector &rowid_vec) {
@@ -155,12 +353,11 @@ ErrorData RTreeIndex::Insert(IndexLock &lock, DataChunk &input, Vector &rowid_ve
 		return ErrorData {};
 	}
 
-	RTreeEntry entry_buffer[STANDARD_VECTOR_SIZE];
-	bool valid_buffer[STANDARD_VECTOR_SIZE];
+	vector<RTreeEntry> entries;
+	entries.reserve(input.size());
 
 	for (idx_t i = 0; i < input.size(); i++) {
 		if (FlatVector::IsNull(geom_vec, i) || FlatVector::IsNull(rowid_vec, i)) {
-			valid_buffer[i] = false;
 			continue;
 		}
 
@@ -168,7 +365,8 @@ ErrorData RTreeIndex::Insert(IndexLock &lock, DataChunk &input, Vector &rowid_ve
 
 		Box2D<double> box_2d;
 		if (!geom_data[i].TryGetCachedBounds(box_2d)) {
-			valid_buffer[i] = false;
+			// EMPTY geometries have no bounds
+			empty_rows.insert(rowid);
 			continue;
 		}
 
@@ -178,20 +376,11 @@ ErrorData RTreeIndex::Insert(IndexLock &lock, DataChunk &input, Vector &rowid_ve
 		bbox.max.x = MathUtil::DoubleToFloatUp(box_2d.max.x);
 		bbox.max.y = MathUtil::DoubleToFloatUp(box_2d.max.y);
 
-		entry_buffer[i] = {RTree::MakeRowId(rowid), bbox};
-		valid_buffer[i] = true;
+		entries.emplace_back(RTree::MakeRowId(rowid), bbox);
 	}
 
-	// TODO: Investigate this more, is there a better way to insert multiple entries
-	// so that they produce a better tree?
-	// E.g. sort by x coordinate, or hilbert sort? or STR packing?
-	// Or insert by smallest first? or largest first?
-	// Or even create a separate subtree entirely, and then insert that into the root?
-	for (idx_t i = 0; i < input.size(); i++) {
-		if (valid_buffer[i]) {
-			tree->Insert(entry_buffer[i]);
-		}
-	}
+	// Insert the whole chunk at once, in hilbert order
+	tree->Insert(entries);
 
 	return ErrorData {};
 }
@@ -237,6 +426,7 @@ void RTreeIndex::Delete(IndexLock &lock, DataChunk &input, Vector &rowid_vec) {
 
 		Box2D<double> raw_bounds;
 		if (!geom.TryGetCachedBounds(raw_bounds)) {
+			empty_rows.erase(rowid);
 			continue;
 		}
 
@@ -275,6 +465,9 @@ IndexStorageInfo RTreeIndex::GetStorageInfo(const case_insensitive_map_t<Value>
 	info.allocator_infos.push_back(leaf_allocator.GetInfo());
 	info.allocator_infos.push_back(node_allocator.GetInfo());
 
+	StoreOptions(tree->GetConfig(), info.options);
+	StoreEmptyRows(empty_rows, info.options);
+
 	return info;
 }
 
@@ -284,8 +477,43 @@ idx_t RTreeIndex::GetInMemorySize(IndexLock &state) {
 	return leaf_alloc.GetInMemorySize() + node_alloc.GetInMemorySize();
 }
 
+// Collect the row entries of a tree
+static void CollectRows(const RTree &tree, vector<RTreeEntry> &result) {
+	auto &root = tree.GetRoot();
+	if (!root.pointer.IsSet()) {
+		return;
+	}
+	vector<RTreeEntry> stack;
+	stack.push_back(root);
+	while (!stack.empty()) {
+		const auto entry = stack.back();
+		stack.pop_back();
+		if (entry.pointer.IsRowId()) {
+			result.push_back(entry);
+			continue;
+		}
+		for (auto &child : tree.Ref(entry.pointer)) {
+			stack.push_back(child);
+		}
+	}
+}
+
 bool RTreeIndex::MergeIndexes(IndexLock &state, BoundIndex &other_index) {
-	throw NotImplementedException("RTreeIndex::MergeIndexes() not implemented");
+	auto &other = other_index.Cast<RTreeIndex>();
+
+	// The trees live in different allocators, so the nodes of the other tree can't be grafted into this one.
+	// Instead, the rows of both trees are packed into a new tree, sorted over all of them at once.
+	vector<RTreeEntry> entries;
+	CollectRows(*tree, entries);
+	CollectRows(*other.tree, entries);
+
+	tree->Reset();
+	tree->BulkLoad(entries);
+	other.tree->Reset();
+
+	empty_rows.insert(other.empty_rows.begin(), other.empty_rows.end());
+	other.empty_rows.clear();
+	return true;
 }
 
 void RTreeIndex::Vacuum(IndexLock &state) {
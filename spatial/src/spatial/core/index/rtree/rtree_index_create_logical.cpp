@@ -50,27 +50,10 @@ static unique_ptr<PhysicalOperator> CreateNullFilter(const LogicalCreateRTreeInd
 	auto is_not_null_expr =
 	    make_uniq<BoundOperatorExpression>(ExpressionType::OPERATOR_IS_NOT_NULL, LogicalType::BOOLEAN);
 	auto bound_ref = make_uniq<BoundReferenceExpression>(types[0], 0);
-	is_not_null_expr->children.push_back(bound_ref->Copy());
+	is_not_null_expr->children.push_back(std::move(bound_ref));
 
-	// Filter IS_NOT_EMPTY on the GEOMETRY column
-	auto &catalog = Catalog::GetSystemCatalog(context);
-	auto &is_empty_entry = catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "ST_IsEmpty")
-	                           .Cast<ScalarFunctionCatalogEntry>();
-
-	auto is_empty_func = is_empty_entry.functions.GetFunctionByArguments(context, {GeoTypes::GEOMETRY()});
-	vector<unique_ptr<Expression>> is_empty_args;
-	is_empty_args.push_back(std::move(bound_ref));
-	auto is_empty_expr = make_uniq_base<Expression, BoundFunctionExpression>(LogicalType::BOOLEAN, is_empty_func,
-	                                                                         std::move(is_empty_args), nullptr);
-
-	auto is_not_empty_expr = make_uniq<BoundOperatorExpression>(ExpressionType::OPERATOR_NOT, LogicalType::BOOLEAN);
-	is_not_empty_expr->children.push_back(std::move(is_empty_expr));
-
-	// Combine into an AND
-	auto and_expr = make_uniq_base<Expression, BoundConjunctionExpression>(
-	    ExpressionType::CONJUNCTION_AND, std::move(is_not_null_expr), std::move(is_not_empty_expr));
-
-	filter_select_list.push_back(std::move(and_expr));
+	// EMPTY geometries are let through, they have no bounds and are recorded by the index outside of the tree
+	filter_select_list.push_back(std::move(is_not_null_expr));
 
 	return make_uniq<PhysicalFilter>(types, std::move(filter_select_list), op.estimated_cardinality);
 }
@@ -192,7 +175,7 @@ unique_ptr<PhysicalOperator> LogicalCreateRTreeIndex::CreatePlan(ClientContext &
 	auto projection = make_uniq<PhysicalProjection>(new_column_types, std::move(select_list), op.estimated_cardinality);
 	projection->children.push_back(std::move(table_scan));
 
-	// Filter operator for (IS_NOT_NULL) and (NOT ST_IsEmpty) on the geometry column
+	// Filter operator for (IS_NOT_NULL) on the geometry column
 	auto null_filter = CreateNullFilter(op, new_column_types, context);
 	null_filter->children.push_back(std::move(projection));
 
@@ -13,6 +13,7 @@
 
 #include "duckdb/common/sort/sort.hpp"
 #include "duckdb/parallel/base_pipeline_event.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 namespace spatial {
 
@@ -38,42 +39,47 @@ PhysicalCreateRTreeIndex::PhysicalCreateRTreeIndex(LogicalOperator &op, TableCat
 //-------------------------------------------------------------
 // Global State
 //-------------------------------------------------------------
+// The RTree is bulk loaded using sort-tile-recursive (STR) packing. The input arrives sorted by the x-coordinate
+// of the entry centers, and is sunk in parallel into one collection per batch. The sorted entries are then cut
+// into vertical slices, which are sorted by the y-coordinate and packed into leaf nodes in parallel. The (much
+// smaller) upper layers of the tree are packed the same way afterwards.
+
+// A contiguous range of entries in one of the sunk batches
+struct RTreeSlicePiece {
+	idx_t batch_idx;
+	idx_t offset;
+	idx_t count;
+};
+
 class CreateRTreeIndexGlobalState final : public GlobalSinkState {
 public:
 	//! Global index to be added to the table
 	unique_ptr<RTreeIndex> rtree;
 
-	//! The total number of leaf nodes in the RTree
-	idx_t rtree_size = 0;
-	idx_t slice_size = 0;
-	idx_t rtree_level = 0;
-
-	AllocatedData slice_buffer;
-
-	//! The bottom most layer of the RTree
-	ManagedCollection<RTreeEntry> curr_layer;
-	ManagedCollection<RTreeEntry> next_layer;
-
-	ManagedCollectionAppendState append_state;
-	ManagedCollectionScanState scan_state;
-
-	ManagedCollection<RTreeEntry> *curr_layer_ptr;
-	ManagedCollection<RTreeEntry> *next_layer_ptr;
+	//! Guards the batches while sinking, and the node allocators while packing the leaves
+	mutex lock;
 
-	RTreePointer current_pointer;
+	//! The sunk entries of every batch, in batch index order
+	map<idx_t, unique_ptr<ManagedCollection<RTreeEntry>>> batches;
+	//! The sunk batches, in order, once sinking has finished
+	vector<reference<ManagedCollection<RTreeEntry>>> ordered_batches;
 
-	idx_t entry_idx;
-	idx_t max_node_capacity;
+	//! The total number of entries in the RTree
+	atomic<idx_t> rtree_size {0};
+	idx_t max_leaf_capacity;
 
-	explicit CreateRTreeIndexGlobalState(ClientContext &context)
-	    : curr_layer(BufferManager::GetBufferManager(context)), next_layer(BufferManager::GetBufferManager(context)),
-	      curr_layer_ptr(&next_layer), // We swap the order here so that it initializes properly later
-	      next_layer_ptr(&curr_layer) {
-	}
+	//! The number of entries per vertical slice of the leaf layer
+	idx_t slice_size = 0;
+	//! The vertical slices of the leaf layer
+	vector<vector<RTreeSlicePiece>> slices;
+	//! The next slice to pack
+	atomic<idx_t> next_slice {0};
+	//! The packed leaf nodes of every slice
+	vector<vector<RTreeEntry>> slice_nodes;
 };
 
 unique_ptr<GlobalSinkState> PhysicalCreateRTreeIndex::GetGlobalSinkState(ClientContext &context) const {
-	auto gstate = make_uniq<CreateRTreeIndexGlobalState>(context);
+	auto gstate = make_uniq<CreateRTreeIndexGlobalState>();
 
 	// Create the index
 	auto &storage = table.GetStorage();
@@ -84,25 +90,69 @@ unique_ptr<GlobalSinkState> PhysicalCreateRTreeIndex::GetGlobalSinkState(ClientC
 	    make_uniq<RTreeIndex>(info->index_name, constraint_type, storage_ids, table_manager, unbound_expressions, db,
 	                          info->options, IndexStorageInfo(), estimated_cardinality);
 
-	gstate->max_node_capacity = gstate->rtree->tree->GetConfig().max_node_capacity;
-	gstate->entry_idx = gstate->max_node_capacity;
-
-	gstate->curr_layer.InitializeAppend(gstate->append_state);
+	gstate->max_leaf_capacity = gstate->rtree->tree->GetConfig().max_leaf_capacity;
 
 	return std::move(gstate);
 }
 
+//-------------------------------------------------------------
+// Local State
+//-------------------------------------------------------------
+class CreateRTreeIndexLocalState final : public LocalSinkState {
+public:
+	explicit CreateRTreeIndexLocalState(ClientContext &context) : buffer_manager(BufferManager::GetBufferManager(context)) {
+	}
+
+	BufferManager &buffer_manager;
+
+	//! The batch we are currently sinking
+	optional_idx batch_index;
+	unique_ptr<ManagedCollection<RTreeEntry>> collection;
+	ManagedCollectionAppendState append_state;
+
+	//! The rows with an EMPTY geometry, which have no bounds and are kept outside of the tree
+	vector<row_t> empty_rows;
+};
+
+unique_ptr<LocalSinkState> PhysicalCreateRTreeIndex::GetLocalSinkState(ExecutionContext &context) const {
+	return make_uniq<CreateRTreeIndexLocalState>(context.client);
+}
+
+// Hand the entries of the current batch over to the global state
+static void FlushBatch(CreateRTreeIndexGlobalState &gstate, CreateRTreeIndexLocalState &lstate) {
+	if (!lstate.collection) {
+		return;
+	}
+	lstate.append_state.handle.Destroy();
+	if (lstate.collection->Count() != 0) {
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.batches[lstate.batch_index.GetIndex()] = std::move(lstate.collection);
+	}
+	lstate.collection.reset();
+}
+
 //-------------------------------------------------------------
 // Sink
 //-------------------------------------------------------------
 SinkResultType PhysicalCreateRTreeIndex::Sink(ExecutionContext &context, DataChunk &chunk,
                                               OperatorSinkInput &input) const {
 	auto &gstate = input.global_state.Cast<CreateRTreeIndexGlobalState>();
+	auto &lstate = input.local_state.Cast<CreateRTreeIndexLocalState>();
 
 	if (chunk.size() == 0) {
 		return SinkResultType::NEED_MORE_INPUT;
 	}
 
+	// Start a new collection if we moved on to a new batch
+	const auto batch_index = lstate.partition_info.batch_index.GetIndex();
+	if (!lstate.collection || lstate.batch_index.GetIndex() != batch_index) {
+		FlushBatch(gstate, lstate);
+		lstate.batch_index = batch_index;
+		lstate.collection = make_uniq<ManagedCollection<RTreeEntry>>(lstate.buffer_manager);
+		// Start out small, most batches are only a few vectors large
+		lstate.collection->InitializeAppend(lstate.append_state, STANDARD_VECTOR_SIZE);
+	}
+
 	// TODO: Dont flatten chunk
 	chunk.Flatten();
 
@@ -113,10 +163,16 @@ SinkResultType PhysicalCreateRTreeIndex::Sink(ExecutionContext &context, DataChu
 	const auto max_x_data = FlatVector::GetData<float>(*bbox_vecs[2]);
 	const auto max_y_data = FlatVector::GetData<float>(*bbox_vecs[3]);
 
-	// Vectorized conversion from columnar to row-wise
+	// Vectorized conversion from columnar to row-wise. EMPTY geometries have no bounds.
+	const auto &bbox_validity = FlatVector::Validity(chunk.data[0]);
 	RTreeEntry entries[STANDARD_VECTOR_SIZE];
+	idx_t entry_count = 0;
 	for (idx_t elem_idx = 0; elem_idx < chunk.size(); elem_idx++) {
-		auto &entry = entries[elem_idx];
+		if (!bbox_validity.RowIsValid(elem_idx)) {
+			lstate.empty_rows.push_back(rowid_data[elem_idx]);
+			continue;
+		}
+		auto &entry = entries[entry_count++];
 		entry.pointer = RTree::MakeRowId(rowid_data[elem_idx]);
 		entry.bounds.min.x = min_x_data[elem_idx];
 		entry.bounds.min.y = min_y_data[elem_idx];
@@ -124,140 +180,89 @@ SinkResultType PhysicalCreateRTreeIndex::Sink(ExecutionContext &context, DataChu
 		entry.bounds.max.y = max_y_data[elem_idx];
 	}
 
-	// Append the chunk to the current layer
-	gstate.curr_layer.Append(gstate.append_state, entries, entries + chunk.size());
+	// Append the chunk to the current batch
+	lstate.collection->Append(lstate.append_state, entries, entries + entry_count);
 
 	// Count the number of entries
-	gstate.rtree_size += chunk.size();
+	gstate.rtree_size += entry_count;
 
 	return SinkResultType::NEED_MORE_INPUT;
 }
 
+//-------------------------------------------------------------
+// Combine
+//-------------------------------------------------------------
+SinkCombineResultType PhysicalCreateRTreeIndex::Combine(ExecutionContext &context,
+                                                        OperatorSinkCombineInput &input) const {
+	auto &gstate = input.global_state.Cast<CreateRTreeIndexGlobalState>();
+	auto &lstate = input.local_state.Cast<CreateRTreeIndexLocalState>();
+	FlushBatch(gstate, lstate);
+	if (!lstate.empty_rows.empty()) {
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.rtree->empty_rows.insert(lstate.empty_rows.begin(), lstate.empty_rows.end());
+	}
+	return SinkCombineResultType::FINISHED;
+}
+
 //-------------------------------------------------------------
 // RTree Construction
 //-------------------------------------------------------------
-static TaskExecutionResult BuildRTreeBottomUp(CreateRTreeIndexGlobalState &state, TaskExecutionMode mode,
-                                              Event &event) {
+// Pack the leaf layer, one slice at a time. Sorting the slices happens in parallel, but the node allocators are
+// not thread-safe, so we have to hold the lock while packing the sorted slices into nodes.
+static TaskExecutionResult BuildRTreeLeaves(CreateRTreeIndexGlobalState &state, TaskExecutionMode mode,
+                                            Event &event) {
 	auto &tree = *state.rtree->tree;
 
-	auto slice_begin = reinterpret_cast<RTreeEntry *>(state.slice_buffer.get());
-	auto slice_end = slice_begin + state.slice_size;
-
-	// Now, we have our base layer with all the leaves, we need to build the rest of the tree layer by layer
-	while (state.curr_layer_ptr->Count() != 1) {
-		if (state.scan_state.IsDone()) {
-
-			// Swap the layers and initialize the next layer
-			std::swap(state.curr_layer_ptr, state.next_layer_ptr);
-
-			if (state.curr_layer_ptr->Count() == 1) {
-				// We are done!
-				break;
-			}
+	vector<RTreeEntry> slice_buffer;
+	slice_buffer.resize(state.slice_size);
 
-			// Current layer size, divided by the node capacity (rounded up)
-			const auto next_layer_size =
-			    (state.curr_layer_ptr->Count() + state.max_node_capacity - 1) / state.max_node_capacity;
-			state.next_layer_ptr->Clear();
-			state.next_layer_ptr->InitializeAppend(state.append_state, next_layer_size);
-			state.curr_layer_ptr->InitializeScan(state.scan_state, true);
+	while (true) {
+		const auto slice_idx = state.next_slice++;
+		if (slice_idx >= state.slices.size()) {
+			break;
 		}
 
-		idx_t child_idx = state.max_node_capacity;
-		RTreePointer current_ptr;
-		bool needs_insertion = false;
-
-		auto scan_count = state.curr_layer_ptr->Scan(state.scan_state, slice_begin, slice_end);
-
-		while (scan_count != 0) {
-
-			// Sort the slice by the bounding box y-min value
-			std::sort(slice_begin, slice_begin + scan_count, [&](const RTreeEntry &a, const RTreeEntry &b) {
-				return a.bounds.Center().y < b.bounds.Center().y;
-			});
-
-			// Now we can build the next layer
-			idx_t scan_idx = 0;
-			while (scan_idx < scan_count) {
-
-				// Initialize a new node if we have to
-				if (child_idx == state.max_node_capacity) {
-					auto node_type = state.rtree_level == 0 ? RTreeNodeType::LEAF_PAGE : RTreeNodeType::BRANCH_PAGE;
-					current_ptr = tree.MakePage(node_type);
-					child_idx = 0;
-					needs_insertion = true;
-				}
-
-				const auto remaining_capacity = state.max_node_capacity - child_idx;
-				const auto remaining_elements = scan_count - scan_idx;
-
-				// Dereference the current node
-				auto &node = tree.RefMutable(current_ptr);
-
-				for (idx_t j = 0; j < MinValue<idx_t>(remaining_capacity, remaining_elements); j++) {
-					node.PushEntry(slice_begin[scan_idx++]);
-					child_idx++;
-				}
-
-				if (child_idx == state.max_node_capacity) {
-					// Append the current node to the layer
-					if (current_ptr.GetType() == RTreeNodeType::LEAF_PAGE) {
-						// If the node is a leaf node, sort it by row id
-						node.SortEntriesByRowId();
-					}
-					auto node_bounds = node.GetBounds();
-					state.next_layer_ptr->Append(state.append_state, RTreeEntry {current_ptr, node_bounds});
-					needs_insertion = false;
-
-					node.Verify(state.max_node_capacity);
-				}
-			}
-
-			// Scan the next batch
-			scan_count = state.curr_layer_ptr->Scan(state.scan_state, slice_begin, slice_end);
+		// Gather the slice from the sunk batches
+		idx_t slice_count = 0;
+		for (auto &piece : state.slices[slice_idx]) {
+			auto &batch = state.ordered_batches[piece.batch_idx].get();
+			const auto begin = slice_buffer.data() + slice_count;
+			slice_count += batch.Read(piece.offset, begin, begin + piece.count);
 		}
 
-		// If the layer was exhausted before we filled the last node, we need to insert it now
-		if (needs_insertion) {
-			auto &node = tree.RefMutable(current_ptr);
-			if (current_ptr.GetType() == RTreeNodeType::LEAF_PAGE) {
-				// If the node is a leaf node, sort it by row id
-				node.SortEntriesByRowId();
-			}
-			auto node_bounds = node.GetBounds();
-			state.next_layer_ptr->Append(state.append_state, RTreeEntry {current_ptr, node_bounds});
-			needs_insertion = false;
-		}
+		const auto slice_begin = slice_buffer.data();
+		const auto slice_end = slice_begin + slice_count;
+		RTree::SortSlice(slice_begin, slice_end);
 
-		// We are done with this layer, pop it
-		state.rtree_level++;
+		{
+			lock_guard<mutex> guard(state.lock);
+			tree.PackSlice(RTreeNodeType::LEAF_PAGE, slice_begin, slice_end, state.slice_nodes[slice_idx]);
+		}
 
-		// Yield if we are in partial mode and the scan is exhausted
+		// Yield if we are in partial mode
 		if (mode == TaskExecutionMode::PROCESS_PARTIAL) {
 			return TaskExecutionResult::TASK_NOT_FINISHED;
 		}
 	}
 
-	// Set the root node!
-	auto root = state.curr_layer_ptr->Fetch(0);
-
-	if (root.pointer.GetType() == RTreeNodeType::ROW_ID) {
-		// Create a leaf node to hold this row id
-		auto root_leaf_ptr = tree.MakePage(RTreeNodeType::LEAF_PAGE);
-		auto &node = tree.RefMutable(root_leaf_ptr);
-		node.PushEntry(RTreeEntry {root.pointer, root.bounds});
-		tree.SetRoot(RTreeEntry {root_leaf_ptr, root.bounds});
-	} else {
-		// Else, just set the root node
-		D_ASSERT(root.pointer.IsPage());
-		auto root_entry = state.curr_layer_ptr->Fetch(0);
-		tree.SetRoot(root_entry);
-	}
-
 	event.FinishTask();
 	return TaskExecutionResult::TASK_FINISHED;
 }
 
+// Pack the upper layers of the tree, layer by layer, until only the root remains
+static void BuildRTreeBranches(CreateRTreeIndexGlobalState &state) {
+	auto &tree = *state.rtree->tree;
+
+	// Gather the leaf nodes of all slices, in slice order
+	vector<RTreeEntry> curr_layer;
+	for (auto &nodes : state.slice_nodes) {
+		curr_layer.insert(curr_layer.end(), nodes.begin(), nodes.end());
+	}
+	state.slice_nodes.clear();
+
+	tree.PackBranches(curr_layer);
+}
+
 class RTreeIndexConstructionTask final : public ExecutorTask {
 public:
 	RTreeIndexConstructionTask(shared_ptr<Event> event_p, ClientContext &context, CreateRTreeIndexGlobalState &gstate,
@@ -266,7 +271,7 @@ public:
 	}
 
 	TaskExecutionResult ExecuteTask(TaskExecutionMode mode) override {
-		return BuildRTreeBottomUp(state, mode, *event);
+		return BuildRTreeLeaves(state, mode, *event);
 	}
 
 private:
@@ -314,13 +319,23 @@ public:
 	void Schedule() override {
 		auto &context = pipeline->GetClientContext();
 
-		// We only schedule 1 task, as the bottom-up construction is single-threaded.
+		// Schedule a task per thread, the tasks pull slices of the leaf layer until all of them are packed
+		const auto thread_count = NumericCast<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+		const auto task_count = MaxValue<idx_t>(1, MinValue<idx_t>(thread_count, gstate.slices.size()));
+
 		vector<shared_ptr<Task>> tasks;
-		tasks.push_back(make_uniq<RTreeIndexConstructionTask>(shared_from_this(), context, gstate, op));
+		for (idx_t i = 0; i < task_count; i++) {
+			tasks.push_back(make_uniq<RTreeIndexConstructionTask>(shared_from_this(), context, gstate, op));
+		}
 		SetTasks(std::move(tasks));
 	}
 
 	void FinishEvent() override {
+		// The leaves are done, we no longer need the sunk entries
+		gstate.ordered_batches.clear();
+		gstate.batches.clear();
+
+		BuildRTreeBranches(gstate);
 		AddIndexToCatalog(pipeline->GetClientContext(), gstate, info, table);
 	}
 
@@ -346,17 +361,34 @@ SinkFinalizeType PhysicalCreateRTreeIndex::Finalize(Pipeline &pipeline, Event &e
 	}
 
 	// Otherwise, we need to build the RTree
+	for (auto &entry : gstate.batches) {
+		gstate.ordered_batches.push_back(*entry.second);
+	}
 
-	// Calculate the vertical slice size
-	// square root of the total number of entries divide by the capacity of a node, rounded up
-	gstate.slice_size = ExactNumericCast<idx_t>(std::ceil(
-	                        std::sqrt((gstate.rtree_size + gstate.max_node_capacity - 1) / gstate.max_node_capacity))) *
-	                    gstate.max_node_capacity;
-
-	// Allocate a buffer for the vertical slice
-	// (this can get quite large, so we allocate it on the buffer manager)
-	gstate.slice_buffer =
-	    BufferManager::GetBufferManager(context).GetBufferAllocator().Allocate(gstate.slice_size * sizeof(RTreeEntry));
+	// Cut the sorted entries into vertical slices. A slice may span multiple batches.
+	gstate.slice_size = RTree::GetSliceSize(gstate.rtree_size, gstate.max_leaf_capacity);
+
+	vector<RTreeSlicePiece> slice;
+	idx_t slice_count = 0;
+	for (idx_t batch_idx = 0; batch_idx < gstate.ordered_batches.size(); batch_idx++) {
+		const auto batch_count = gstate.ordered_batches[batch_idx].get().Count();
+		idx_t batch_offset = 0;
+		while (batch_offset < batch_count) {
+			const auto piece_count = MinValue<idx_t>(batch_count - batch_offset, gstate.slice_size - slice_count);
+			slice.push_back({batch_idx, batch_offset, piece_count});
+			batch_offset += piece_count;
+			slice_count += piece_count;
+			if (slice_count == gstate.slice_size) {
+				gstate.slices.push_back(std::move(slice));
+				slice.clear();
+				slice_count = 0;
+			}
+		}
+	}
+	if (slice_count != 0) {
+		gstate.slices.push_back(std::move(slice));
+	}
+	gstate.slice_nodes.resize(gstate.slices.size());
 
 	// Schedule the construction of the RTree
 	auto construction_event = make_uniq<RTreeIndexConstructionEvent>(gstate, pipeline, *info, table, *this);
@@ -0,0 +1,177 @@
+#include "spatial/core/index/rtree/rtree_index_join_logical.hpp"
+
+#include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
+#include "duckdb/common/serializer/deserializer.hpp"
+#include "duckdb/common/serializer/serializer.hpp"
+#include "duckdb/execution/column_binding_resolver.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/storage/data_table.hpp"
+
+#include "spatial/core/index/rtree/rtree_index.hpp"
+#include "spatial/core/index/rtree/rtree_index_join_physical.hpp"
+
+namespace spatial {
+
+namespace core {
+
+LogicalRTreeIndexJoin::LogicalRTreeIndexJoin(TableCatalogEntry &table_p, RTreeIndex &index_p,
+                                             idx_t inner_table_index_p, vector<column_t> inner_column_ids_p,
+                                             vector<LogicalType> inner_types_p, vector<idx_t> inner_projection_ids_p,
+                                             vector<idx_t> probe_projection_ids_p, bool inner_is_left_p)
+    : LogicalExtensionOperator(), table(table_p), index(index_p), inner_table_index(inner_table_index_p),
+      inner_column_ids(std::move(inner_column_ids_p)), inner_types(std::move(inner_types_p)),
+      inner_projection_ids(std::move(inner_projection_ids_p)), probe_projection_ids(std::move(probe_projection_ids_p)),
+      inner_is_left(inner_is_left_p) {
+}
+
+vector<ColumnBinding> LogicalRTreeIndexJoin::GetJoinBindings() {
+	auto result = children[0]->GetColumnBindings();
+	for (idx_t i = 0; i < inner_column_ids.size(); i++) {
+		result.emplace_back(inner_table_index, i);
+	}
+	return result;
+}
+
+vector<ColumnBinding> LogicalRTreeIndexJoin::GetColumnBindings() {
+	const auto child_bindings = children[0]->GetColumnBindings();
+
+	vector<ColumnBinding> probe_bindings;
+	for (auto &idx : probe_projection_ids) {
+		probe_bindings.push_back(child_bindings[idx]);
+	}
+
+	vector<ColumnBinding> inner_bindings;
+	for (auto &idx : inner_projection_ids) {
+		inner_bindings.emplace_back(inner_table_index, idx);
+	}
+
+	// Emit the columns in the same order as the join we replaced
+	auto &first = inner_is_left ? inner_bindings : probe_bindings;
+	auto &second = inner_is_left ? probe_bindings : inner_bindings;
+	first.insert(first.end(), second.begin(), second.end());
+	return first;
+}
+
+void LogicalRTreeIndexJoin::ResolveTypes() {
+	vector<LogicalType> probe_types;
+	for (auto &idx : probe_projection_ids) {
+		probe_types.push_back(children[0]->types[idx]);
+	}
+
+	vector<LogicalType> projected_inner_types;
+	for (auto &idx : inner_projection_ids) {
+		projected_inner_types.push_back(inner_types[idx]);
+	}
+
+	auto &first = inner_is_left ? projected_inner_types : probe_types;
+	auto &second = inner_is_left ? probe_types : projected_inner_types;
+	types = first;
+	types.insert(types.end(), second.begin(), second.end());
+}
+
+void LogicalRTreeIndexJoin::ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) {
+	// Resolve the probe side first
+	res.VisitOperator(*children[0]);
+
+	// The expressions are evaluated on the probe columns followed by the fetched inner columns
+	bindings = GetJoinBindings();
+	LogicalOperatorVisitor::EnumerateExpressions(*this,
+	                                             [&](unique_ptr<Expression> *child) { res.VisitExpression(child); });
+
+	// Parent operators see the projected output of the join
+	bindings = GetColumnBindings();
+}
+
+unique_ptr<PhysicalOperator> LogicalRTreeIndexJoin::CreatePlan(ClientContext &context,
+                                                               PhysicalPlanGenerator &generator) {
+	D_ASSERT(children.size() == 1);
+	D_ASSERT(expressions.size() == 2);
+
+	const auto probe_column_count = children[0]->types.size();
+	auto probe_plan = generator.CreatePlan(std::move(children[0]));
+
+	// Map every output column to its position in the joined (probe + inner) chunk
+	vector<idx_t> probe_columns;
+	for (auto &idx : probe_projection_ids) {
+		probe_columns.push_back(idx);
+	}
+	vector<idx_t> inner_columns;
+	for (auto &idx : inner_projection_ids) {
+		inner_columns.push_back(probe_column_count + idx);
+	}
+	auto &first = inner_is_left ? inner_columns : probe_columns;
+	auto &second = inner_is_left ? probe_columns : inner_columns;
+	first.insert(first.end(), second.begin(), second.end());
+
+	generator.dependencies.AddDependency(table);
+
+	auto join = make_uniq<PhysicalRTreeIndexJoin>(*this, table.Cast<DuckTableEntry>(), index, inner_column_ids,
+	                                              inner_types, std::move(first), std::move(expressions[0]),
+	                                              std::move(expressions[1]), estimated_cardinality);
+	join->children.push_back(std::move(probe_plan));
+	return std::move(join);
+}
+
+//------------------------------------------------------------------------------
+// (De)Serialization
+//------------------------------------------------------------------------------
+void LogicalRTreeIndexJoin::Serialize(Serializer &writer) const {
+	LogicalExtensionOperator::Serialize(writer);
+	writer.WritePropertyWithDefault(300, "operator_type", string("logical_rtree_index_join"));
+	writer.WritePropertyWithDefault(400, "catalog", table.ParentCatalog().GetName());
+	writer.WritePropertyWithDefault(401, "schema", table.ParentSchema().name);
+	writer.WritePropertyWithDefault(402, "table", table.name);
+	writer.WritePropertyWithDefault(403, "index", index.GetIndexName());
+	writer.WritePropertyWithDefault(404, "inner_table_index", inner_table_index);
+	writer.WritePropertyWithDefault(405, "inner_column_ids", inner_column_ids);
+	writer.WritePropertyWithDefault(406, "inner_types", inner_types);
+	writer.WritePropertyWithDefault(407, "inner_projection_ids", inner_projection_ids);
+	writer.WritePropertyWithDefault(408, "probe_projection_ids", probe_projection_ids);
+	writer.WritePropertyWithDefault(409, "inner_is_left", inner_is_left);
+	writer.WritePropertyWithDefault(410, "expressions", expressions);
+}
+
+unique_ptr<LogicalExtensionOperator> LogicalRTreeIndexJoin::Deserialize(Deserializer &reader) {
+	const auto catalog = reader.ReadPropertyWithDefault<string>(400, "catalog");
+	const auto schema = reader.ReadPropertyWithDefault<string>(401, "schema");
+	const auto table_name = reader.ReadPropertyWithDefault<string>(402, "table");
+	const auto index_name = reader.ReadPropertyWithDefault<string>(403, "index");
+	const auto inner_table_index = reader.ReadPropertyWithDefault<idx_t>(404, "inner_table_index");
+	auto inner_column_ids = reader.ReadPropertyWithDefault<vector<column_t>>(405, "inner_column_ids");
+	auto inner_types = reader.ReadPropertyWithDefault<vector<LogicalType>>(406, "inner_types");
+	auto inner_projection_ids = reader.ReadPropertyWithDefault<vector<idx_t>>(407, "inner_projection_ids");
+	auto probe_projection_ids = reader.ReadPropertyWithDefault<vector<idx_t>>(408, "probe_projection_ids");
+	const auto inner_is_left = reader.ReadPropertyWithDefault<bool>(409, "inner_is_left");
+	auto expressions = reader.ReadPropertyWithDefault<vector<unique_ptr<Expression>>>(410, "expressions");
+
+	// We need to rebind the table and the index
+	auto &context = reader.Get<ClientContext &>();
+	auto &table_entry = Catalog::GetEntry<TableCatalogEntry>(context, catalog, schema, table_name);
+	if (!table_entry.IsDuckTable()) {
+		throw SerializationException("RTree index join: table '%s' is not a DuckDB table", table_name);
+	}
+	auto &table_info = *table_entry.GetStorage().GetDataTableInfo();
+
+	optional_ptr<RTreeIndex> index;
+	table_info.GetIndexes().BindAndScan<RTreeIndex>(context, table_info, [&](RTreeIndex &index_entry) {
+		if (index_entry.GetIndexName() == index_name) {
+			index = &index_entry;
+			return true;
+		}
+		return false;
+	});
+	if (!index) {
+		throw SerializationException("RTree index join: could not find index '%s' on table '%s'", index_name,
+		                             table_name);
+	}
+
+	auto result = make_uniq<LogicalRTreeIndexJoin>(table_entry, *index, inner_table_index, std::move(inner_column_ids),
+	                                               std::move(inner_types), std::move(inner_projection_ids),
+	                                               std::move(probe_projection_ids), inner_is_left);
+	result->expressions = std::move(expressions);
+	return std::move(result);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,212 @@
+#include "spatial/core/index/rtree/rtree_index_join_physical.hpp"
+
+#include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+
+#include "spatial/core/geometry/geometry_type.hpp"
+#include "spatial/core/index/rtree/rtree_index.hpp"
+#include "spatial/core/util/math.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//-------------------------------------------------------------
+// Physical RTree Index Join
+//-------------------------------------------------------------
+PhysicalRTreeIndexJoin::PhysicalRTreeIndexJoin(LogicalOperator &op, DuckTableEntry &table, RTreeIndex &index,
+                                               const vector<column_t> &inner_column_ids,
+                                               const vector<LogicalType> &inner_types, vector<idx_t> output_columns,
+                                               unique_ptr<Expression> predicate, unique_ptr<Expression> probe_key,
+                                               idx_t estimated_cardinality)
+    // Declare this operators as a EXTENSION operator
+    : PhysicalOperator(PhysicalOperatorType::EXTENSION, op.types, estimated_cardinality), table(table), index(index),
+      output_columns(std::move(output_columns)), predicate(std::move(predicate)), probe_key(std::move(probe_key)) {
+
+	// Convert the logical column ids to storage column ids
+	for (idx_t i = 0; i < inner_column_ids.size(); i++) {
+		const auto &id = inner_column_ids[i];
+		fetch_ids.push_back(id == COLUMN_IDENTIFIER_ROW_ID ? id : table.GetColumn(LogicalIndex(id)).StorageOid());
+		fetch_types.push_back(inner_types[i]);
+	}
+
+	// We always fetch the row ids as well, so that we can tell which candidates were visible to the transaction
+	fetch_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
+	fetch_types.push_back(LogicalType::ROW_TYPE);
+
+	join_types = op.children[0]->types;
+	join_types.insert(join_types.end(), inner_types.begin(), inner_types.end());
+}
+
+//-------------------------------------------------------------
+// Local State
+//-------------------------------------------------------------
+class RTreeIndexJoinState final : public OperatorState {
+public:
+	RTreeIndexJoinState(ClientContext &context, const PhysicalRTreeIndexJoin &op)
+	    : probe_executor(context, *op.probe_key), predicate_executor(context, *op.predicate),
+	      row_ids(LogicalType::ROW_TYPE), candidate_sel(STANDARD_VECTOR_SIZE), match_sel(STANDARD_VECTOR_SIZE) {
+		probe_keys.Initialize(context, {op.probe_key->return_type});
+		fetch_chunk.Initialize(context, op.fetch_types);
+		join_chunk.InitializeEmpty(op.join_types);
+	}
+
+	ExpressionExecutor probe_executor;
+	ExpressionExecutor predicate_executor;
+	ColumnFetchState fetch_state;
+
+	//! The probe geometries of the current input chunk, and their bounding boxes
+	DataChunk probe_keys;
+	RTreeBounds probe_bounds[STANDARD_VECTOR_SIZE];
+	bool probe_valid[STANDARD_VECTOR_SIZE];
+	bool probe_initialized = false;
+
+	//! The input row currently being probed, and the index scan for it (if not yet exhausted)
+	idx_t probe_idx = 0;
+	unique_ptr<IndexScanState> index_state;
+
+	//! The candidate row ids, and for each candidate the input row it was found for
+	Vector row_ids;
+	SelectionVector candidate_sel;
+	SelectionVector match_sel;
+
+	DataChunk fetch_chunk;
+	DataChunk join_chunk;
+
+public:
+	void InitializeProbe(DataChunk &input) {
+		probe_keys.Reset();
+		probe_executor.Execute(input, probe_keys);
+
+		UnifiedVectorFormat format;
+		probe_keys.data[0].ToUnifiedFormat(input.size(), format);
+		const auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(format);
+
+		for (idx_t i = 0; i < input.size(); i++) {
+			const auto idx = format.sel->get_index(i);
+			Box2D<double> bbox;
+			// Empty geometries (which have no bounds) can not satisfy any of the predicates we plan this join for
+			probe_valid[i] = format.validity.RowIsValid(idx) && geom_data[idx].TryGetCachedBounds(bbox);
+			if (probe_valid[i]) {
+				probe_bounds[i].min.x = MathUtil::DoubleToFloatDown(bbox.min.x);
+				probe_bounds[i].min.y = MathUtil::DoubleToFloatDown(bbox.min.y);
+				probe_bounds[i].max.x = MathUtil::DoubleToFloatUp(bbox.max.x);
+				probe_bounds[i].max.y = MathUtil::DoubleToFloatUp(bbox.max.y);
+			}
+		}
+
+		probe_idx = 0;
+		index_state = nullptr;
+		probe_initialized = true;
+	}
+
+	void Reset() {
+		probe_idx = 0;
+		index_state = nullptr;
+		probe_initialized = false;
+	}
+};
+
+unique_ptr<OperatorState> PhysicalRTreeIndexJoin::GetOperatorState(ExecutionContext &context) const {
+	return make_uniq<RTreeIndexJoinState>(context.client, *this);
+}
+
+//-------------------------------------------------------------
+// Execute
+//-------------------------------------------------------------
+OperatorResultType PhysicalRTreeIndexJoin::Execute(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                                   GlobalOperatorState &gstate_p, OperatorState &state_p) const {
+	auto &state = state_p.Cast<RTreeIndexJoinState>();
+
+	if (!state.probe_initialized) {
+		state.InitializeProbe(input);
+	}
+
+	// Collect up to a vector of candidate (input row, row id) pairs, possibly spanning multiple input rows
+	const auto row_id_data = FlatVector::GetData<row_t>(state.row_ids);
+	idx_t candidate_count = 0;
+	while (candidate_count < STANDARD_VECTOR_SIZE && state.probe_idx < input.size()) {
+		if (!state.index_state) {
+			if (!state.probe_valid[state.probe_idx]) {
+				state.probe_idx++;
+				continue;
+			}
+			state.index_state = index.InitializeScan(state.probe_bounds[state.probe_idx]);
+		}
+
+		idx_t scan_count;
+		{
+			// The traversal is serialized on the lock of the index, the fetch and probe run in parallel
+			lock_guard<mutex> guard(index.GetNodeLock());
+			scan_count = index.Scan(*state.index_state, row_id_data + candidate_count,
+			                        STANDARD_VECTOR_SIZE - candidate_count);
+		}
+		for (idx_t i = 0; i < scan_count; i++) {
+			state.candidate_sel.set_index(candidate_count + i, state.probe_idx);
+		}
+		candidate_count += scan_count;
+
+		if (candidate_count < STANDARD_VECTOR_SIZE) {
+			// The scan did not fill the remaining space, so it is exhausted. Move on to the next input row
+			state.index_state = nullptr;
+			state.probe_idx++;
+		}
+	}
+
+	chunk.SetCardinality(0);
+
+	if (candidate_count != 0) {
+		// Fetch the candidate rows
+		auto &transaction = DuckTransaction::Get(context.client, table.catalog);
+		state.fetch_chunk.Reset();
+		table.GetStorage().Fetch(transaction, state.fetch_chunk, fetch_ids, state.row_ids, candidate_count,
+		                         state.fetch_state);
+
+		// Rows that are not visible to this transaction are skipped by the fetch. In that case, realign the
+		// input rows with the fetched rows using the row ids we fetched along.
+		const auto fetch_count = state.fetch_chunk.size();
+		if (fetch_count != candidate_count) {
+			const auto fetched_row_ids = FlatVector::GetData<row_t>(state.fetch_chunk.data.back());
+			idx_t candidate_idx = 0;
+			for (idx_t i = 0; i < fetch_count; i++) {
+				while (row_id_data[candidate_idx] != fetched_row_ids[i]) {
+					candidate_idx++;
+				}
+				state.candidate_sel.set_index(i, state.candidate_sel.get_index(candidate_idx));
+				candidate_idx++;
+			}
+		}
+
+		// Assemble the joined chunk: the probe columns followed by the fetched inner columns
+		const auto probe_column_count = input.ColumnCount();
+		for (idx_t i = 0; i < probe_column_count; i++) {
+			state.join_chunk.data[i].Slice(input.data[i], state.candidate_sel, fetch_count);
+		}
+		for (idx_t i = 0; i < fetch_types.size() - 1; i++) {
+			state.join_chunk.data[probe_column_count + i].Reference(state.fetch_chunk.data[i]);
+		}
+		state.join_chunk.SetCardinality(fetch_count);
+
+		// Evaluate the exact predicate and emit the matching pairs
+		const auto match_count = state.predicate_executor.SelectExpression(state.join_chunk, state.match_sel);
+		for (idx_t i = 0; i < output_columns.size(); i++) {
+			chunk.data[i].Slice(state.join_chunk.data[output_columns[i]], state.match_sel, match_count);
+		}
+		chunk.SetCardinality(match_count);
+	}
+
+	if (state.probe_idx >= input.size()) {
+		// All input rows have been probed
+		state.Reset();
+		return OperatorResultType::NEED_MORE_INPUT;
+	}
+	return OperatorResultType::HAVE_MORE_OUTPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,372 @@
+#include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
+#include "duckdb/catalog/dependency_list.hpp"
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+#include "duckdb/transaction/local_storage.hpp"
+
+#include "spatial/core/geometry/geometry_type.hpp"
+#include "spatial/core/index/rtree/rtree_index.hpp"
+#include "spatial/core/index/rtree/rtree_index_scan.hpp"
+#include "spatial/core/index/rtree/rtree_module.hpp"
+#include "spatial/core/types.hpp"
+
+#include <queue>
+
+namespace spatial {
+
+namespace core {
+
+static BindInfo RTreeIndexKNNScanBindInfo(const optional_ptr<FunctionData> bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	return BindInfo(bind_data.table);
+}
+
+//-------------------------------------------------------------------------
+// Global State
+//-------------------------------------------------------------------------
+// The KNN scan emits a superset of the k rows nearest to the query point, the TOP_N operator on top of it then
+// computes the exact distances and picks the actual nearest rows.
+//
+// The candidates are pulled from the index in order of the distance to their bounds, and fetched to find out which
+// of them are visible. A row is never farther away than the farthest point of its bounds, so once we have seen k
+// visible rows, the k nearest visible rows are all within the largest of their maximum distances. The search goes
+// on until no rows within that distance are left.
+//
+// Rows with a NULL geometry are not part of the index, and neither are rows appended by the current transaction.
+// Whenever we cannot produce at least k visible candidates, the nearest rows may be rows we don't know about, so we
+// fall back to scanning the whole table. The index keeps track of the rows with an EMPTY geometry, which are at
+// distance 0 and are always candidates.
+struct RTreeIndexKNNScanGlobalState : public GlobalTableFunctionState {
+	vector<storage_t> column_ids;
+
+	//! The fetched (visible) candidates
+	unique_ptr<ColumnDataCollection> candidates;
+	ColumnDataScanState candidates_scan;
+
+	//! Whether we fell back to a full table scan
+	bool full_scan = false;
+	TableScanState scan_state;
+};
+
+static unique_ptr<GlobalTableFunctionState> RTreeIndexKNNScanInitGlobal(ClientContext &context,
+                                                                        TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<RTreeIndexKNNScanBindData>();
+	auto result = make_uniq<RTreeIndexKNNScanGlobalState>();
+
+	// Figure out the storage column ids
+	for (auto &id : input.column_ids) {
+		storage_t col_id = id;
+		if (id != DConstants::INVALID_INDEX) {
+			col_id = bind_data.table.GetColumn(LogicalIndex(id)).StorageOid();
+		}
+		result->column_ids.push_back(col_id);
+	}
+
+	auto &storage = bind_data.table.GetStorage();
+	auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+	if (local_storage.Find(storage)) {
+		auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+		storage.InitializeScan(transaction, result->scan_state, result->column_ids);
+		result->full_scan = true;
+	}
+	return std::move(result);
+}
+
+//-------------------------------------------------------------------------
+// Execute
+//-------------------------------------------------------------------------
+struct RTreeIndexKNNCandidate {
+	row_t row_id;
+	//! The squared distance from the query point to the farthest point of the bounds of the row
+	double max_distance;
+
+	bool operator<(const RTreeIndexKNNCandidate &other) const {
+		return row_id < other.row_id;
+	}
+};
+
+// Fetches candidate rows, appends the visible ones to the result and keeps track of the k smallest maximum
+// distances among them
+class RTreeIndexKNNFetcher {
+public:
+	RTreeIndexKNNFetcher(ClientContext &context, const RTreeIndexKNNScanBindData &bind_data,
+	                     const vector<storage_t> &column_ids, const vector<LogicalType> &types,
+	                     ColumnDataCollection &result)
+	    : transaction(DuckTransaction::Get(context, bind_data.table.catalog)), storage(bind_data.table.GetStorage()),
+	      k(bind_data.k), result(result), row_id_vec(LogicalType::ROW_TYPE) {
+
+		// Fetch the row ids as well, to tell which candidates are visible
+		fetch_column_ids = column_ids;
+		fetch_column_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
+		auto fetch_types = types;
+		fetch_types.push_back(LogicalType::ROW_TYPE);
+		fetch_chunk.Initialize(context, fetch_types);
+		output_chunk.InitializeEmpty(types);
+	}
+
+	// Fetch the candidates in storage order
+	void Fetch(vector<RTreeIndexKNNCandidate> &candidates) {
+		std::sort(candidates.begin(), candidates.end());
+		for (idx_t offset = 0; offset < candidates.size(); offset += STANDARD_VECTOR_SIZE) {
+			const auto row_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, candidates.size() - offset);
+			const auto row_id_data = FlatVector::GetData<row_t>(row_id_vec);
+			for (idx_t i = 0; i < row_count; i++) {
+				row_id_data[i] = candidates[offset + i].row_id;
+			}
+
+			fetch_chunk.Reset();
+			storage.Fetch(transaction, fetch_chunk, fetch_column_ids, row_id_vec, row_count, fetch_state);
+			if (fetch_chunk.size() == 0) {
+				continue;
+			}
+
+			// Only the visible rows are fetched
+			const auto begin = candidates.begin() + static_cast<int64_t>(offset);
+			const auto end = begin + static_cast<int64_t>(row_count);
+			auto &fetched_row_ids = fetch_chunk.data.back();
+			fetched_row_ids.Flatten(fetch_chunk.size());
+			const auto fetched_data = FlatVector::GetData<row_t>(fetched_row_ids);
+			for (idx_t i = 0; i < fetch_chunk.size(); i++) {
+				const auto entry = std::lower_bound(begin, end, RTreeIndexKNNCandidate {fetched_data[i], 0});
+				D_ASSERT(entry != end && entry->row_id == fetched_data[i]);
+				AddVisible(entry->max_distance);
+			}
+
+			for (idx_t col_idx = 0; col_idx < output_chunk.ColumnCount(); col_idx++) {
+				output_chunk.data[col_idx].Reference(fetch_chunk.data[col_idx]);
+			}
+			output_chunk.SetCardinality(fetch_chunk.size());
+			result.Append(output_chunk);
+		}
+	}
+
+	bool HasK() const {
+		return max_distances.size() == k;
+	}
+
+	// The k nearest visible rows are within this (squared) distance
+	double MaxDistance() const {
+		return HasK() ? max_distances.top() : NumericLimits<double>::Maximum();
+	}
+
+private:
+	void AddVisible(double max_distance) {
+		if (max_distances.size() < k) {
+			max_distances.push(max_distance);
+		} else if (max_distance < max_distances.top()) {
+			max_distances.pop();
+			max_distances.push(max_distance);
+		}
+	}
+
+	DuckTransaction &transaction;
+	DataTable &storage;
+	const idx_t k;
+	ColumnDataCollection &result;
+
+	vector<storage_t> fetch_column_ids;
+	DataChunk fetch_chunk;
+	DataChunk output_chunk;
+	Vector row_id_vec;
+	ColumnFetchState fetch_state;
+
+	//! The k smallest maximum distances of the visible candidates
+	std::priority_queue<double> max_distances;
+};
+
+// Fetch all the candidates up front, so that we know how many of them are visible before emitting any rows
+static void RTreeIndexKNNScanFetchCandidates(ClientContext &context, const RTreeIndexKNNScanBindData &bind_data,
+                                             RTreeIndexKNNScanGlobalState &gstate, const vector<LogicalType> &types) {
+	auto &index = bind_data.index.Cast<RTreeIndex>();
+	gstate.candidates = make_uniq<ColumnDataCollection>(context, types);
+	RTreeIndexKNNFetcher fetcher(context, bind_data, gstate.column_ids, types, *gstate.candidates);
+
+	// The EMPTY rows are at distance 0, nearer than any of the rows in the tree
+	vector<RTreeIndexKNNCandidate> candidates;
+	unique_ptr<IndexScanState> index_state;
+	{
+		lock_guard<mutex> guard(index.GetNodeLock());
+		for (const auto &row_id : index.empty_rows) {
+			candidates.push_back(RTreeIndexKNNCandidate {row_id, 0});
+		}
+		index_state = index.InitializeKNNScan(bind_data.point);
+	}
+	fetcher.Fetch(candidates);
+
+	// Pull candidates from the index until there are no rows left that can be nearer than the k nearest visible rows
+	// we have seen so far. Don't pull more than k at once, so that we don't fetch much more than needed.
+	const auto batch_size = MinValue<idx_t>(bind_data.k, STANDARD_VECTOR_SIZE);
+	row_t row_ids[STANDARD_VECTOR_SIZE];
+	double max_distances[STANDARD_VECTOR_SIZE];
+	while (true) {
+		idx_t count;
+		{
+			lock_guard<mutex> guard(index.GetNodeLock());
+			count = index.KNNScan(*index_state, fetcher.MaxDistance(), row_ids, max_distances, batch_size);
+		}
+		if (count == 0) {
+			break;
+		}
+		candidates.clear();
+		for (idx_t i = 0; i < count; i++) {
+			candidates.push_back(RTreeIndexKNNCandidate {row_ids[i], max_distances[i]});
+		}
+		fetcher.Fetch(candidates);
+	}
+
+	if (!fetcher.HasK()) {
+		// There are fewer than k visible rows in the index, the remaining nearest rows are not in the index
+		gstate.candidates.reset();
+		auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+		bind_data.table.GetStorage().InitializeScan(transaction, gstate.scan_state, gstate.column_ids);
+		gstate.full_scan = true;
+		return;
+	}
+
+	gstate.candidates->InitializeScan(gstate.candidates_scan);
+}
+
+static void RTreeIndexKNNScanExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &bind_data = data_p.bind_data->Cast<RTreeIndexKNNScanBindData>();
+	auto &gstate = data_p.global_state->Cast<RTreeIndexKNNScanGlobalState>();
+
+	if (!gstate.full_scan && !gstate.candidates) {
+		RTreeIndexKNNScanFetchCandidates(context, bind_data, gstate, output.GetTypes());
+	}
+
+	if (gstate.full_scan) {
+		auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+		bind_data.table.GetStorage().Scan(transaction, output, gstate.scan_state);
+		return;
+	}
+
+	gstate.candidates->Scan(gstate.candidates_scan, output);
+}
+
+//-------------------------------------------------------------------------
+// Statistics
+//-------------------------------------------------------------------------
+static unique_ptr<BaseStatistics> RTreeIndexKNNScanStatistics(ClientContext &context, const FunctionData *bind_data_p,
+                                                              column_t column_id) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+	if (local_storage.Find(bind_data.table.GetStorage())) {
+		// we don't emit any statistics for tables that have outstanding transaction-local data
+		return nullptr;
+	}
+	return bind_data.table.GetStatistics(context, column_id);
+}
+
+//-------------------------------------------------------------------------
+// Dependency
+//-------------------------------------------------------------------------
+static void RTreeIndexKNNScanDependency(LogicalDependencyList &entries, const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	entries.AddDependency(bind_data.table);
+}
+
+//-------------------------------------------------------------------------
+// Cardinality
+//-------------------------------------------------------------------------
+static unique_ptr<NodeStatistics> RTreeIndexKNNScanCardinality(ClientContext &context,
+                                                               const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	auto &local_storage = LocalStorage::Get(context, bind_data.table.catalog);
+	const auto &storage = bind_data.table.GetStorage();
+	const auto table_rows = storage.GetTotalRows() + local_storage.AddedRows(bind_data.table.GetStorage());
+	return make_uniq<NodeStatistics>(MinValue<idx_t>(bind_data.k, table_rows), table_rows);
+}
+
+//-------------------------------------------------------------------------
+// ToString
+//-------------------------------------------------------------------------
+static string RTreeIndexKNNScanToString(const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	return bind_data.table.name + " (RTREE INDEX KNN SCAN : " + bind_data.index.GetIndexName() + ")";
+}
+
+//-------------------------------------------------------------------------
+// De/Serialize
+//-------------------------------------------------------------------------
+static void RTreeKNNScanSerialize(Serializer &serializer, const optional_ptr<FunctionData> bind_data_p,
+                                  const TableFunction &function) {
+	auto &bind_data = bind_data_p->Cast<RTreeIndexKNNScanBindData>();
+	serializer.WriteProperty(100, "catalog", bind_data.table.schema.catalog.GetName());
+	serializer.WriteProperty(101, "schema", bind_data.table.schema.name);
+	serializer.WriteProperty(102, "table", bind_data.table.name);
+	serializer.WriteProperty(103, "index_name", bind_data.index.GetIndexName());
+	serializer.WriteProperty<double>(104, "x", bind_data.point.x);
+	serializer.WriteProperty<double>(105, "y", bind_data.point.y);
+	serializer.WriteProperty<idx_t>(106, "k", bind_data.k);
+	serializer.WriteProperty<column_t>(107, "geom_column", bind_data.geom_column);
+}
+
+static unique_ptr<FunctionData> RTreeKNNScanDeserialize(Deserializer &deserializer, TableFunction &function) {
+	auto &context = deserializer.Get<ClientContext &>();
+
+	const auto catalog = deserializer.ReadProperty<string>(100, "catalog");
+	const auto schema = deserializer.ReadProperty<string>(101, "schema");
+	const auto table = deserializer.ReadProperty<string>(102, "table");
+	auto &catalog_entry = Catalog::GetEntry<TableCatalogEntry>(context, catalog, schema, table);
+	if (catalog_entry.type != CatalogType::TABLE_ENTRY) {
+		throw SerializationException("Cant find table for %s.%s", schema, table);
+	}
+
+	const auto index_name = deserializer.ReadProperty<string>(103, "index_name");
+	PointXY<double> point;
+	point.x = deserializer.ReadProperty<double>(104, "x");
+	point.y = deserializer.ReadProperty<double>(105, "y");
+	const auto k = deserializer.ReadProperty<idx_t>(106, "k");
+	const auto geom_column = deserializer.ReadProperty<column_t>(107, "geom_column");
+
+	auto &duck_table = catalog_entry.Cast<DuckTableEntry>();
+	auto &table_info = *catalog_entry.GetStorage().GetDataTableInfo();
+
+	unique_ptr<RTreeIndexKNNScanBindData> result = nullptr;
+	table_info.GetIndexes().BindAndScan<RTreeIndex>(context, table_info, [&](RTreeIndex &index_entry) {
+		if (index_entry.GetIndexName() == index_name) {
+			result = make_uniq<RTreeIndexKNNScanBindData>(duck_table, index_entry, geom_column, point, k);
+			return true;
+		}
+		return false;
+	});
+
+	if (!result) {
+		throw SerializationException("Could not find index %s on table %s.%s", index_name, schema, table);
+	}
+	return std::move(result);
+}
+
+//-------------------------------------------------------------------------
+// Get Function
+//-------------------------------------------------------------------------
+TableFunction RTreeIndexKNNScanFunction::GetFunction() {
+	TableFunction func("rtree_index_knn_scan", {}, RTreeIndexKNNScanExecute);
+	func.init_global = RTreeIndexKNNScanInitGlobal;
+	func.statistics = RTreeIndexKNNScanStatistics;
+	func.dependency = RTreeIndexKNNScanDependency;
+	func.cardinality = RTreeIndexKNNScanCardinality;
+	func.pushdown_complex_filter = nullptr;
+	func.to_string = RTreeIndexKNNScanToString;
+	func.projection_pushdown = true;
+	func.filter_pushdown = false;
+	func.get_bind_info = RTreeIndexKNNScanBindInfo;
+	func.serialize = RTreeKNNScanSerialize;
+	func.deserialize = RTreeKNNScanDeserialize;
+
+	return func;
+}
+
+//-------------------------------------------------------------------------
+// Register
+//-------------------------------------------------------------------------
+void RTreeModule::RegisterIndexKNNScan(DatabaseInstance &db) {
+	ExtensionUtil::RegisterFunction(db, RTreeIndexKNNScanFunction::GetFunction());
+}
+
+} // namespace core
+
+} // namespace spatial
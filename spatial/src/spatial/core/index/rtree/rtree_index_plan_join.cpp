@@ -0,0 +1,267 @@
+#include "duckdb/catalog/catalog_entry/duck_table_entry.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/operator/logical_any_join.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/transaction/local_storage.hpp"
+#include "spatial/core/index/rtree/rtree_index.hpp"
+#include "spatial/core/index/rtree/rtree_index_join_logical.hpp"
+#include "spatial/core/index/rtree/rtree_module.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//-----------------------------------------------------------------------------
+// Plan rewriter
+//-----------------------------------------------------------------------------
+//
+//	Rewrites inner joins on a spatial predicate where one side is a plain table scan of a table with an RTree index
+//  over the predicate argument into an index nested loop join that probes the index for every row of the other side.
+//
+//  This runs before the RangeJoinSpatialPredicateRewriter, which would otherwise turn the join into an
+//  inequality join over the bounding boxes of both sides.
+//
+class RTreeIndexJoinOptimizer : public OptimizerExtension {
+public:
+	RTreeIndexJoinOptimizer() {
+		optimize_function = RTreeIndexJoinOptimizer::Optimize;
+	}
+
+	static void RewriteIndexExpression(Index &index, LogicalGet &get, Expression &expr, bool &rewrite_possible) {
+		if (expr.type == ExpressionType::BOUND_COLUMN_REF) {
+			auto &bound_colref = expr.Cast<BoundColumnRefExpression>();
+			// bound column ref: rewrite to fit in the current set of bound column ids
+			bound_colref.binding.table_index = get.table_index;
+			auto &column_ids = index.GetColumnIds();
+			auto &get_column_ids = get.GetColumnIds();
+			column_t referenced_column = column_ids[bound_colref.binding.column_index];
+			// search for the referenced column in the set of column_ids
+			for (idx_t i = 0; i < get_column_ids.size(); i++) {
+				if (get_column_ids[i] == referenced_column) {
+					bound_colref.binding.column_index = i;
+					return;
+				}
+			}
+			// column id not found in bound columns in the LogicalGet: rewrite not possible
+			rewrite_possible = false;
+		}
+		ExpressionIterator::EnumerateChildren(
+		    expr, [&](Expression &child) { RewriteIndexExpression(index, get, child, rewrite_possible); });
+	}
+
+	static bool IsSpatialPredicate(const ScalarFunction &function) {
+		// Note that we cant use the index for st_disjoint, as disjoint geometries can have intersecting bounds
+		static const case_insensitive_set_t predicates = {
+		    "st_equals", "st_intersects", "st_touches",   "st_crosses",  "st_within",
+		    "st_contains", "st_overlaps", "st_covers", "st_coveredby", "st_containsproperly"};
+
+		if (predicates.find(function.name) == predicates.end()) {
+			return false;
+		}
+		if (function.arguments.size() != 2) {
+			return false;
+		}
+		if (function.arguments[0] != GeoTypes::GEOMETRY() || function.arguments[1] != GeoTypes::GEOMETRY()) {
+			return false;
+		}
+		return function.return_type == LogicalType::BOOLEAN;
+	}
+
+	// Check whether all the column references in the expression point to the given table indexes
+	static bool ReferencesOnly(Expression &expr, const unordered_set<idx_t> &table_indexes) {
+		unordered_set<idx_t> bindings;
+		LogicalJoin::GetExpressionBindings(expr, bindings);
+		for (auto &binding : bindings) {
+			if (table_indexes.find(binding) == table_indexes.end()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Try to find an RTree index on the table scanned by 'get' that matches one of the predicate arguments.
+	// Returns the index and sets 'probe_arg' to the index of the other argument.
+	static optional_ptr<RTreeIndex> TryGetIndex(ClientContext &context, LogicalGet &get,
+	                                            BoundFunctionExpression &predicate,
+	                                            const unordered_set<idx_t> &probe_tables, idx_t &probe_arg) {
+		if (get.function.name != "seq_scan") {
+			return nullptr;
+		}
+
+		// We cant probe the index if the table scan has filters pushed down into it
+		if (!get.table_filters.filters.empty() || (get.dynamic_filters && get.dynamic_filters->HasFilters())) {
+			return nullptr;
+		}
+
+		auto table_ptr = get.GetTable();
+		if (!table_ptr || !table_ptr->IsDuckTable()) {
+			return nullptr;
+		}
+
+		// Rows appended in this transaction are not in the index yet, use the regular join instead
+		auto &storage = table_ptr->GetStorage();
+		auto &local_storage = LocalStorage::Get(context, table_ptr->catalog);
+		if (local_storage.Find(storage)) {
+			return nullptr;
+		}
+
+		auto &table_info = *storage.GetDataTableInfo();
+
+		optional_ptr<RTreeIndex> result;
+		table_info.GetIndexes().BindAndScan<RTreeIndex>(context, table_info, [&](RTreeIndex &index_entry) {
+			auto index_expr = index_entry.unbound_expressions[0]->Copy();
+			bool rewrite_possible = true;
+			RewriteIndexExpression(index_entry, get, *index_expr, rewrite_possible);
+			if (!rewrite_possible) {
+				return false;
+			}
+
+			for (idx_t i = 0; i < 2; i++) {
+				auto &index_arg = *predicate.children[i];
+				auto &other_arg = *predicate.children[1 - i];
+				if (index_arg.Equals(*index_expr) && ReferencesOnly(other_arg, probe_tables)) {
+					probe_arg = 1 - i;
+					result = &index_entry;
+					return true;
+				}
+			}
+			return false;
+		});
+
+		return result;
+	}
+
+	static bool TryOptimize(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		auto &op = *plan;
+
+		// Look for an inner ANY_JOIN on a spatial predicate
+		if (op.type != LogicalOperatorType::LOGICAL_ANY_JOIN) {
+			return false;
+		}
+		auto &any_join = op.Cast<LogicalAnyJoin>();
+		if (any_join.join_type != JoinType::INNER) {
+			return false;
+		}
+		if (any_join.condition->type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &predicate = any_join.condition->Cast<BoundFunctionExpression>();
+		if (!IsSpatialPredicate(predicate.function)) {
+			return false;
+		}
+
+		// Look for an indexed table scan on either side. If both sides qualify, probe the index of the larger one.
+		optional_ptr<RTreeIndex> index;
+		idx_t inner_side = 0;
+		idx_t probe_arg = 0;
+
+		for (idx_t side = 0; side < 2; side++) {
+			auto &child = *any_join.children[side];
+			if (child.type != LogicalOperatorType::LOGICAL_GET) {
+				continue;
+			}
+			unordered_set<idx_t> probe_tables;
+			LogicalJoin::GetTableReferences(*any_join.children[1 - side], probe_tables);
+
+			idx_t side_probe_arg = 0;
+			auto side_index = TryGetIndex(context, child.Cast<LogicalGet>(), predicate, probe_tables, side_probe_arg);
+			if (!side_index) {
+				continue;
+			}
+			if (index && any_join.children[inner_side]->estimated_cardinality >= child.estimated_cardinality) {
+				continue;
+			}
+			index = side_index;
+			inner_side = side;
+			probe_arg = side_probe_arg;
+		}
+
+		if (!index) {
+			return false;
+		}
+
+		auto &get = any_join.children[inner_side]->Cast<LogicalGet>();
+		auto &table = *get.GetTable();
+
+		// Figure out which columns of the table scan we need to fetch
+		vector<column_t> inner_column_ids = get.GetColumnIds();
+		if (inner_column_ids.empty()) {
+			inner_column_ids.push_back(COLUMN_IDENTIFIER_ROW_ID);
+		}
+		vector<LogicalType> inner_types;
+		for (auto &id : inner_column_ids) {
+			inner_types.push_back(id == COLUMN_IDENTIFIER_ROW_ID ? LogicalType::ROW_TYPE : get.returned_types[id]);
+		}
+
+		// Combine the projection of the table scan with the projection map of the join
+		vector<idx_t> get_projection = get.projection_ids;
+		if (get_projection.empty()) {
+			for (idx_t i = 0; i < inner_column_ids.size(); i++) {
+				get_projection.push_back(i);
+			}
+		}
+		auto &inner_map = inner_side == 0 ? any_join.left_projection_map : any_join.right_projection_map;
+		vector<idx_t> inner_projection_ids;
+		if (inner_map.empty()) {
+			inner_projection_ids = get_projection;
+		} else {
+			for (auto &idx : inner_map) {
+				inner_projection_ids.push_back(get_projection[idx]);
+			}
+		}
+
+		auto &probe_child = any_join.children[1 - inner_side];
+		auto &probe_map = inner_side == 0 ? any_join.right_projection_map : any_join.left_projection_map;
+		vector<idx_t> probe_projection_ids = probe_map;
+		if (probe_projection_ids.empty()) {
+			const auto probe_column_count = probe_child->GetColumnBindings().size();
+			for (idx_t i = 0; i < probe_column_count; i++) {
+				probe_projection_ids.push_back(i);
+			}
+		}
+
+		// Create the index join
+		auto probe_key = predicate.children[probe_arg]->Copy();
+		auto index_join = make_uniq<LogicalRTreeIndexJoin>(
+		    table, *index, get.table_index, std::move(inner_column_ids), std::move(inner_types),
+		    std::move(inner_projection_ids), std::move(probe_projection_ids), inner_side == 0);
+
+		index_join->expressions.push_back(std::move(any_join.condition));
+		index_join->expressions.push_back(std::move(probe_key));
+		index_join->children.push_back(std::move(probe_child));
+		if (any_join.has_estimated_cardinality) {
+			index_join->estimated_cardinality = any_join.estimated_cardinality;
+			index_join->has_estimated_cardinality = true;
+		}
+		index_join->ResolveOperatorTypes();
+
+		plan = std::move(index_join);
+		return true;
+	}
+
+	static void Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+		TryOptimize(input.context, plan);
+
+		// Recursively optimize the children
+		for (auto &child : plan->children) {
+			Optimize(input, child);
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+// Register
+//-----------------------------------------------------------------------------
+void RTreeModule::RegisterIndexPlanJoin(DatabaseInstance &db) {
+	// Register the optimizer extension
+	db.config.optimizer_extensions.push_back(RTreeIndexJoinOptimizer());
+}
+
+} // namespace core
+
+} // namespace spatial
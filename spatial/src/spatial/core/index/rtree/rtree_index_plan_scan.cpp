@@ -9,6 +9,7 @@
 #include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/operator/logical_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
 #include "duckdb/planner/operator_extension.hpp"
 #include "duckdb/storage/data_table.hpp"
 #include "spatial/core/geometry/bbox.hpp"
@@ -231,8 +232,157 @@ public:
 		return true;
 	}
 
+	//-------------------------------------------------------------------------
+	// KNN
+	//-------------------------------------------------------------------------
+	// Look for a TOP_N ordered by ST_Distance(<indexed geometry>, <constant point>), e.g.
+	//
+	//	SELECT * FROM t ORDER BY ST_Distance(geom, ST_Point(1, 2)) LIMIT 10;
+	//
+	// and replace the table scan below it with a KNN index scan. The index scan only emits the rows that can be
+	// among the k nearest, the TOP_N is kept in place to compute the exact distances and order.
+	static bool TryGetPoint(const Value &value, PointXY<double> &point) {
+		const auto str = value.GetValueUnsafe<string_t>();
+		const geometry_t blob(str);
+
+		if (blob.GetType() != GeometryType::POINT) {
+			return false;
+		}
+
+		Box2D<double> bbox;
+		if (!blob.TryGetCachedBounds(bbox)) {
+			// Empty point
+			return false;
+		}
+
+		point.x = bbox.min.x;
+		point.y = bbox.min.y;
+		return true;
+	}
+
+	static bool TryOptimizeKNN(ClientContext &context, unique_ptr<LogicalOperator> &plan) {
+		auto &op = *plan;
+		if (op.type != LogicalOperatorType::LOGICAL_TOP_N) {
+			return false;
+		}
+
+		auto &top_n = op.Cast<LogicalTopN>();
+		if (top_n.orders.size() != 1) {
+			return false;
+		}
+		auto &order = top_n.orders[0];
+		if (order.type != OrderType::ASCENDING || order.null_order != OrderByNullType::NULLS_LAST) {
+			// NULL distances have to be sorted last, they are never part of the index
+			return false;
+		}
+
+		// The distance is usually computed in a projection below the TOP_N
+		auto child = top_n.children[0].get();
+		optional_ptr<Expression> order_expr = order.expression.get();
+		if (child->type == LogicalOperatorType::LOGICAL_PROJECTION) {
+			auto &proj = child->Cast<LogicalProjection>();
+			if (order_expr->type == ExpressionType::BOUND_COLUMN_REF) {
+				auto &colref = order_expr->Cast<BoundColumnRefExpression>();
+				if (colref.binding.table_index != proj.table_index) {
+					return false;
+				}
+				order_expr = proj.expressions[colref.binding.column_index].get();
+			}
+			child = proj.children[0].get();
+		}
+
+		if (order_expr->type != ExpressionType::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &distance_expr = order_expr->Cast<BoundFunctionExpression>();
+		if (!StringUtil::CIEquals(distance_expr.function.name, "st_distance")) {
+			return false;
+		}
+		if (distance_expr.children.size() != 2 || distance_expr.children[0]->return_type != GeoTypes::GEOMETRY() ||
+		    distance_expr.children[1]->return_type != GeoTypes::GEOMETRY()) {
+			return false;
+		}
+
+		// Look for a plain table scan
+		if (child->type != LogicalOperatorType::LOGICAL_GET) {
+			return false;
+		}
+		auto &get = child->Cast<LogicalGet>();
+		if (get.function.name != "seq_scan") {
+			return false;
+		}
+		if (!get.table_filters.filters.empty() || (get.dynamic_filters && get.dynamic_filters->HasFilters())) {
+			// Filtered rows could push the nearest rows out of the candidate set
+			return false;
+		}
+
+		auto &table = *get.GetTable();
+		if (!table.IsDuckTable()) {
+			return false;
+		}
+
+		// Find the constant point
+		const auto is_constant = [](const Expression &expr) {
+			return expr.type == ExpressionType::VALUE_CONSTANT;
+		};
+		const auto constant_idx = is_constant(*distance_expr.children[0]) ? 0 : 1;
+		if (!is_constant(*distance_expr.children[constant_idx])) {
+			return false;
+		}
+		auto &constant_value = distance_expr.children[constant_idx]->Cast<BoundConstantExpression>().value;
+		if (constant_value.IsNull()) {
+			return false;
+		}
+		PointXY<double> point;
+		if (!TryGetPoint(constant_value, point)) {
+			return false;
+		}
+		auto &geom_expr = *distance_expr.children[1 - constant_idx];
+		if (geom_expr.type != ExpressionType::BOUND_COLUMN_REF) {
+			// The scan has to find the EMPTY geometries (which are not indexed) in the column itself
+			return false;
+		}
+		auto &geom_colref = geom_expr.Cast<BoundColumnRefExpression>();
+		if (geom_colref.binding.table_index != get.table_index) {
+			return false;
+		}
+		const auto geom_column = get.GetColumnIds()[geom_colref.binding.column_index];
+
+		const auto k = top_n.limit + top_n.offset;
+		if (k < top_n.limit) {
+			// Overflow
+			return false;
+		}
+
+		auto &duck_table = table.Cast<DuckTableEntry>();
+		auto &table_info = *table.GetStorage().GetDataTableInfo();
+		unique_ptr<RTreeIndexKNNScanBindData> bind_data = nullptr;
+
+		table_info.GetIndexes().BindAndScan<RTreeIndex>(context, table_info, [&](RTreeIndex &index_entry) {
+			auto index_expr = index_entry.unbound_expressions[0]->Copy();
+			bool rewrite_possible = true;
+			RewriteIndexExpression(index_entry, get, *index_expr, rewrite_possible);
+			if (!rewrite_possible || !index_expr->Equals(geom_expr)) {
+				return false;
+			}
+			bind_data = make_uniq<RTreeIndexKNNScanBindData>(duck_table, index_entry, geom_column, point, k);
+			return true;
+		});
+
+		if (!bind_data) {
+			return false;
+		}
+
+		const auto cardinality = RTreeIndexKNNScanFunction::GetFunction().cardinality(context, bind_data.get());
+		get.function = RTreeIndexKNNScanFunction::GetFunction();
+		get.has_estimated_cardinality = cardinality->has_estimated_cardinality;
+		get.estimated_cardinality = cardinality->estimated_cardinality;
+		get.bind_data = std::move(bind_data);
+		return true;
+	}
+
 	static void OptimizeRecursive(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan, unique_ptr<LogicalOperator> &root) {
-		if (!TryOptimize(input.optimizer.binder, input.context, plan, root)) {
+		if (!TryOptimize(input.optimizer.binder, input.context, plan, root) && !TryOptimizeKNN(input.context, plan)) {
 			// No match: continue with the children
 			for (auto &child : plan->children) {
 				OptimizeRecursive(input, child, root);
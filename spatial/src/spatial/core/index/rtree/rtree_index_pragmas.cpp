@@ -206,6 +206,7 @@ static void RTreeIndexDumpExecute(ClientContext &context, TableFunctionInput &da
 
 	const auto &tree = *state.index.tree;
 
+	lock_guard<mutex> guard(state.index.GetNodeLock());
 	state.scanner.Scan(tree, [&](const RTreeEntry &entry, const idx_t &level) {
 		level_data[output_idx] = UnsafeNumericCast<int32_t>(level);
 		xmin_data[output_idx] = entry.bounds.min.x;
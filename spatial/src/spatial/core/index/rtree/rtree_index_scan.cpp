@@ -28,14 +28,31 @@ BindInfo RTreeIndexScanBindInfo(const optional_ptr<FunctionData> bind_data_p) {
 //-------------------------------------------------------------------------
 // Global State
 //-------------------------------------------------------------------------
+// The index scan is parallelized by splitting the subtrees intersecting the query bounds into work units that
+// threads pull from. Each thread then traverses its subtree with its own scanner and fetches the rows with its own
+// fetch state. The (cheap) traversal is serialized on the lock of the index, the fetches run in parallel.
+// The work unit index doubles as the batch index, so the output can be fed to order-preserving sinks.
+static constexpr idx_t RTREE_SCAN_UNITS_PER_THREAD = 4;
+
 struct RTreeIndexScanGlobalState : public GlobalTableFunctionState {
-	ColumnFetchState fetch_state;
 	TableScanState local_storage_state;
 	vector<storage_t> column_ids;
 
-	// Index scan state
-	unique_ptr<IndexScanState> index_state;
-	Vector row_ids = Vector(LogicalType::ROW_TYPE);
+	//! The subtrees to scan, in scan order
+	vector<RTreeEntry> work_units;
+	//! The next work unit to hand out
+	atomic<idx_t> next_unit {0};
+	//! The number of work units that have been fully scanned
+	atomic<idx_t> finished_units {0};
+
+	idx_t max_threads = 1;
+
+	//! How many row ids to collect and sort by storage order before fetching them (0 = fetch in index order)
+	idx_t sort_batch_size = 0;
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
 };
 
 static unique_ptr<GlobalTableFunctionState> RTreeIndexScanInitGlobal(ClientContext &context,
@@ -61,23 +78,145 @@ static unique_ptr<GlobalTableFunctionState> RTreeIndexScanInitGlobal(ClientConte
 	result->local_storage_state.Initialize(result->column_ids, input.filters.get());
 	local_storage.InitializeScan(bind_data.table.GetStorage(), result->local_storage_state.local_state, input.filters);
 
-	// Initialize the scan state for the index
-	result->index_state = bind_data.index.Cast<RTreeIndex>().InitializeScan(bind_data.bbox);
+	// Split the index into work units
+	const auto thread_count = context.db->NumberOfThreads();
+	auto &index = bind_data.index.Cast<RTreeIndex>();
+	{
+		lock_guard<mutex> guard(index.GetNodeLock());
+		index.PartitionScan(bind_data.bbox, thread_count * RTREE_SCAN_UNITS_PER_THREAD, result->work_units);
+	}
+
+	result->max_threads = MaxValue<idx_t>(1, MinValue<idx_t>(thread_count, result->work_units.size()));
+
+	Value sort_batch_size;
+	if (context.TryGetCurrentSetting(RTreeIndexScanFunction::SORT_BATCH_SIZE_SETTING, sort_batch_size)) {
+		result->sort_batch_size = sort_batch_size.GetValue<uint64_t>();
+	}
 
 	return std::move(result);
 }
 
+//-------------------------------------------------------------------------
+// Local State
+//-------------------------------------------------------------------------
+struct RTreeIndexScanLocalState : public LocalTableFunctionState {
+	ColumnFetchState fetch_state;
+
+	// Index scan state for the current work unit
+	unique_ptr<IndexScanState> index_state;
+	Vector row_ids = Vector(LogicalType::ROW_TYPE);
+
+	//! The current work unit, also used as the batch index
+	idx_t unit_idx = DConstants::INVALID_INDEX;
+
+	//! Buffered row ids of the current work unit, sorted by storage order
+	vector<row_t> sorted_row_ids;
+	idx_t sorted_offset = 0;
+
+	bool TryInitializeNextUnit(const RTreeIndex &index, const RTreeBounds &bbox, RTreeIndexScanGlobalState &gstate) {
+		if (unit_idx != DConstants::INVALID_INDEX) {
+			++gstate.finished_units;
+		}
+		unit_idx = gstate.next_unit++;
+		if (unit_idx >= gstate.work_units.size()) {
+			index_state = nullptr;
+			return false;
+		}
+		index_state = index.InitializeScan(bbox, gstate.work_units[unit_idx]);
+		return true;
+	}
+};
+
+static unique_ptr<LocalTableFunctionState> RTreeIndexScanInitLocal(ExecutionContext &context,
+                                                                   TableFunctionInitInput &input,
+                                                                   GlobalTableFunctionState *global_state) {
+	auto &bind_data = input.bind_data->Cast<RTreeIndexScanBindData>();
+	auto &gstate = global_state->Cast<RTreeIndexScanGlobalState>();
+
+	auto result = make_uniq<RTreeIndexScanLocalState>();
+	result->TryInitializeNextUnit(bind_data.index.Cast<RTreeIndex>(), bind_data.bbox, gstate);
+	return std::move(result);
+}
+
 //-------------------------------------------------------------------------
 // Execute
 //-------------------------------------------------------------------------
+// Scan the next vector of row ids from the index, in index order
+static idx_t RTreeIndexScanNext(const RTreeIndex &index, const RTreeIndexScanBindData &bind_data,
+                                RTreeIndexScanGlobalState &gstate, RTreeIndexScanLocalState &lstate) {
+	while (lstate.index_state) {
+		idx_t row_count;
+		{
+			lock_guard<mutex> guard(index.GetNodeLock());
+			row_count = index.Scan(*lstate.index_state, lstate.row_ids);
+		}
+		if (row_count != 0) {
+			return row_count;
+		}
+		// This work unit is exhausted, move on to the next one
+		lstate.TryInitializeNextUnit(index, bind_data.bbox, gstate);
+	}
+	return 0;
+}
+
+// Scan the next vector of row ids from the index, in storage order.
+// The row ids that the index emits are clustered spatially, not by row group, so fetching them in index order
+// jumps between row groups for every vector. Instead, we collect a larger batch of row ids from the current work
+// unit, sort them, and then fetch them vector by vector so that each vector touches as few row groups as possible.
+static idx_t RTreeIndexScanNextSorted(const RTreeIndex &index, const RTreeIndexScanBindData &bind_data,
+                                      RTreeIndexScanGlobalState &gstate, RTreeIndexScanLocalState &lstate) {
+	auto &buffer = lstate.sorted_row_ids;
+	while (lstate.sorted_offset >= buffer.size()) {
+		if (!lstate.index_state) {
+			return 0;
+		}
+
+		// Refill the buffer from the current work unit
+		buffer.clear();
+		lstate.sorted_offset = 0;
+
+		const auto row_id_data = FlatVector::GetData<row_t>(lstate.row_ids);
+		while (buffer.size() < gstate.sort_batch_size) {
+			idx_t row_count;
+			{
+				lock_guard<mutex> guard(index.GetNodeLock());
+				row_count = index.Scan(*lstate.index_state, lstate.row_ids);
+			}
+			if (row_count == 0) {
+				break;
+			}
+			buffer.insert(buffer.end(), row_id_data, row_id_data + row_count);
+		}
+
+		if (buffer.empty()) {
+			// This work unit is exhausted, move on to the next one
+			lstate.TryInitializeNextUnit(index, bind_data.bbox, gstate);
+			continue;
+		}
+
+		std::sort(buffer.begin(), buffer.end());
+	}
+
+	// Emit the next vector of sorted row ids
+	const auto row_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, buffer.size() - lstate.sorted_offset);
+	memcpy(FlatVector::GetData<row_t>(lstate.row_ids), buffer.data() + lstate.sorted_offset, row_count * sizeof(row_t));
+	lstate.sorted_offset += row_count;
+	return row_count;
+}
+
 static void RTreeIndexScanExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
 
 	auto &bind_data = data_p.bind_data->Cast<RTreeIndexScanBindData>();
-	auto &state = data_p.global_state->Cast<RTreeIndexScanGlobalState>();
+	auto &gstate = data_p.global_state->Cast<RTreeIndexScanGlobalState>();
+	auto &lstate = data_p.local_state->Cast<RTreeIndexScanLocalState>();
 	auto &transaction = DuckTransaction::Get(context, bind_data.table.catalog);
+	auto &index = bind_data.index.Cast<RTreeIndex>();
+
+	// Scan the index for row id's. We never mix rows from different work units in the same chunk, as the
+	// work unit determines the batch index of the chunk.
+	const auto row_count = gstate.sort_batch_size == 0 ? RTreeIndexScanNext(index, bind_data, gstate, lstate)
+	                                                   : RTreeIndexScanNextSorted(index, bind_data, gstate, lstate);
 
-	// Scan the index for row id's
-	auto row_count = bind_data.index.Cast<RTreeIndex>().Scan(*state.index_state, state.row_ids);
 	if (row_count == 0) {
 		// Short-circuit if the index had no more rows
 		output.SetCardinality(0);
@@ -85,8 +224,30 @@ static void RTreeIndexScanExecute(ClientContext &context, TableFunctionInput &da
 	}
 
 	// Fetch the data from the local storage given the row ids
-	bind_data.table.GetStorage().Fetch(transaction, output, state.column_ids, state.row_ids, row_count,
-	                                   state.fetch_state);
+	bind_data.table.GetStorage().Fetch(transaction, output, gstate.column_ids, lstate.row_ids, row_count,
+	                                   lstate.fetch_state);
+}
+
+//-------------------------------------------------------------------------
+// Progress
+//-------------------------------------------------------------------------
+static double RTreeIndexScanProgress(ClientContext &context, const FunctionData *bind_data_p,
+                                     const GlobalTableFunctionState *global_state) {
+	auto &gstate = global_state->Cast<RTreeIndexScanGlobalState>();
+	if (gstate.work_units.empty()) {
+		return 100.0;
+	}
+	const auto finished = MinValue<idx_t>(gstate.finished_units.load(), gstate.work_units.size());
+	return 100.0 * static_cast<double>(finished) / static_cast<double>(gstate.work_units.size());
+}
+
+//-------------------------------------------------------------------------
+// Batch Index
+//-------------------------------------------------------------------------
+static idx_t RTreeIndexScanGetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                                         LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<RTreeIndexScanLocalState>();
+	return lstate.unit_idx;
 }
 
 //-------------------------------------------------------------------------
@@ -200,15 +361,15 @@ static unique_ptr<FunctionData> RTreeScanDeserialize(Deserializer &deserializer,
 //-------------------------------------------------------------------------
 TableFunction RTreeIndexScanFunction::GetFunction() {
 	TableFunction func("rtree_index_scan", {}, RTreeIndexScanExecute);
-	func.init_local = nullptr;
+	func.init_local = RTreeIndexScanInitLocal;
 	func.init_global = RTreeIndexScanInitGlobal;
 	func.statistics = RTreeIndexScanStatistics;
 	func.dependency = RTreeIndexScanDependency;
 	func.cardinality = RTreeIndexScanCardinality;
 	func.pushdown_complex_filter = nullptr;
 	func.to_string = RTreeIndexScanToString;
-	func.table_scan_progress = nullptr;
-	func.get_batch_index = nullptr;
+	func.table_scan_progress = RTreeIndexScanProgress;
+	func.get_batch_index = RTreeIndexScanGetBatchIndex;
 	func.projection_pushdown = true;
 	func.filter_pushdown = false;
 	func.get_bind_info = RTreeIndexScanBindInfo;
@@ -223,6 +384,12 @@ TableFunction RTreeIndexScanFunction::GetFunction() {
 //-------------------------------------------------------------------------
 void RTreeModule::RegisterIndexScan(DatabaseInstance &db) {
 	ExtensionUtil::RegisterFunction(db, RTreeIndexScanFunction::GetFunction());
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption(RTreeIndexScanFunction::SORT_BATCH_SIZE_SETTING,
+	                          "The number of row ids the RTree index scan collects and sorts by storage order before "
+	                          "fetching them from the table. Set to 0 to fetch the rows in index order.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(RTreeIndexScanFunction::DEFAULT_SORT_BATCH_SIZE));
 }
 
 } // namespace core
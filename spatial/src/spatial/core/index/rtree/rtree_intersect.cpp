@@ -0,0 +1,120 @@
+#include "spatial/core/index/rtree/rtree_intersect.hpp"
+
+#if !defined(SPATIAL_RTREE_SCALAR_INTERSECT)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPATIAL_RTREE_INTERSECT_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define SPATIAL_RTREE_INTERSECT_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace spatial {
+
+namespace core {
+
+// The bounds are loaded straight out of the entries, make sure they are laid out as we expect
+static_assert(sizeof(RTreeBounds) == 4 * sizeof(float), "RTreeBounds must be four packed floats");
+
+uint64_t RTreeIntersect::MaskScalar(const RTreeEntry *entries, const idx_t count, const RTreeBounds &query) {
+	D_ASSERT(count <= MAX_BLOCK_SIZE);
+	uint64_t mask = 0;
+	for (idx_t i = 0; i < count; i++) {
+		mask |= static_cast<uint64_t>(query.Intersects(entries[i].bounds)) << i;
+	}
+	return mask;
+}
+
+#if defined(SPATIAL_RTREE_INTERSECT_SSE)
+
+uint64_t RTreeIntersect::Mask(const RTreeEntry *entries, const idx_t count, const RTreeBounds &query) {
+	D_ASSERT(count <= MAX_BLOCK_SIZE);
+
+	const auto q_min_x = _mm_set1_ps(query.min.x);
+	const auto q_min_y = _mm_set1_ps(query.min.y);
+	const auto q_max_x = _mm_set1_ps(query.max.x);
+	const auto q_max_y = _mm_set1_ps(query.max.y);
+
+	uint64_t mask = 0;
+	idx_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		// Load the bounds of four entries, and transpose them into min_x, min_y, max_x, max_y lanes
+		auto min_x = _mm_loadu_ps(&entries[i + 0].bounds.min.x);
+		auto min_y = _mm_loadu_ps(&entries[i + 1].bounds.min.x);
+		auto max_x = _mm_loadu_ps(&entries[i + 2].bounds.min.x);
+		auto max_y = _mm_loadu_ps(&entries[i + 3].bounds.min.x);
+		_MM_TRANSPOSE4_PS(min_x, min_y, max_x, max_y);
+
+		// Same as Box::Intersects, use the "not greater/not less" comparisons to get the same result for NaNs
+		auto hit = _mm_and_ps(_mm_cmpngt_ps(min_x, q_max_x), _mm_cmpnlt_ps(max_x, q_min_x));
+		hit = _mm_and_ps(hit, _mm_cmpngt_ps(min_y, q_max_y));
+		hit = _mm_and_ps(hit, _mm_cmpnlt_ps(max_y, q_min_y));
+
+		mask |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << i;
+	}
+
+	// Handle the remaining entries
+	if (i < count) {
+		mask |= MaskScalar(entries + i, count - i, query) << i;
+	}
+	return mask;
+}
+
+#elif defined(SPATIAL_RTREE_INTERSECT_NEON)
+
+uint64_t RTreeIntersect::Mask(const RTreeEntry *entries, const idx_t count, const RTreeBounds &query) {
+	D_ASSERT(count <= MAX_BLOCK_SIZE);
+
+	const auto q_min_x = vdupq_n_f32(query.min.x);
+	const auto q_min_y = vdupq_n_f32(query.min.y);
+	const auto q_max_x = vdupq_n_f32(query.max.x);
+	const auto q_max_y = vdupq_n_f32(query.max.y);
+
+	static const uint32_t lane_bits_data[4] = {1, 2, 4, 8};
+	const auto lane_bits = vld1q_u32(lane_bits_data);
+
+	uint64_t mask = 0;
+	idx_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		// Load the bounds of four entries, and transpose them into min_x, min_y, max_x, max_y lanes
+		const auto r0 = vld1q_f32(&entries[i + 0].bounds.min.x);
+		const auto r1 = vld1q_f32(&entries[i + 1].bounds.min.x);
+		const auto r2 = vld1q_f32(&entries[i + 2].bounds.min.x);
+		const auto r3 = vld1q_f32(&entries[i + 3].bounds.min.x);
+
+		const auto t01 = vtrnq_f32(r0, r1);
+		const auto t23 = vtrnq_f32(r2, r3);
+
+		const auto min_x = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		const auto min_y = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		const auto max_x = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		const auto max_y = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+
+		// Same as Box::Intersects, negate the "greater/less" comparisons to get the same result for NaNs
+		auto miss = vorrq_u32(vcgtq_f32(min_x, q_max_x), vcltq_f32(max_x, q_min_x));
+		miss = vorrq_u32(miss, vcgtq_f32(min_y, q_max_y));
+		miss = vorrq_u32(miss, vcltq_f32(max_y, q_min_y));
+
+		const auto hit_bits = vbicq_u32(lane_bits, miss);
+		mask |= static_cast<uint64_t>(vaddvq_u32(hit_bits)) << i;
+	}
+
+	// Handle the remaining entries
+	if (i < count) {
+		mask |= MaskScalar(entries + i, count - i, query) << i;
+	}
+	return mask;
+}
+
+#else
+
+uint64_t RTreeIntersect::Mask(const RTreeEntry *entries, const idx_t count, const RTreeBounds &query) {
+	return MaskScalar(entries, count, query);
+}
+
+#endif
+
+} // namespace core
+
+} // namespace spatial
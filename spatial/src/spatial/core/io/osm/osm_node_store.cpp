@@ -0,0 +1,81 @@
+#include "spatial/core/io/osm_node_store.hpp"
+
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace spatial {
+
+namespace core {
+
+OsmNodeStore::OsmNodeStore(BufferManager &manager) : locations(manager), last_id(NumericLimits<int64_t>::Minimum()) {
+	locations.InitializeAppend(append_state);
+}
+
+static void ThrowUnsortedNodes(int64_t id, int64_t last_id) {
+	throw InvalidInputException(
+	    "ST_ReadOSM: building geometries requires the nodes in the file to be sorted by id, but node %d comes "
+	    "after node %d",
+	    id, last_id);
+}
+
+void OsmNodeStore::Append(int64_t id, int32_t lat, int32_t lon) {
+	if (id <= last_id) {
+		ThrowUnsortedNodes(id, last_id);
+	}
+	last_id = id;
+
+	// Remember the first id of every block
+	if (locations.Count() % locations.BlockCapacity() == 0) {
+		block_first_ids.push_back(id);
+	}
+	locations.Append(append_state, OsmNodeLocation {id, lat, lon});
+}
+
+void OsmNodeStore::Finalize() {
+	append_state.handle.Destroy();
+	append_state.block = nullptr;
+}
+
+void OsmNodeStore::Combine(OsmNodeStore &other) {
+	if (other.Count() == 0) {
+		return;
+	}
+	if (other.block_first_ids[0] <= last_id) {
+		ThrowUnsortedNodes(other.block_first_ids[0], last_id);
+	}
+	block_first_ids.insert(block_first_ids.end(), other.block_first_ids.begin(), other.block_first_ids.end());
+	locations.Combine(other.locations);
+	last_id = other.last_id;
+	other.block_first_ids.clear();
+}
+
+bool OsmNodeStore::Reader::TryGet(int64_t id, double &lat, double &lon) {
+	auto &first_ids = store.block_first_ids;
+
+	// Do we need to pin another block?
+	const auto in_block = block_idx != DConstants::INVALID_INDEX && id >= first_ids[block_idx] &&
+	                      (block_idx + 1 == first_ids.size() || id < first_ids[block_idx + 1]);
+	if (!in_block) {
+		const auto next = std::upper_bound(first_ids.begin(), first_ids.end(), id);
+		if (next == first_ids.begin()) {
+			return false;
+		}
+		block_idx = static_cast<idx_t>(next - first_ids.begin()) - 1;
+		handle = store.locations.PinBlock(block_idx, block_count);
+	}
+
+	const auto begin = reinterpret_cast<const OsmNodeLocation *>(handle.Ptr());
+	const auto end = begin + block_count;
+	const auto entry = std::lower_bound(begin, end, id,
+	                                    [](const OsmNodeLocation &location, int64_t id) { return location.id < id; });
+	if (entry == end || entry->id != id) {
+		return false;
+	}
+
+	lat = entry->lat / 1e7;
+	lon = entry->lon / 1e7;
+	return true;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,97 @@
+#include "spatial/core/io/osm_way_store.hpp"
+
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace spatial {
+
+namespace core {
+
+OsmWayStore::OsmWayStore(BufferManager &manager) : refs(manager), last_id(NumericLimits<int64_t>::Minimum()) {
+	refs.InitializeAppend(append_state);
+}
+
+static void ThrowUnsortedWays(int64_t id, int64_t last_id) {
+	throw InvalidInputException(
+	    "ST_ReadOSM: building geometries requires the ways in the file to be sorted by id, but way %d comes "
+	    "after way %d",
+	    id, last_id);
+}
+
+void OsmWayStore::Append(int64_t way_id, const int64_t *refs_begin, const int64_t *refs_end) {
+	if (way_id <= last_id) {
+		ThrowUnsortedWays(way_id, last_id);
+	}
+	last_id = way_id;
+
+	for (auto ref = refs_begin; ref != refs_end; ref++) {
+		// Remember the first way id of every block
+		if (refs.Count() % refs.BlockCapacity() == 0) {
+			block_first_ids.push_back(way_id);
+		}
+		refs.Append(append_state, OsmWayRef {way_id, *ref});
+	}
+}
+
+void OsmWayStore::Finalize() {
+	append_state.handle.Destroy();
+	append_state.block = nullptr;
+}
+
+void OsmWayStore::Combine(OsmWayStore &other) {
+	if (other.Count() == 0) {
+		return;
+	}
+	if (other.block_first_ids[0] <= last_id) {
+		ThrowUnsortedWays(other.block_first_ids[0], last_id);
+	}
+	block_first_ids.insert(block_first_ids.end(), other.block_first_ids.begin(), other.block_first_ids.end());
+	refs.Combine(other.refs);
+	last_id = other.last_id;
+	other.block_first_ids.clear();
+}
+
+void OsmWayStore::Reader::Pin(idx_t idx) {
+	if (idx != block_idx) {
+		block_idx = idx;
+		handle = store.refs.PinBlock(block_idx, block_count);
+	}
+}
+
+bool OsmWayStore::Reader::TryGet(int64_t way_id, vector<int64_t> &result) {
+	auto &first_ids = store.block_first_ids;
+	result.clear();
+
+	// The way starts in the last block that begins with a smaller id, unless it is the very first way of a block.
+	const auto next = std::lower_bound(first_ids.begin(), first_ids.end(), way_id);
+	auto idx = static_cast<idx_t>(next - first_ids.begin());
+	if (idx == 0) {
+		if (first_ids.empty() || first_ids[0] != way_id) {
+			return false;
+		}
+	} else {
+		idx--;
+	}
+
+	// Copy the refs, following them into the next blocks
+	for (; idx < first_ids.size(); idx++) {
+		if (first_ids[idx] > way_id) {
+			break;
+		}
+		Pin(idx);
+		const auto begin = reinterpret_cast<const OsmWayRef *>(handle.Ptr());
+		const auto end = begin + block_count;
+		auto entry = std::lower_bound(begin, end, way_id,
+		                              [](const OsmWayRef &ref, int64_t id) { return ref.way_id < id; });
+		for (; entry != end && entry->way_id == way_id; entry++) {
+			result.push_back(entry->node_id);
+		}
+		if (entry != end) {
+			break;
+		}
+	}
+	return !result.empty();
+}
+
+} // namespace core
+
+} // namespace spatial
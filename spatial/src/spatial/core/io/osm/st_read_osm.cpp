@@ -1,16 +1,30 @@
 #include "duckdb/parser/parsed_data/create_table_function_info.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/function/replacement_scan.hpp"
+#include "duckdb/parallel/task_executor.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
 
 #include "spatial/common.hpp"
 #include "spatial/core/functions/table.hpp"
+#include "spatial/core/geometry/geometry.hpp"
+#include "spatial/core/io/osm_node_store.hpp"
+#include "spatial/core/io/osm_way_store.hpp"
 #include "spatial/core/types.hpp"
 
 #include "protozero/pbf_reader.hpp"
 #include "zlib.h"
+#include "zstd.h"
+#include "lz4.hpp"
 
 namespace spatial {
 
@@ -25,14 +39,134 @@ static int32_t ReadInt32BigEndian(data_ptr_t ptr) {
 	return (ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
 }
 
+using TagIterator = pz::iterator_range<pz::const_varint_iterator<uint32_t>>;
+using RefIterator = pz::iterator_range<pz::const_svarint_iterator<int64_t>>;
+using MemberIterator = pz::iterator_range<pz::const_varint_iterator<int32_t>>;
+
+// Find the value of a tag, returns nullptr if the entity doesn't have it
+static const string *FindTag(const vector<string> &string_table, const TagIterator &keys, const TagIterator &vals,
+                             const char *key) {
+	auto val = vals.begin();
+	for (auto k : keys) {
+		if (val == vals.end()) {
+			break;
+		}
+		if (string_table[k] == key) {
+			return &string_table[*val];
+		}
+		++val;
+	}
+	return nullptr;
+}
+
+// Keys that make a closed way an area, unless it is tagged area=no (roughly following osm2pgsql)
+static constexpr const char *AREA_KEYS[] = {"aeroway", "amenity",  "building", "building:part", "landuse",
+                                            "leisure", "man_made", "military", "natural",       "place",
+                                            "shop",    "tourism",  "water"};
+
+static bool IsAreaWay(const vector<string> &string_table, const TagIterator &keys, const TagIterator &vals) {
+	auto area = FindTag(string_table, keys, vals, "area");
+	if (area) {
+		return *area != "no";
+	}
+	auto val = vals.begin();
+	for (auto k : keys) {
+		if (val == vals.end()) {
+			break;
+		}
+		auto &key = string_table[k];
+		auto &value = string_table[*val++];
+		for (auto area_key : AREA_KEYS) {
+			// Coastlines are lines, the land and water polygons are built from them elsewhere
+			if (key == area_key && !(key == "natural" && value == "coastline")) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Read the string table, granularity and coordinate offsets of a primitive block.
+// Afterwards the reader is positioned at the primitive groups.
+static void ReadBlockHeader(pz::pbf_reader &block_reader, vector<string> &string_table, int32_t &granularity,
+                            int64_t &lat_offset, int64_t &lon_offset) {
+	string_table.clear();
+	granularity = 100;
+	lat_offset = 0;
+	lon_offset = 0;
+
+	block_reader.next(1); // String table
+	auto string_table_reader = block_reader.get_message();
+	while (string_table_reader.next(1)) {
+		string_table.push_back(string_table_reader.get_string());
+	}
+
+	// Need to read ahead without advancing block_reader
+	auto reader_copy = block_reader;
+
+	// Read the granularity and optional offsets
+	if (reader_copy.next(17)) {
+		granularity = reader_copy.get_int32();
+	}
+	if (reader_copy.next(19)) {
+		lat_offset = reader_copy.get_int64();
+	}
+	if (reader_copy.next(20)) {
+		lon_offset = reader_copy.get_int64();
+	}
+}
+
+// Convert a coordinate in nanodegrees to the 1e-7 degree fixed point precision of OSM
+static int32_t ToFixedPoint(int64_t nanodegrees) {
+	return static_cast<int32_t>((nanodegrees + (nanodegrees >= 0 ? 50 : -50)) / 100);
+}
+
 //------------------------------------------------------------------------------
 // OSM Table Function
 //------------------------------------------------------------------------------
 
+// The output columns
+static constexpr idx_t OSM_KIND = 0;
+static constexpr idx_t OSM_ID = 1;
+static constexpr idx_t OSM_TAGS = 2;
+static constexpr idx_t OSM_REFS = 3;
+static constexpr idx_t OSM_LAT = 4;
+static constexpr idx_t OSM_LON = 5;
+static constexpr idx_t OSM_REF_ROLES = 6;
+static constexpr idx_t OSM_REF_TYPES = 7;
+static constexpr idx_t OSM_GEOMETRY = 8;
+static constexpr idx_t OSM_COLUMN_COUNT = 9;
+
+// The values of the OSM_ENTITY_TYPE enum, in order
+static constexpr const char *OSM_KINDS[] = {"node", "way", "relation", "changeset"};
+
+// The entities that can pass the filters of the query. This is only used to skip entities early,
+// the filters themselves are still evaluated on the output.
+struct OsmPushdown {
+	// One bit per OSM_ENTITY_TYPE
+	uint8_t kinds = 0xF;
+	int64_t min_id = NumericLimits<int64_t>::Minimum();
+	int64_t max_id = NumericLimits<int64_t>::Maximum();
+	// Tag keys that all entities have to have
+	vector<string> required_keys;
+
+	bool HasKind(uint8_t kind) const {
+		return kinds & (1 << kind);
+	}
+	bool HasId(int64_t id) const {
+		return id >= min_id && id <= max_id;
+	}
+};
+
 struct BindData : TableFunctionData {
 	string file_name;
+	bool build_geometry;
+	// The number of blobs each thread reads at once
+	idx_t read_ahead;
+	OsmPushdown pushdown;
 
-	BindData(string file_name) : file_name(file_name) {
+	BindData(string file_name, bool build_geometry, idx_t read_ahead)
+	    : file_name(file_name), build_geometry(build_geometry), read_ahead(read_ahead) {
 	}
 };
 
@@ -40,7 +174,7 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
                                      vector<LogicalType> &return_types, vector<string> &names) {
 
 	// Create an enum type for all osm kinds
-	vector<string_t> enum_values = {"node", "way", "relation", "changeset"};
+	vector<string_t> enum_values(std::begin(OSM_KINDS), std::end(OSM_KINDS));
 	auto varchar_vector = Vector(LogicalType::VARCHAR, enum_values.size());
 	auto varchar_data = FlatVector::GetData<string_t>(varchar_vector);
 	for (idx_t i = 0; i < enum_values.size(); i++) {
@@ -83,6 +217,26 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 	    LogicalType::LIST(LogicalType::ENUM("OSM_REF_TYPE", member_varchar_vector, member_enum_values.size())));
 	names.push_back("ref_types");
 
+	auto build_geometry = false;
+	auto build_geometry_param = input.named_parameters.find("build_geometry");
+	if (build_geometry_param != input.named_parameters.end()) {
+		build_geometry = BooleanValue::Get(build_geometry_param->second);
+	}
+	if (build_geometry) {
+		return_types.push_back(GeoTypes::GEOMETRY());
+		names.push_back("geometry");
+	}
+
+	idx_t read_ahead = 8;
+	auto read_ahead_param = input.named_parameters.find("read_ahead");
+	if (read_ahead_param != input.named_parameters.end()) {
+		auto value = IntegerValue::Get(read_ahead_param->second);
+		if (value <= 0) {
+			throw BinderException("ST_ReadOSM: read_ahead must be a positive number of blobs");
+		}
+		read_ahead = static_cast<idx_t>(value);
+	}
+
 	// Create bind data
 	auto &config = DBConfig::GetConfig(context);
 	if (!config.options.enable_external_access) {
@@ -90,21 +244,221 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 	}
 
 	auto file_name = StringValue::Get(input.inputs[0]);
-	auto result = make_uniq<BindData>(file_name);
+	auto result = make_uniq<BindData>(file_name, build_geometry, read_ahead);
 	return std::move(result);
 }
 
-enum class FileBlockType { Header, Data };
+//------------------------------------------------------------------------------
+// Filter Pushdown
+//------------------------------------------------------------------------------
+// Returns the output column referenced by the expression, or DConstants::INVALID_INDEX
+static idx_t GetReferencedColumn(const LogicalGet &get, const Expression &expr) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return DConstants::INVALID_INDEX;
+	}
+	auto &colref = expr.Cast<BoundColumnRefExpression>();
+	if (colref.binding.table_index != get.table_index) {
+		return DConstants::INVALID_INDEX;
+	}
+	auto column_id = get.GetColumnIds()[colref.binding.column_index];
+	return column_id < OSM_COLUMN_COUNT ? column_id : DConstants::INVALID_INDEX;
+}
 
-struct OsmBlob {
-	FileBlockType type;
-	AllocatedData data;
-	idx_t size;
-	idx_t blob_idx;
+static bool IsColumn(const LogicalGet &get, const Expression &expr, idx_t column) {
+	// The kind is cast to VARCHAR when compared with a string that is not a valid enum value
+	if (column == OSM_KIND && expr.GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+		return IsColumn(get, *expr.Cast<BoundCastExpression>().child, column);
+	}
+	return GetReferencedColumn(get, expr) == column;
+}
+
+static bool TryGetConstant(const Expression &expr, Value &value) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	value = expr.Cast<BoundConstantExpression>().value;
+	return !value.IsNull();
+}
+
+// Returns the bit of the OSM_ENTITY_TYPE with the same name as the value
+static uint8_t GetKindMask(const Value &value) {
+	auto name = value.ToString();
+	for (idx_t i = 0; i < sizeof(OSM_KINDS) / sizeof(OSM_KINDS[0]); i++) {
+		if (name == OSM_KINDS[i]) {
+			return UnsafeNumericCast<uint8_t>(1 << i);
+		}
+	}
+	return 0;
+}
+
+static void PushdownIdComparison(OsmPushdown &pushdown, ExpressionType type, const Value &value) {
+	if (value.type().id() != LogicalTypeId::BIGINT) {
+		return;
+	}
+	auto id = BigIntValue::Get(value);
+	switch (type) {
+	case ExpressionType::COMPARE_EQUAL:
+		pushdown.min_id = MaxValue(pushdown.min_id, id);
+		pushdown.max_id = MinValue(pushdown.max_id, id);
+		break;
+	case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		pushdown.min_id = MaxValue(pushdown.min_id, id);
+		break;
+	case ExpressionType::COMPARE_GREATERTHAN:
+		if (id == NumericLimits<int64_t>::Maximum()) {
+			pushdown.kinds = 0;
+		} else {
+			pushdown.min_id = MaxValue(pushdown.min_id, id + 1);
+		}
+		break;
+	case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		pushdown.max_id = MinValue(pushdown.max_id, id);
+		break;
+	case ExpressionType::COMPARE_LESSTHAN:
+		if (id == NumericLimits<int64_t>::Minimum()) {
+			pushdown.kinds = 0;
+		} else {
+			pushdown.max_id = MinValue(pushdown.max_id, id - 1);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// Returns the key if the expression extracts the value of a tag, e.g. tags['key'][1] or element_at(tags, 'key')[1]
+static bool TryGetTagValueKey(const LogicalGet &get, const Expression &expr, string &key) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func = expr.Cast<BoundFunctionExpression>();
+	auto &name = func.function.name;
+	if (name == "map_extract_value" && func.children.size() == 2 && IsColumn(get, *func.children[0], OSM_TAGS)) {
+		Value value;
+		if (TryGetConstant(*func.children[1], value) && value.type().id() == LogicalTypeId::VARCHAR) {
+			key = StringValue::Get(value);
+			return true;
+		}
+		return false;
+	}
+	if ((name == "array_extract" || name == "list_extract") && func.children.size() == 2) {
+		auto &list = *func.children[0];
+		if (list.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+			return false;
+		}
+		auto &extract = list.Cast<BoundFunctionExpression>();
+		if ((extract.function.name != "map_extract" && extract.function.name != "element_at") ||
+		    extract.children.size() != 2 || !IsColumn(get, *extract.children[0], OSM_TAGS)) {
+			return false;
+		}
+		Value value;
+		if (TryGetConstant(*extract.children[1], value) && value.type().id() == LogicalTypeId::VARCHAR) {
+			key = StringValue::Get(value);
+			return true;
+		}
+	}
+	return false;
+}
+
+static void AddRequiredKey(OsmPushdown &pushdown, const string &key) {
+	if (std::find(pushdown.required_keys.begin(), pushdown.required_keys.end(), key) ==
+	    pushdown.required_keys.end()) {
+		pushdown.required_keys.push_back(key);
+	}
+}
+
+static void PushdownFilter(const LogicalGet &get, OsmPushdown &pushdown, const Expression &expr) {
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::BOUND_COMPARISON: {
+		auto &comparison = expr.Cast<BoundComparisonExpression>();
+		auto type = comparison.type;
+		const Expression *column = comparison.left.get();
+		Value value;
+		if (!TryGetConstant(*comparison.right, value)) {
+			if (!TryGetConstant(*comparison.left, value)) {
+				return;
+			}
+			column = comparison.right.get();
+			type = FlipComparisonExpression(type);
+		}
+		string key;
+		if (type == ExpressionType::COMPARE_EQUAL && IsColumn(get, *column, OSM_KIND)) {
+			pushdown.kinds &= GetKindMask(value);
+		} else if (IsColumn(get, *column, OSM_ID)) {
+			PushdownIdComparison(pushdown, type, value);
+		} else if (type != ExpressionType::COMPARE_DISTINCT_FROM && type != ExpressionType::COMPARE_NOT_DISTINCT_FROM &&
+		           TryGetTagValueKey(get, *column, key)) {
+			// The value is NULL if the entity doesn't have the tag, so the comparison can't be true
+			AddRequiredKey(pushdown, key);
+		}
+	} break;
+	case ExpressionClass::BOUND_BETWEEN: {
+		auto &between = expr.Cast<BoundBetweenExpression>();
+		Value lower;
+		Value upper;
+		if (!IsColumn(get, *between.input, OSM_ID) || !TryGetConstant(*between.lower, lower) ||
+		    !TryGetConstant(*between.upper, upper)) {
+			return;
+		}
+		PushdownIdComparison(pushdown,
+		                     between.lower_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+		                                             : ExpressionType::COMPARE_GREATERTHAN,
+		                     lower);
+		PushdownIdComparison(pushdown,
+		                     between.upper_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO
+		                                             : ExpressionType::COMPARE_LESSTHAN,
+		                     upper);
+	} break;
+	case ExpressionClass::BOUND_OPERATOR: {
+		auto &op = expr.Cast<BoundOperatorExpression>();
+		if (op.type == ExpressionType::COMPARE_IN && IsColumn(get, *op.children[0], OSM_KIND)) {
+			uint8_t kinds = 0;
+			for (idx_t i = 1; i < op.children.size(); i++) {
+				Value value;
+				if (!TryGetConstant(*op.children[i], value)) {
+					return;
+				}
+				kinds |= GetKindMask(value);
+			}
+			pushdown.kinds &= kinds;
+		}
+		string key;
+		if (op.type == ExpressionType::OPERATOR_IS_NOT_NULL &&
+		    TryGetTagValueKey(get, *op.children[0], key)) {
+			AddRequiredKey(pushdown, key);
+		}
+	} break;
+	case ExpressionClass::BOUND_FUNCTION: {
+		auto &func = expr.Cast<BoundFunctionExpression>();
+		Value value;
+		if (func.function.name == "map_contains" && func.children.size() == 2 &&
+		    IsColumn(get, *func.children[0], OSM_TAGS) && TryGetConstant(*func.children[1], value) &&
+		    value.type().id() == LogicalTypeId::VARCHAR) {
+			AddRequiredKey(pushdown, StringValue::Get(value));
+		}
+	} break;
+	default:
+		break;
+	}
+}
 
-	explicit OsmBlob(FileBlockType type, AllocatedData data, idx_t size, idx_t blob_idx)
-	    : type(type), data(std::move(data)), size(size), blob_idx(blob_idx) {
+// Look at the filters on kind, id and tags to skip entities (and whole blocks and groups) while reading.
+// The filters are not removed, they are still evaluated on the output.
+static void PushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                  vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<BindData>();
+	for (auto &filter : filters) {
+		PushdownFilter(get, bind_data.pushdown, *filter);
 	}
+}
+
+enum class FileBlockType { Header, Data };
+
+// The location of a blob in the file, as recorded by the header-only index pass
+struct OsmBlobEntry {
+	FileBlockType type;
+	idx_t offset; // offset of the Blob message, right after its BlobHeader
+	idx_t size;   // size of the Blob message
 };
 
 struct FileBlock {
@@ -118,92 +472,214 @@ struct FileBlock {
 	}
 };
 
-static unique_ptr<FileBlock> DecompressBlob(ClientContext &context, OsmBlob &blob) {
-
-	auto &buffer_manager = BufferManager::GetBufferManager(context);
-	pz::pbf_reader reader((const char *)blob.data.get(), blob.size);
-
-	// TODO: For now we assume they are all zlib compressed
-	reader.next(2);
-	auto blob_uncompressed_size = reader.get_int32();
-	reader.next(3);
-	auto view = reader.get_view();
-
-	auto uncompressed_handle = buffer_manager.GetBufferAllocator().Allocate(blob_uncompressed_size);
-	auto uncompressed_ptr = uncompressed_handle.get();
-
-	z_stream zstream = {};
-	zstream.avail_in = view.size();
-	zstream.next_in = (Bytef *)view.data();
-	zstream.avail_out = blob_uncompressed_size;
-	zstream.next_out = (Bytef *)uncompressed_ptr;
-	auto ok = inflateInit(&zstream);
-	if (ok != Z_OK) {
-		throw ParserException("Failed to initialize zlib");
-	}
-	ok = inflate(&zstream, Z_FINISH);
-	if (ok != Z_STREAM_END) {
-		throw ParserException("Failed to inflate zlib");
-	}
-	ok = inflateEnd(&zstream);
-	// Cool, we have the uncompressed data
-
-	return make_uniq<FileBlock>(blob.type, std::move(uncompressed_handle), blob_uncompressed_size, blob.blob_idx);
+// Decompresses the data of a blob into a buffer of its uncompressed size
+class OsmDecompressor {
+public:
+	virtual ~OsmDecompressor() = default;
+	virtual void Decompress(const char *data, idx_t size, data_ptr_t result, idx_t result_size) = 0;
 };
 
-class GlobalState : public GlobalTableFunctionState {
-	mutex lock;
-	unique_ptr<FileHandle> handle;
-	idx_t file_size;
-	idx_t offset;
-	bool done;
-	idx_t blob_index;
-	atomic<idx_t> bytes_read;
-	idx_t max_threads;
+class OsmRawDecompressor final : public OsmDecompressor {
+public:
+	void Decompress(const char *data, idx_t size, data_ptr_t result, idx_t result_size) override {
+		if (size != result_size) {
+			throw ParserException("ST_ReadOSM: raw blob is %d bytes, expected %d", size, result_size);
+		}
+		memcpy(result, data, size);
+	}
+};
 
+class OsmZlibDecompressor final : public OsmDecompressor {
 public:
-	GlobalState(unique_ptr<FileHandle> handle, idx_t file_size, idx_t max_threads)
-	    : handle(std::move(handle)), file_size(file_size), offset(0), done(false), blob_index(0), bytes_read(0),
-	      max_threads(max_threads) {
+	~OsmZlibDecompressor() override {
+		if (initialized) {
+			inflateEnd(&zstream);
+		}
 	}
 
-	double GetProgress() {
-		return 100 * ((double)bytes_read / (double)file_size);
+	void Decompress(const char *data, idx_t size, data_ptr_t result, idx_t result_size) override {
+		// Allocating the inflate state is relatively expensive, so reset and reuse it for the next blobs
+		if (!initialized) {
+			zstream = {};
+			if (inflateInit(&zstream) != Z_OK) {
+				throw ParserException("Failed to initialize zlib");
+			}
+			initialized = true;
+		} else if (inflateReset(&zstream) != Z_OK) {
+			throw ParserException("Failed to reset zlib");
+		}
+		zstream.avail_in = UnsafeNumericCast<uInt>(size);
+		zstream.next_in = (Bytef *)data;
+		zstream.avail_out = UnsafeNumericCast<uInt>(result_size);
+		zstream.next_out = (Bytef *)result;
+		if (inflate(&zstream, Z_FINISH) != Z_STREAM_END || zstream.total_out != result_size) {
+			throw ParserException("Failed to inflate zlib");
+		}
 	}
 
-	idx_t MaxThreads() const override {
-		return max_threads;
+private:
+	z_stream zstream;
+	bool initialized = false;
+};
+
+class OsmZstdDecompressor final : public OsmDecompressor {
+public:
+	~OsmZstdDecompressor() override {
+		if (dctx) {
+			duckdb_zstd::ZSTD_freeDCtx(dctx);
+		}
 	}
 
-	unique_ptr<OsmBlob> GetNextBlob(ClientContext &context) {
-		lock_guard<mutex> glock(lock);
+	void Decompress(const char *data, idx_t size, data_ptr_t result, idx_t result_size) override {
+		// Like the inflate state, the decompression context is created once and reused for the next blobs
+		if (!dctx) {
+			dctx = duckdb_zstd::ZSTD_createDCtx();
+			if (!dctx) {
+				throw ParserException("Failed to initialize zstd");
+			}
+		}
+		auto decompressed = duckdb_zstd::ZSTD_decompressDCtx(dctx, result, result_size, data, size);
+		if (duckdb_zstd::ZSTD_isError(decompressed)) {
+			throw ParserException("Failed to decompress zstd: %s", duckdb_zstd::ZSTD_getErrorName(decompressed));
+		}
+		if (decompressed != result_size) {
+			throw ParserException("Failed to decompress zstd: expected %d bytes, got %d", result_size, decompressed);
+		}
+	}
 
-		if (done) {
-			return nullptr;
+private:
+	duckdb_zstd::ZSTD_DCtx *dctx = nullptr;
+};
+
+class OsmLz4Decompressor final : public OsmDecompressor {
+public:
+	// Blobs are compressed as single LZ4 blocks, which don't need any decompression state
+	void Decompress(const char *data, idx_t size, data_ptr_t result, idx_t result_size) override {
+		auto decompressed =
+		    duckdb_lz4::LZ4_decompress_safe(data, char_ptr_cast(result), UnsafeNumericCast<int>(size),
+		                                    UnsafeNumericCast<int>(result_size));
+		if (decompressed < 0 || static_cast<idx_t>(decompressed) != result_size) {
+			throw ParserException("Failed to decompress lz4");
+		}
+	}
+};
+
+// Dispatches each blob to the decompressor for the field its data is stored in. The decompressors are created on
+// first use and kept, so that their state is reused for the following blobs. Each thread should use its own.
+class OsmBlobDecompressor {
+public:
+	unique_ptr<FileBlock> Decompress(ClientContext &context, const_data_ptr_t blob_data, idx_t blob_size,
+	                                 FileBlockType type, idx_t blob_idx) {
+		pz::pbf_reader reader((const char *)blob_data, blob_size);
+
+		uint32_t data_field = 0;
+		pz::data_view view;
+		idx_t uncompressed_size = 0;
+		bool has_uncompressed_size = false;
+		while (reader.next()) {
+			switch (reader.tag()) {
+			case 2: { // Raw size
+				uncompressed_size = UnsafeNumericCast<idx_t>(reader.get_int32());
+				has_uncompressed_size = true;
+			} break;
+			case 1:   // Raw
+			case 3:   // Zlib
+			case 4:   // Lzma
+			case 5:   // Bzip2 (obsolete)
+			case 6:   // Lz4
+			case 7: { // Zstd
+				data_field = reader.tag();
+				view = reader.get_view();
+			} break;
+			default:
+				reader.skip();
+			}
+		}
+		if (data_field == 0) {
+			throw ParserException("ST_ReadOSM: blob %d has no data", blob_idx);
 		}
-		if (offset >= file_size) {
-			done = true;
-			return nullptr;
+		// The uncompressed size is only required for compressed blobs
+		if (!has_uncompressed_size) {
+			if (data_field != 1) {
+				throw ParserException("ST_ReadOSM: compressed blob %d has no uncompressed size", blob_idx);
+			}
+			uncompressed_size = view.size();
 		}
 
 		auto &buffer_manager = BufferManager::GetBufferManager(context);
+		auto uncompressed_handle = buffer_manager.GetBufferAllocator().Allocate(uncompressed_size);
+		GetDecompressor(data_field).Decompress(view.data(), view.size(), uncompressed_handle.get(), uncompressed_size);
+
+		return make_uniq<FileBlock>(type, std::move(uncompressed_handle), uncompressed_size, blob_idx);
+	}
+
+private:
+	OsmDecompressor &GetDecompressor(uint32_t data_field) {
+		auto &decompressor = decompressors[data_field];
+		if (decompressor) {
+			return *decompressor;
+		}
+		switch (data_field) {
+		case 1:
+			decompressor = make_uniq<OsmRawDecompressor>();
+			break;
+		case 3:
+			decompressor = make_uniq<OsmZlibDecompressor>();
+			break;
+		case 4:
+			throw NotImplementedException("ST_ReadOSM: lzma compressed blobs are not supported");
+		case 5:
+			throw NotImplementedException("ST_ReadOSM: bzip2 compressed blobs are not supported");
+		case 6:
+			decompressor = make_uniq<OsmLz4Decompressor>();
+			break;
+		case 7:
+			decompressor = make_uniq<OsmZstdDecompressor>();
+			break;
+		default:
+			throw InternalException("ST_ReadOSM: unknown blob data field %d", data_field);
+		}
+		return *decompressor;
+	}
 
-		// The format is a repeating sequence of:
-		//    int4: length of the BlobHeader message in network byte order
-		//    serialized BlobHeader message
-		//    serialized Blob message (size is given in the header)
+	// Indexed by the field number of the data in the Blob message
+	unique_ptr<OsmDecompressor> decompressors[8];
+};
+
+// Read only the BlobHeaders of the file, to record where each blob is without reading the blobs themselves.
+static vector<OsmBlobEntry> IndexBlobs(FileHandle &handle, idx_t file_size) {
+	vector<OsmBlobEntry> entries;
+
+	// The format is a repeating sequence of:
+	//    int4: length of the BlobHeader message in network byte order
+	//    serialized BlobHeader message
+	//    serialized Blob message (size is given in the header)
+
+	// BlobHeaders are tiny, so the length and the header can usually be read at once
+	data_t buffer[64];
+	vector<data_t> large_header;
 
-		// Read the length of the BlobHeader
-		int32_t header_length_be = 0;
-		handle->Read((data_ptr_t)&header_length_be, sizeof(int32_t), offset);
+	idx_t offset = 0;
+	while (offset < file_size) {
+		const auto read_size = MinValue<idx_t>(sizeof(buffer), file_size - offset);
+		if (read_size < sizeof(int32_t)) {
+			throw ParserException("Unexpected end of file while reading a BlobHeader");
+		}
+		handle.Read(buffer, read_size, offset);
+		int32_t header_length = ReadInt32BigEndian(buffer);
 		offset += sizeof(int32_t);
-		int32_t header_length = ReadInt32BigEndian((data_ptr_t)&header_length_be);
+		if (header_length < 0 || offset + header_length > file_size) {
+			throw ParserException("Invalid BlobHeader length");
+		}
 
-		// Read the BlobHeader
-		auto header_buffer = buffer_manager.GetBufferAllocator().Allocate(header_length);
-		handle->Read(header_buffer.get(), header_length, offset);
+		auto header_ptr = (const char *)buffer + sizeof(int32_t);
+		if (sizeof(int32_t) + header_length > read_size) {
+			large_header.resize(header_length);
+			handle.Read(large_header.data(), header_length, offset);
+			header_ptr = (const char *)large_header.data();
+		}
 
-		pz::pbf_reader reader((const char *)header_buffer.get(), header_length);
+		pz::pbf_reader reader(header_ptr, header_length);
 
 		// 1 - type of the blob
 		reader.next(1);
@@ -221,15 +697,401 @@ public:
 		auto blob_length = reader.get_int32(); // size of the next blob
 
 		offset += header_length;
+		entries.push_back(OsmBlobEntry {type, offset, static_cast<idx_t>(blob_length)});
+		offset += blob_length;
+	}
 
-		// Read the Blob
-		auto blob_buffer = buffer_manager.GetBufferAllocator().Allocate(blob_length);
-		handle->Read(blob_buffer.get(), blob_length, offset);
+	return entries;
+}
 
-		offset += blob_length;
-		bytes_read = offset;
+// Read the blobs [begin, end) into the buffer. The blobs are adjacent in the file, so this is a single read.
+// Returns the number of bytes read.
+static idx_t ReadBlobRange(ClientContext &context, FileHandle &handle, const vector<OsmBlobEntry> &blobs, idx_t begin,
+                           idx_t end, AllocatedData &buffer) {
+	const auto offset = blobs[begin].offset;
+	const auto size = blobs[end - 1].offset + blobs[end - 1].size - offset;
+	if (buffer.GetSize() < size) {
+		buffer = BufferManager::GetBufferManager(context).GetBufferAllocator().Allocate(size);
+	}
+	handle.Read(buffer.get(), size, offset);
+	return size;
+}
+
+//------------------------------------------------------------------------------
+// Geometry Index
+//------------------------------------------------------------------------------
+// To build geometries, the file is read once up front to collect everything needed to resolve refs:
+// the locations of all nodes, and the refs of all ways that are members of multipolygon relations.
+
+struct GeometryIndex {
+	OsmNodeStore nodes;
+	// The refs of the member ways of area relations
+	OsmWayStore area_ways;
+
+	explicit GeometryIndex(BufferManager &manager) : nodes(manager), area_ways(manager) {
+	}
+};
 
-		return make_uniq<OsmBlob>(type, std::move(blob_buffer), blob_length, blob_index++);
+// Multipolygon and boundary relations are areas, their member ways form the rings
+static bool IsAreaRelation(const vector<string> &string_table, const TagIterator &keys, const TagIterator &vals) {
+	auto type = FindTag(string_table, keys, vals, "type");
+	return type && (*type == "multipolygon" || *type == "boundary");
+}
+
+// Add the nodes of the block to the node store, and collect the ids of the member ways of area relations.
+// Returns true if the block contains ways.
+static bool IndexBlock(const FileBlock &block, OsmNodeStore &nodes, vector<int64_t> &area_way_ids) {
+	pz::pbf_reader block_reader((const char *)block.data.get(), block.size);
+
+	vector<string> string_table;
+	int32_t granularity;
+	int64_t lat_offset;
+	int64_t lon_offset;
+	ReadBlockHeader(block_reader, string_table, granularity, lat_offset, lon_offset);
+
+	auto has_ways = false;
+	while (block_reader.next(2)) {
+		auto group_reader = block_reader.get_message();
+		while (group_reader.next()) {
+			switch (group_reader.tag()) {
+			// Nodes
+			case 1: {
+				auto node = group_reader.get_message();
+				int64_t id = 0;
+				int64_t lat = 0;
+				int64_t lon = 0;
+				while (node.next()) {
+					switch (node.tag()) {
+					case 1:
+						id = node.get_int64();
+						break;
+					case 8:
+						lat = node.get_sint64();
+						break;
+					case 9:
+						lon = node.get_sint64();
+						break;
+					default:
+						node.skip();
+					}
+				}
+				nodes.Append(id, ToFixedPoint(lat_offset + granularity * lat),
+				             ToFixedPoint(lon_offset + granularity * lon));
+			} break;
+			// Dense nodes
+			case 2: {
+				auto dense_nodes = group_reader.get_message();
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> ids;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> lats;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> lons;
+				while (dense_nodes.next()) {
+					switch (dense_nodes.tag()) {
+					case 1:
+						ids = dense_nodes.get_packed_sint64();
+						break;
+					case 8:
+						lats = dense_nodes.get_packed_sint64();
+						break;
+					case 9:
+						lons = dense_nodes.get_packed_sint64();
+						break;
+					default:
+						dense_nodes.skip();
+					}
+				}
+				int64_t id = 0;
+				int64_t lat = 0;
+				int64_t lon = 0;
+				auto lat_iter = lats.begin();
+				auto lon_iter = lons.begin();
+				for (auto id_delta : ids) {
+					if (lat_iter == lats.end() || lon_iter == lons.end()) {
+						throw ParserException("Dense nodes have fewer coordinates than ids");
+					}
+					id += id_delta;
+					lat += *lat_iter++;
+					lon += *lon_iter++;
+					nodes.Append(id, ToFixedPoint(lat_offset + granularity * lat),
+					             ToFixedPoint(lon_offset + granularity * lon));
+				}
+			} break;
+			// Ways, these are indexed in the second pass
+			case 3: {
+				has_ways = true;
+				group_reader.skip();
+			} break;
+			// Relations
+			case 4: {
+				auto relation = group_reader.get_message();
+				TagIterator key_iter;
+				TagIterator val_iter;
+				pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+				pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter;
+				while (relation.next()) {
+					switch (relation.tag()) {
+					case 2:
+						key_iter = relation.get_packed_uint32();
+						break;
+					case 3:
+						val_iter = relation.get_packed_uint32();
+						break;
+					case 9:
+						ref_iter = relation.get_packed_sint64();
+						break;
+					case 10:
+						type_iter = relation.get_packed_int32();
+						break;
+					default:
+						relation.skip();
+					}
+				}
+				if (!IsAreaRelation(string_table, key_iter, val_iter)) {
+					break;
+				}
+				int64_t ref = 0;
+				auto type = type_iter.begin();
+				for (auto ref_delta : ref_iter) {
+					ref += ref_delta;
+					if (type != type_iter.end() && *type++ == 1) {
+						area_way_ids.push_back(ref);
+					}
+				}
+			} break;
+			default: {
+				group_reader.skip();
+			} break;
+			}
+		}
+	}
+	return has_ways;
+}
+
+// Store the refs of the ways in the block that are members of area relations, the ids have to be sorted
+static void IndexWays(const FileBlock &block, const vector<int64_t> &area_way_ids, OsmWayStore &ways,
+                      vector<int64_t> &refs) {
+	pz::pbf_reader block_reader((const char *)block.data.get(), block.size);
+
+	vector<string> string_table;
+	int32_t granularity;
+	int64_t lat_offset;
+	int64_t lon_offset;
+	ReadBlockHeader(block_reader, string_table, granularity, lat_offset, lon_offset);
+
+	while (block_reader.next(2)) {
+		auto group_reader = block_reader.get_message();
+		while (group_reader.next(3)) {
+			auto way = group_reader.get_message();
+			int64_t id = 0;
+			pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+			while (way.next()) {
+				switch (way.tag()) {
+				case 1:
+					id = way.get_int64();
+					break;
+				case 8:
+					ref_iter = way.get_packed_sint64();
+					break;
+				default:
+					way.skip();
+				}
+			}
+			if (!std::binary_search(area_way_ids.begin(), area_way_ids.end(), id)) {
+				continue;
+			}
+			refs.clear();
+			int64_t ref = 0;
+			for (auto ref_delta : ref_iter) {
+				ref += ref_delta;
+				refs.push_back(ref);
+			}
+			ways.Append(id, refs.data(), refs.data() + refs.size());
+		}
+	}
+}
+
+// The part of the geometry index built by one thread, from a contiguous part of the file. The partitions are combined
+// in file order, so that the nodes and ways stay sorted by id.
+struct GeometryIndexPartition {
+	idx_t blob_begin;
+	idx_t blob_end;
+	OsmNodeStore nodes;
+	OsmWayStore area_ways;
+	// The member ways of the area relations in this partition, the ways themselves can be in any partition
+	vector<int64_t> area_way_ids;
+	// The blobs of this partition that contain ways
+	vector<idx_t> way_blobs;
+
+	GeometryIndexPartition(BufferManager &manager, idx_t blob_begin, idx_t blob_end)
+	    : blob_begin(blob_begin), blob_end(blob_end), nodes(manager), area_ways(manager) {
+	}
+};
+
+// Indexes the blobs of one partition, reading them in ranges of read_ahead blobs like the scan does.
+// The first pass indexes the nodes and relations, the second pass the ways.
+class GeometryIndexTask final : public BaseExecutorTask {
+public:
+	GeometryIndexTask(TaskExecutor &executor, ClientContext &context, FileHandle &handle,
+	                  const vector<OsmBlobEntry> &blobs, idx_t read_ahead, GeometryIndexPartition &partition,
+	                  const vector<int64_t> &area_way_ids, bool ways_pass)
+	    : BaseExecutorTask(executor), context(context), handle(handle), blobs(blobs), read_ahead(read_ahead),
+	      partition(partition), area_way_ids(area_way_ids), ways_pass(ways_pass) {
+	}
+
+	void ExecuteTask() override {
+		if (!ways_pass) {
+			for (auto begin = partition.blob_begin; begin < partition.blob_end; begin += read_ahead) {
+				const auto end = MinValue<idx_t>(begin + read_ahead, partition.blob_end);
+				ReadBlobRange(context, handle, blobs, begin, end, buffer);
+				for (auto blob_idx = begin; blob_idx < end; blob_idx++) {
+					if (IndexBlock(*Decompress(begin, blob_idx), partition.nodes, partition.area_way_ids)) {
+						partition.way_blobs.push_back(blob_idx);
+					}
+				}
+			}
+			return;
+		}
+
+		// The blobs with ways are usually adjacent, read runs of them at once
+		auto &way_blobs = partition.way_blobs;
+		vector<int64_t> refs;
+		for (idx_t i = 0; i < way_blobs.size();) {
+			const auto begin = way_blobs[i++];
+			auto end = begin + 1;
+			while (i < way_blobs.size() && way_blobs[i] == end && end - begin < read_ahead) {
+				end = way_blobs[i++] + 1;
+			}
+			ReadBlobRange(context, handle, blobs, begin, end, buffer);
+			for (auto blob_idx = begin; blob_idx < end; blob_idx++) {
+				IndexWays(*Decompress(begin, blob_idx), area_way_ids, partition.area_ways, refs);
+			}
+		}
+	}
+
+private:
+	// Decompress a blob of the range that starts at range_begin
+	unique_ptr<FileBlock> Decompress(idx_t range_begin, idx_t blob_idx) {
+		auto &entry = blobs[blob_idx];
+		auto blob_ptr = buffer.get() + (entry.offset - blobs[range_begin].offset);
+		return decompressor.Decompress(context, blob_ptr, entry.size, entry.type, blob_idx);
+	}
+
+	ClientContext &context;
+	FileHandle &handle;
+	const vector<OsmBlobEntry> &blobs;
+	idx_t read_ahead;
+	GeometryIndexPartition &partition;
+	const vector<int64_t> &area_way_ids;
+	bool ways_pass;
+
+	AllocatedData buffer;
+	OsmBlobDecompressor decompressor;
+};
+
+static unique_ptr<GeometryIndex> BuildGeometryIndex(ClientContext &context, FileHandle &handle,
+                                                    const vector<OsmBlobEntry> &blobs, idx_t max_threads,
+                                                    idx_t read_ahead) {
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+
+	// Split the ranges of blobs evenly over the threads
+	const auto range_count = (blobs.size() + read_ahead - 1) / read_ahead;
+	const auto partition_count = MaxValue<idx_t>(1, MinValue<idx_t>(max_threads, range_count));
+	vector<unique_ptr<GeometryIndexPartition>> partitions;
+	for (idx_t i = 0; i < partition_count; i++) {
+		const auto blob_begin = MinValue<idx_t>(i * range_count / partition_count * read_ahead, blobs.size());
+		const auto blob_end = MinValue<idx_t>((i + 1) * range_count / partition_count * read_ahead, blobs.size());
+		partitions.push_back(make_uniq<GeometryIndexPartition>(buffer_manager, blob_begin, blob_end));
+	}
+
+	// First pass: nodes and the members of area relations.
+	// Relations come after ways in the file, so each partition remembers where its ways are for the second pass.
+	vector<int64_t> area_way_ids;
+	{
+		TaskExecutor executor(context);
+		for (auto &partition : partitions) {
+			executor.ScheduleTask(make_uniq<GeometryIndexTask>(executor, context, handle, blobs, read_ahead,
+			                                                   *partition, area_way_ids, false));
+		}
+		executor.WorkOnTasks();
+	}
+
+	for (auto &partition : partitions) {
+		area_way_ids.insert(area_way_ids.end(), partition->area_way_ids.begin(), partition->area_way_ids.end());
+		partition->area_way_ids.clear();
+	}
+	std::sort(area_way_ids.begin(), area_way_ids.end());
+	area_way_ids.erase(std::unique(area_way_ids.begin(), area_way_ids.end()), area_way_ids.end());
+
+	// Second pass: the refs of the member ways
+	if (!area_way_ids.empty()) {
+		TaskExecutor executor(context);
+		for (auto &partition : partitions) {
+			if (!partition->way_blobs.empty()) {
+				executor.ScheduleTask(make_uniq<GeometryIndexTask>(executor, context, handle, blobs, read_ahead,
+				                                                   *partition, area_way_ids, true));
+			}
+		}
+		executor.WorkOnTasks();
+	}
+
+	// Move the blocks of the partitions into the index, in file order
+	auto index = make_uniq<GeometryIndex>(buffer_manager);
+	index->nodes.Finalize();
+	index->area_ways.Finalize();
+	for (auto &partition : partitions) {
+		partition->nodes.Finalize();
+		partition->area_ways.Finalize();
+		index->nodes.Combine(partition->nodes);
+		index->area_ways.Combine(partition->area_ways);
+	}
+	return index;
+}
+
+class GlobalState : public GlobalTableFunctionState {
+	unique_ptr<FileHandle> handle;
+	idx_t file_size;
+	atomic<idx_t> bytes_read;
+	idx_t max_threads;
+	idx_t read_ahead;
+	atomic<idx_t> next_blob;
+
+public:
+	// The data blobs of the file, in file order
+	vector<OsmBlobEntry> blobs;
+
+	// Only set when building geometries
+	unique_ptr<GeometryIndex> index;
+
+	GlobalState(unique_ptr<FileHandle> handle, idx_t file_size, idx_t max_threads, idx_t read_ahead,
+	            vector<OsmBlobEntry> blobs)
+	    : handle(std::move(handle)), file_size(file_size), bytes_read(0), read_ahead(read_ahead), next_blob(0),
+	      blobs(std::move(blobs)) {
+		// There is no point in more threads than there are ranges of blobs to claim
+		const auto range_count = (this->blobs.size() + read_ahead - 1) / read_ahead;
+		this->max_threads = MaxValue<idx_t>(1, MinValue<idx_t>(max_threads, range_count));
+	}
+
+	double GetProgress() {
+		return 100 * ((double)bytes_read / (double)file_size);
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+
+	// Claim the next range of blobs. Blobs are claimed with a single atomic increment, so that threads never wait on
+	// each other while reading. Returns false if all blobs have been claimed.
+	bool TryClaimBlobs(idx_t &begin, idx_t &end) {
+		begin = next_blob.fetch_add(read_ahead);
+		if (begin >= blobs.size()) {
+			return false;
+		}
+		end = MinValue<idx_t>(begin + read_ahead, blobs.size());
+		return true;
+	}
+
+	// Read a claimed range of blobs into the buffer. The blobs are adjacent in the file, so this is a single read.
+	void ReadBlobs(ClientContext &context, idx_t begin, idx_t end, AllocatedData &buffer) {
+		bytes_read += ReadBlobRange(context, *handle, blobs, begin, end, buffer);
 	}
 };
 
@@ -244,13 +1106,28 @@ static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, T
 
 	auto max_threads = context.db->NumberOfThreads();
 
-	auto global_state = make_uniq<GlobalState>(std::move(handle), file_size, max_threads);
-
-	// Read the first blob to get the header
-	auto blob = global_state->GetNextBlob(context);
-	if (blob->type != FileBlockType::Header) {
+	// Find all the blobs up front, so that the threads can read them without coordinating
+	auto entries = IndexBlobs(*handle, file_size);
+	if (entries.empty() || entries[0].type != FileBlockType::Header) {
 		throw ParserException("First blob in file is not a header");
 	}
+	vector<OsmBlobEntry> blobs;
+	for (auto &entry : entries) {
+		if (entry.type == FileBlockType::Data) {
+			blobs.push_back(entry);
+		}
+	}
+
+	// Only resolve the node locations if the geometry column is projected
+	unique_ptr<GeometryIndex> index;
+	auto &column_ids = input.column_ids;
+	if (bind_data.build_geometry && std::find(column_ids.begin(), column_ids.end(), OSM_GEOMETRY) != column_ids.end()) {
+		index = BuildGeometryIndex(context, *handle, blobs, max_threads, bind_data.read_ahead);
+	}
+
+	auto global_state =
+	    make_uniq<GlobalState>(std::move(handle), file_size, max_threads, bind_data.read_ahead, std::move(blobs));
+	global_state->index = std::move(index);
 
 	return std::move(global_state);
 }
@@ -262,8 +1139,51 @@ struct LocalState : LocalTableFunctionState {
 	int64_t lat_offset;
 	int64_t lon_offset;
 
-	explicit LocalState(unique_ptr<FileBlock> block) : block(std::move(block)) {
-		Reset();
+	// The entities the filters can let through
+	const OsmPushdown &pushdown;
+	// The string table index of each required tag key, for the current block
+	vector<uint32_t> required_keys;
+
+	// The projected columns, and the output vector of each column (nullptr if the column is not projected)
+	vector<column_t> column_ids;
+	Vector *columns[OSM_COLUMN_COUNT];
+
+	// Only set when building geometries
+	optional_ptr<const GeometryIndex> geometry_index;
+	unique_ptr<OsmNodeStore::Reader> node_reader;
+	unique_ptr<OsmWayStore::Reader> way_reader;
+	ArenaAllocator arena;
+	vector<int64_t> refs;
+	vector<VertexXY> vertices;
+
+	OsmBlobDecompressor decompressor;
+
+	// The blobs read ahead by this thread, [prefetch_next, prefetch_end) have not been parsed yet
+	AllocatedData prefetch_buffer;
+	idx_t prefetch_begin = 0;
+	idx_t prefetch_next = 0;
+	idx_t prefetch_end = 0;
+
+	LocalState(ClientContext &context, const OsmPushdown &pushdown, vector<column_t> column_ids,
+	           optional_ptr<const GeometryIndex> geometry_index)
+	    : pushdown(pushdown), column_ids(std::move(column_ids)), geometry_index(geometry_index),
+	      arena(BufferAllocator::Get(context)) {
+		if (geometry_index) {
+			node_reader = make_uniq<OsmNodeStore::Reader>(geometry_index->nodes);
+			way_reader = make_uniq<OsmWayStore::Reader>(geometry_index->area_ways);
+		}
+	}
+
+	void SetOutput(DataChunk &output) {
+		for (auto &column : columns) {
+			column = nullptr;
+		}
+		for (idx_t i = 0; i < column_ids.size(); i++) {
+			// Skip the row id, which is projected when no columns are
+			if (column_ids[i] < OSM_COLUMN_COUNT) {
+				columns[column_ids[i]] = &output.data[i];
+			}
+		}
 	}
 
 	void SetBlock(unique_ptr<FileBlock> block) {
@@ -271,34 +1191,39 @@ struct LocalState : LocalTableFunctionState {
 		Reset();
 	}
 
-	void Reset() {
-		string_table.clear();
-		granularity = 100;
-		lat_offset = 0;
-		lon_offset = 0;
-
-		block_reader = pz::pbf_reader((const char *)block->data.get(), block->size);
-		block_reader.next(1); // String table
-		auto string_table_reader = block_reader.get_message();
-		while (string_table_reader.next(1)) {
-			string_table.push_back(string_table_reader.get_string());
+	// Move on to the next blob, claiming and reading the next range of blobs once the prefetched ones are parsed.
+	// Returns false if there are no blobs left.
+	bool TryNextBlock(ClientContext &context, GlobalState &global) {
+		if (prefetch_next >= prefetch_end) {
+			if (!global.TryClaimBlobs(prefetch_begin, prefetch_end)) {
+				return false;
+			}
+			global.ReadBlobs(context, prefetch_begin, prefetch_end, prefetch_buffer);
+			prefetch_next = prefetch_begin;
 		}
+		auto &entry = global.blobs[prefetch_next];
+		auto blob_ptr = prefetch_buffer.get() + (entry.offset - global.blobs[prefetch_begin].offset);
+		SetBlock(decompressor.Decompress(context, blob_ptr, entry.size, entry.type, prefetch_next));
+		prefetch_next++;
+		return true;
+	}
 
-		// Need to read ahead without advancing block_reader
-		auto reader_copy = block_reader;
+	void Reset() {
+		block_reader = pz::pbf_reader((const char *)block->data.get(), block->size);
+		ReadBlockHeader(block_reader, string_table, granularity, lat_offset, lon_offset);
+		state = ParseState::Block;
 
-		// Read the granularity and optional offsets
-		if (reader_copy.next(17)) {
-			granularity = reader_copy.get_int32();
-		}
-		if (reader_copy.next(19)) {
-			lat_offset = reader_copy.get_int64();
-		}
-		if (reader_copy.next(20)) {
-			lon_offset = reader_copy.get_int64();
+		// Look up the required tag keys once per block. If one of them is not in the string table,
+		// none of the entities in the block can have it.
+		required_keys.clear();
+		for (auto &key : pushdown.required_keys) {
+			auto entry = std::find(string_table.begin(), string_table.end(), key);
+			if (entry == string_table.end()) {
+				state = ParseState::End;
+				return;
+			}
+			required_keys.push_back(UnsafeNumericCast<uint32_t>(entry - string_table.begin()));
 		}
-
-		state = ParseState::Block;
 	}
 
 	pz::pbf_reader block_reader;
@@ -317,7 +1242,7 @@ struct LocalState : LocalTableFunctionState {
 
 	// Returns false if there is data left to read but we've reached the capacity
 	// Returns true if block is empty and we are done
-	bool TryRead(DataChunk &output, idx_t &index, idx_t capacity) {
+	bool TryRead(idx_t &index, idx_t capacity) {
 		// Main finite state machine
 		while (index < capacity) {
 			switch (state) {
@@ -331,23 +1256,28 @@ struct LocalState : LocalTableFunctionState {
 				break;
 			case ParseState::Group:
 				if (group_reader.next()) {
+					// A group only contains entities of one kind, skip it entirely if the filters exclude that kind
+					if (!pushdown.HasKind(GetGroupKind(group_reader.tag()))) {
+						state = ParseState::Block;
+						break;
+					}
 					switch (group_reader.tag()) {
 					// Nodes
 					case 1: {
-						ScanNode(output, index, capacity);
+						ScanNode(index);
 					} break;
 					// Dense nodes
 					case 2: {
-						PrepareDenseNodes(output, index, capacity);
+						PrepareDenseNodes();
 						state = ParseState::DenseNodes;
 					} break;
 					// Way
 					case 3: {
-						ScanWay(output, index, capacity);
+						ScanWay(index);
 					} break;
 					// Relation
 					case 4: {
-						ScanRelation(output, index, capacity);
+						ScanRelation(index);
 					} break;
 					// Changeset
 					case 5: {
@@ -363,7 +1293,7 @@ struct LocalState : LocalTableFunctionState {
 				}
 				break;
 			case ParseState::DenseNodes: {
-				auto done = ScanDenseNodes(output, index, capacity);
+				auto done = ScanDenseNodes(index, capacity);
 				if (done) {
 					state = ParseState::Group;
 				}
@@ -376,19 +1306,122 @@ struct LocalState : LocalTableFunctionState {
 		return false;
 	}
 
-	void ScanNode(DataChunk &output, idx_t &index, idx_t capacity) {
+	// The OSM_ENTITY_TYPE of the entities in a PrimitiveGroup field
+	static uint8_t GetGroupKind(uint32_t tag) {
+		switch (tag) {
+		case 1:
+		case 2:
+			return 0;
+		case 3:
+			return 1;
+		case 4:
+			return 2;
+		default:
+			return 3;
+		}
+	}
+
+	bool HasRequiredKeys(const TagIterator &key_iter) const {
+		for (auto key : required_keys) {
+			if (std::find(key_iter.begin(), key_iter.end(), key) == key_iter.end()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//------------------------------------------------------------------------------
+	// Output
+	//------------------------------------------------------------------------------
+	template <class T>
+	void SetValue(idx_t column, idx_t index, T value) {
+		if (columns[column]) {
+			FlatVector::GetData<T>(*columns[column])[index] = value;
+		}
+	}
+
+	void SetNull(idx_t column, idx_t index) {
+		if (columns[column]) {
+			FlatVector::SetNull(*columns[column], index, true);
+		}
+	}
+
+	void WriteTags(idx_t index, const TagIterator &key_iter, const TagIterator &val_iter) {
+		if (!columns[OSM_TAGS]) {
+			return;
+		}
+		auto &tags = *columns[OSM_TAGS];
+		if (key_iter.empty() || val_iter.empty()) {
+			FlatVector::SetNull(tags, index, true);
+			return;
+		}
+
+		auto tag_count = key_iter.size();
+		auto total_tags = ListVector::GetListSize(tags);
+		ListVector::Reserve(tags, total_tags + tag_count);
+		ListVector::SetListSize(tags, total_tags + tag_count);
+		auto &tag_entry = ListVector::GetData(tags)[index];
+
+		tag_entry.offset = total_tags;
+		tag_entry.length = tag_count;
+
+		auto &key_vector = MapVector::GetKeys(tags);
+		auto &value_vector = MapVector::GetValues(tags);
+
+		auto keys = key_iter.begin();
+		auto vals = val_iter.begin();
+		for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
+			FlatVector::GetData<string_t>(key_vector)[i] = StringVector::AddString(key_vector, string_table[*keys++]);
+			FlatVector::GetData<string_t>(value_vector)[i] =
+			    StringVector::AddString(value_vector, string_table[*vals++]);
+		}
+	}
+
+	void WriteRefs(idx_t index, const RefIterator &ref_iter) {
+		if (!columns[OSM_REFS]) {
+			return;
+		}
+		auto &refs_vec = *columns[OSM_REFS];
+		if (ref_iter.empty()) {
+			FlatVector::SetNull(refs_vec, index, true);
+			return;
+		}
+
+		auto ref_count = ref_iter.size();
+		auto total_refs = ListVector::GetListSize(refs_vec);
+		ListVector::Reserve(refs_vec, total_refs + ref_count);
+		ListVector::SetListSize(refs_vec, total_refs + ref_count);
+		auto &ref_entry = ListVector::GetData(refs_vec)[index];
+		auto &ref_vector = ListVector::GetEntry(refs_vec);
+		ref_entry.offset = total_refs;
+		ref_entry.length = ref_count;
+
+		auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			ref_data[total_refs++] = last_ref;
+		}
+	}
+
+	void ScanNode(idx_t &index) {
 
 		auto node = group_reader.get_message();
 
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
+		int64_t id = 0;
+		TagIterator key_iter;
+		TagIterator val_iter;
+		int64_t lat = 0;
+		int64_t lon = 0;
 
 		while (node.next()) {
 			switch (node.tag()) {
 			case 1: { // ID
-				auto id = node.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 0;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
+				id = node.get_int64();
+				if (!pushdown.HasId(id)) {
+					return;
+				}
 			} break;
 			case 2: { // Tag Keys
 				key_iter = node.get_packed_uint32();
@@ -397,53 +1430,42 @@ struct LocalState : LocalTableFunctionState {
 				val_iter = node.get_packed_uint32();
 			} break;
 			case 8: { // Lat
-				auto lat = node.get_sint64();
-				FlatVector::GetData<double>(output.data[4])[index] = 0.000000001 * (lat_offset + (granularity * lat));
+				lat = node.get_sint64();
 			} break;
 			case 9: { // Lon
-				auto lon = node.get_sint64();
-				FlatVector::GetData<double>(output.data[5])[index] = 0.000000001 * (lon_offset + (granularity * lon));
+				lon = node.get_sint64();
 			} break;
 			default:
 				node.skip();
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
+		if (!HasRequiredKeys(key_iter)) {
+			return;
+		}
 
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
+		const auto lat_value = 0.000000001 * (lat_offset + (granularity * lat));
+		const auto lon_value = 0.000000001 * (lon_offset + (granularity * lon));
 
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
-			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
-		}
+		SetValue<uint8_t>(OSM_KIND, index, 0);
+		SetValue<int64_t>(OSM_ID, index, id);
+		SetValue<double>(OSM_LAT, index, lat_value);
+		SetValue<double>(OSM_LON, index, lon_value);
+		WriteTags(index, key_iter, val_iter);
 
 		// Node has no refs, ref_roles or ref_types
-		FlatVector::SetNull(output.data[3], index, true);
-		FlatVector::SetNull(output.data[6], index, true);
-		FlatVector::SetNull(output.data[7], index, true);
+		SetNull(OSM_REFS, index);
+		SetNull(OSM_REF_ROLES, index);
+		SetNull(OSM_REF_TYPES, index);
+
+		if (columns[OSM_GEOMETRY]) {
+			WriteNodeGeometry(index, lat_value, lon_value);
+		}
 
 		index++;
 	}
 
-	void PrepareDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	void PrepareDenseNodes() {
 		dense_node_index = 0;
 		dense_node_ids.clear();
 		dense_node_tags.clear();
@@ -498,23 +1520,21 @@ struct LocalState : LocalTableFunctionState {
 		}
 	}
 
-	void ScanWay(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanWay(idx_t &index) {
 		auto way = group_reader.get_message();
 
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
-		pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
+		int64_t id = 0;
+		TagIterator key_iter;
+		TagIterator val_iter;
+		RefIterator ref_iter;
 
 		while (way.next()) {
 			switch (way.tag()) {
 			case 1: { // ID
-				auto id = way.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 1;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
-				FlatVector::SetNull(output.data[6], index, true);
-				FlatVector::SetNull(output.data[7], index, true);
+				id = way.get_int64();
+				if (!pushdown.HasId(id)) {
+					return;
+				}
 			} break;
 			case 2: { // Tag Keys
 				key_iter = way.get_packed_uint32();
@@ -529,72 +1549,44 @@ struct LocalState : LocalTableFunctionState {
 				way.skip();
 			}
 		}
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
-
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
 
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
-
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
-			}
-		} else {
-			FlatVector::SetNull(output.data[2], index, true);
+		if (!HasRequiredKeys(key_iter)) {
+			return;
 		}
 
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
-
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
-
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
-			}
-		} else {
-			FlatVector::SetNull(output.data[3], index, true);
+		SetValue<uint8_t>(OSM_KIND, index, 1);
+		SetValue<int64_t>(OSM_ID, index, id);
+		SetNull(OSM_LAT, index);
+		SetNull(OSM_LON, index);
+		SetNull(OSM_REF_ROLES, index);
+		SetNull(OSM_REF_TYPES, index);
+		WriteTags(index, key_iter, val_iter);
+		WriteRefs(index, ref_iter);
+
+		if (columns[OSM_GEOMETRY]) {
+			WriteWayGeometry(index, key_iter, val_iter, ref_iter);
 		}
 
 		index++;
 	}
 
-	void ScanRelation(DataChunk &output, idx_t &index, idx_t capacity) {
+	void ScanRelation(idx_t &index) {
 		auto relation = group_reader.get_message();
 
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> key_iter;
-		pz::iterator_range<pz::const_varint_iterator<uint32_t>> val_iter;
-		pz::iterator_range<pz::const_varint_iterator<int32_t>> role_iter;
-		pz::iterator_range<pz::const_svarint_iterator<int64_t>> ref_iter;
-		pz::iterator_range<pz::const_varint_iterator<int32_t>> type_iter;
+		int64_t id = 0;
+		TagIterator key_iter;
+		TagIterator val_iter;
+		MemberIterator role_iter;
+		RefIterator ref_iter;
+		MemberIterator type_iter;
 
 		while (relation.next()) {
 			switch (relation.tag()) {
 			case 1: { // ID
-				auto id = relation.get_int64();
-				FlatVector::GetData<uint8_t>(output.data[0])[index] = 2;
-				FlatVector::GetData<int64_t>(output.data[1])[index] = id;
-				FlatVector::SetNull(output.data[4], index, true);
-				FlatVector::SetNull(output.data[5], index, true);
+				id = relation.get_int64();
+				if (!pushdown.HasId(id)) {
+					return;
+				}
 			} break;
 			case 2: { // Tag Keys
 				key_iter = relation.get_packed_uint32();
@@ -616,144 +1608,365 @@ struct LocalState : LocalTableFunctionState {
 			}
 		}
 
-		// Read tags
-		if (!key_iter.empty() && !val_iter.empty()) {
-			auto tag_count = key_iter.size();
+		if (!HasRequiredKeys(key_iter)) {
+			return;
+		}
 
-			auto total_tags = ListVector::GetListSize(output.data[2]);
-			ListVector::Reserve(output.data[2], total_tags + tag_count);
-			ListVector::SetListSize(output.data[2], total_tags + tag_count);
-			auto &tag_entry = ListVector::GetData(output.data[2])[index];
+		SetValue<uint8_t>(OSM_KIND, index, 2);
+		SetValue<int64_t>(OSM_ID, index, id);
+		SetNull(OSM_LAT, index);
+		SetNull(OSM_LON, index);
+		WriteTags(index, key_iter, val_iter);
+		WriteRefs(index, ref_iter);
 
-			tag_entry.offset = total_tags;
-			tag_entry.length = tag_count;
+		// Roles
+		if (columns[OSM_REF_ROLES]) {
+			auto &roles_vec = *columns[OSM_REF_ROLES];
+			if (!role_iter.empty()) {
+				auto role_count = role_iter.size();
+
+				auto total_roles = ListVector::GetListSize(roles_vec);
+				ListVector::Reserve(roles_vec, total_roles + role_count);
+				ListVector::SetListSize(roles_vec, total_roles + role_count);
+				auto &role_entry = ListVector::GetData(roles_vec)[index];
+				auto &role_vector = ListVector::GetEntry(roles_vec);
+				role_entry.offset = total_roles;
+				role_entry.length = role_count;
+
+				auto roles = role_iter.begin();
+				for (idx_t i = role_entry.offset; i < role_entry.offset + role_count; i++) {
+					auto &role_str = string_table[*roles++];
+					if (role_str.empty()) {
+						FlatVector::SetNull(role_vector, i, true);
+					} else {
+						FlatVector::GetData<string_t>(role_vector)[i] = StringVector::AddString(role_vector, role_str);
+					}
+				}
+			} else {
+				FlatVector::SetNull(roles_vec, index, true);
+			}
+		}
+
+		// Types
+		if (columns[OSM_REF_TYPES]) {
+			auto &types_vec = *columns[OSM_REF_TYPES];
+			if (!type_iter.empty()) {
+				auto type_count = type_iter.size();
+
+				auto total_types = ListVector::GetListSize(types_vec);
+				ListVector::Reserve(types_vec, total_types + type_count);
+				ListVector::SetListSize(types_vec, total_types + type_count);
+				auto &type_entry = ListVector::GetData(types_vec)[index];
+				auto &type_vector = ListVector::GetEntry(types_vec);
+				type_entry.offset = total_types;
+				type_entry.length = type_count;
+
+				auto type_data = FlatVector::GetData<uint8_t>(type_vector);
+				for (auto type : type_iter) {
+					type_data[total_types++] = (uint8_t)type;
+				}
+			} else {
+				FlatVector::SetNull(types_vec, index, true);
+			}
+		}
+
+		if (columns[OSM_GEOMETRY]) {
+			WriteRelationGeometry(index, key_iter, val_iter, role_iter, ref_iter, type_iter);
+		}
+
+		index++;
+	}
 
-			auto &key_vector = MapVector::GetKeys(output.data[2]);
-			auto &value_vector = MapVector::GetValues(output.data[2]);
+	//------------------------------------------------------------------------------
+	// Geometry
+	//------------------------------------------------------------------------------
+	void WriteNodeGeometry(idx_t index, double lat, double lon) {
+		auto &geom_vec = *columns[OSM_GEOMETRY];
+		auto point = Point::CreateFromVertex(arena, VertexXY {lon, lat});
+		FlatVector::GetData<geometry_t>(geom_vec)[index] = Geometry::Serialize(point, geom_vec);
+	}
 
-			auto keys = key_iter.begin();
-			auto vals = val_iter.begin();
-			for (idx_t i = tag_entry.offset; i < tag_entry.offset + tag_count; i++) {
-				FlatVector::GetData<string_t>(key_vector)[i] =
-				    StringVector::AddString(key_vector, string_table[*keys++]);
-				FlatVector::GetData<string_t>(value_vector)[i] =
-				    StringVector::AddString(value_vector, string_table[*vals++]);
+	// Look up the locations of the refs, skipping nodes that are missing from the store (e.g. clipped from an extract)
+	void ResolveRefs(const int64_t *begin, const int64_t *end) {
+		vertices.clear();
+		for (auto ref = begin; ref != end; ref++) {
+			double lat;
+			double lon;
+			if (node_reader->TryGet(*ref, lat, lon)) {
+				vertices.emplace_back(lon, lat);
 			}
+		}
+	}
+
+	Geometry CreateRing() {
+		return LineString::CreateFromCopy(arena, const_data_ptr_cast(vertices.data()), vertices.size(), false, false);
+	}
+
+	void WriteWayGeometry(idx_t index, const TagIterator &key_iter, const TagIterator &val_iter,
+	                      const RefIterator &ref_iter) {
+		auto &geom_vec = *columns[OSM_GEOMETRY];
+
+		refs.clear();
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			refs.push_back(last_ref);
+		}
+		ResolveRefs(refs.data(), refs.data() + refs.size());
+
+		if (vertices.size() < 2) {
+			FlatVector::SetNull(geom_vec, index, true);
+			return;
+		}
+
+		// Closed ways are polygons if they are tagged as areas, as long as none of their nodes are missing
+		const auto is_closed = refs.size() >= 4 && refs.front() == refs.back() && vertices.size() == refs.size();
+		if (is_closed && IsAreaWay(string_table, key_iter, val_iter)) {
+			auto polygon = Polygon::Create(arena, 1, false, false);
+			Polygon::Part(polygon, 0) = CreateRing();
+			FlatVector::GetData<geometry_t>(geom_vec)[index] = Geometry::Serialize(polygon, geom_vec);
 		} else {
-			FlatVector::SetNull(output.data[2], index, true);
+			auto line = CreateRing();
+			FlatVector::GetData<geometry_t>(geom_vec)[index] = Geometry::Serialize(line, geom_vec);
 		}
+	}
 
-		// Roles
-		if (!role_iter.empty()) {
-			auto role_count = role_iter.size();
-
-			auto total_roles = ListVector::GetListSize(output.data[6]);
-			ListVector::Reserve(output.data[6], total_roles + role_count);
-			ListVector::SetListSize(output.data[6], total_roles + role_count);
-			auto &role_entry = ListVector::GetData(output.data[6])[index];
-			auto &role_vector = ListVector::GetEntry(output.data[6]);
-			role_entry.offset = total_roles;
-			role_entry.length = role_count;
-
-			auto roles = role_iter.begin();
-			for (idx_t i = role_entry.offset; i < role_entry.offset + role_count; i++) {
-				auto &role_str = string_table[*roles++];
-				if (role_str.empty()) {
-					FlatVector::SetNull(role_vector, i, true);
-				} else {
-					FlatVector::GetData<string_t>(role_vector)[i] = StringVector::AddString(role_vector, role_str);
-				}
+	void WriteRelationGeometry(idx_t index, const TagIterator &key_iter, const TagIterator &val_iter,
+	                           const MemberIterator &role_iter, const RefIterator &ref_iter,
+	                           const MemberIterator &type_iter) {
+		auto &geom_vec = *columns[OSM_GEOMETRY];
+		if (!IsAreaRelation(string_table, key_iter, val_iter)) {
+			FlatVector::SetNull(geom_vec, index, true);
+			return;
+		}
+
+		// Collect the refs of the outer and inner member ways, members without a role are treated as outer
+		vector<vector<int64_t>> outer_ways;
+		vector<vector<int64_t>> inner_ways;
+		vector<int64_t> way_refs;
+		auto role = role_iter.begin();
+		auto type = type_iter.begin();
+		int64_t last_ref = 0;
+		for (auto ref : ref_iter) {
+			last_ref += ref;
+			if (role == role_iter.end() || type == type_iter.end()) {
+				break;
 			}
-		} else {
-			FlatVector::SetNull(output.data[6], index, true);
+			const auto is_inner = string_table[*role++] == "inner";
+			if (*type++ != 1) {
+				continue;
+			}
+			if (!way_reader->TryGet(last_ref, way_refs) || way_refs.size() < 2) {
+				continue;
+			}
+			(is_inner ? inner_ways : outer_ways).push_back(std::move(way_refs));
 		}
 
-		// Refs
-		if (!ref_iter.empty()) {
-			auto ref_count = ref_iter.size();
+		vector<vector<VertexXY>> outer_rings;
+		vector<vector<VertexXY>> inner_rings;
+		AssembleRings(outer_ways, outer_rings);
+		AssembleRings(inner_ways, inner_rings);
 
-			auto total_refs = ListVector::GetListSize(output.data[3]);
-			ListVector::Reserve(output.data[3], total_refs + ref_count);
-			ListVector::SetListSize(output.data[3], total_refs + ref_count);
-			auto &ref_entry = ListVector::GetData(output.data[3])[index];
-			auto &ref_vector = ListVector::GetEntry(output.data[3]);
-			ref_entry.offset = total_refs;
-			ref_entry.length = ref_count;
+		if (outer_rings.empty()) {
+			FlatVector::SetNull(geom_vec, index, true);
+			return;
+		}
 
-			auto ref_data = FlatVector::GetData<int64_t>(ref_vector);
+		// Each inner ring belongs to the smallest outer ring that contains it (outer rings can be nested, e.g. an
+		// island in a lake). Inner rings that no outer ring contains are kept as polygons of their own, like GDAL does
+		// for broken multipolygons, instead of losing their area.
+		vector<double> outer_areas;
+		for (auto &ring : outer_rings) {
+			outer_areas.push_back(RingArea(ring));
+		}
+		const auto outer_count = outer_rings.size();
+		vector<vector<idx_t>> holes(outer_count);
+		for (idx_t i = 0; i < inner_rings.size(); i++) {
+			optional_idx outer_idx;
+			for (idx_t j = 0; j < outer_count; j++) {
+				if ((!outer_idx.IsValid() || outer_areas[j] < outer_areas[outer_idx.GetIndex()]) &&
+				    RingContainsRing(outer_rings[j], inner_rings[i])) {
+					outer_idx = j;
+				}
+			}
+			if (outer_idx.IsValid()) {
+				holes[outer_idx.GetIndex()].push_back(i);
+			} else {
+				outer_rings.push_back(std::move(inner_rings[i]));
+				holes.emplace_back();
+			}
+		}
 
-			int64_t last_ref = 0;
-			for (auto ref : ref_iter) {
-				last_ref += ref;
-				ref_data[total_refs++] = last_ref;
+		vector<Geometry> polygons;
+		for (idx_t i = 0; i < outer_rings.size(); i++) {
+			auto polygon = Polygon::Create(arena, UnsafeNumericCast<uint32_t>(1 + holes[i].size()), false, false);
+			vertices = std::move(outer_rings[i]);
+			Polygon::Part(polygon, 0) = CreateRing();
+			for (idx_t j = 0; j < holes[i].size(); j++) {
+				vertices = std::move(inner_rings[holes[i][j]]);
+				Polygon::Part(polygon, j + 1) = CreateRing();
 			}
+			polygons.push_back(std::move(polygon));
+		}
+
+		if (polygons.size() == 1) {
+			FlatVector::GetData<geometry_t>(geom_vec)[index] = Geometry::Serialize(polygons[0], geom_vec);
 		} else {
-			FlatVector::SetNull(output.data[3], index, true);
+			auto multi_polygon = MultiPolygon::Create(arena, polygons, false, false);
+			FlatVector::GetData<geometry_t>(geom_vec)[index] = Geometry::Serialize(multi_polygon, geom_vec);
 		}
+	}
 
-		// Types
-		if (!type_iter.empty()) {
-			auto type_count = type_iter.size();
+	// Join member ways into closed rings by matching their end nodes. Ways that can't be closed into a ring, or
+	// rings with missing nodes, are dropped.
+	void AssembleRings(const vector<vector<int64_t>> &ways, vector<vector<VertexXY>> &rings) {
+		// The ways by their end nodes, so that the way continuing a ring is found without scanning all ways
+		unordered_map<int64_t, vector<idx_t>> ways_by_end;
+		for (idx_t i = 0; i < ways.size(); i++) {
+			ways_by_end[ways[i].front()].push_back(i);
+			if (ways[i].back() != ways[i].front()) {
+				ways_by_end[ways[i].back()].push_back(i);
+			}
+		}
 
-			auto total_types = ListVector::GetListSize(output.data[7]);
-			ListVector::Reserve(output.data[7], total_types + type_count);
-			ListVector::SetListSize(output.data[7], total_types + type_count);
-			auto &type_entry = ListVector::GetData(output.data[7])[index];
-			auto &type_vector = ListVector::GetEntry(output.data[7]);
-			type_entry.offset = total_types;
-			type_entry.length = type_count;
+		vector<bool> used(ways.size(), false);
+		for (idx_t i = 0; i < ways.size(); i++) {
+			if (used[i]) {
+				continue;
+			}
+			used[i] = true;
+			refs = ways[i];
 
-			auto type_data = FlatVector::GetData<uint8_t>(type_vector);
-			for (auto type : type_iter) {
-				type_data[total_types++] = (uint8_t)type;
+			while (refs.front() != refs.back()) {
+				auto entry = ways_by_end.find(refs.back());
+				if (entry == ways_by_end.end()) {
+					break;
+				}
+				auto extended = false;
+				for (auto j : entry->second) {
+					if (used[j]) {
+						continue;
+					}
+					auto &way = ways[j];
+					if (way.front() == refs.back()) {
+						refs.insert(refs.end(), way.begin() + 1, way.end());
+					} else {
+						refs.insert(refs.end(), way.rbegin() + 1, way.rend());
+					}
+					used[j] = true;
+					extended = true;
+					break;
+				}
+				if (!extended) {
+					break;
+				}
 			}
-		} else {
-			FlatVector::SetNull(output.data[7], index, true);
+
+			if (refs.size() < 4 || refs.front() != refs.back()) {
+				continue;
+			}
+			ResolveRefs(refs.data(), refs.data() + refs.size());
+			if (vertices.size() != refs.size()) {
+				continue;
+			}
+			rings.push_back(vertices);
 		}
+	}
 
-		index++;
+	// Returns 1 if the point lies inside the ring, 0 if it lies on its boundary and -1 if it lies outside
+	// (crossing number test)
+	static int32_t RingLocate(const vector<VertexXY> &ring, const VertexXY &point) {
+		bool inside = false;
+		for (idx_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+			auto &a = ring[i];
+			auto &b = ring[j];
+			// Vertices shared between rings come from the same nodes, so exact comparisons find them
+			const auto cross = (b.x - a.x) * (point.y - a.y) - (point.x - a.x) * (b.y - a.y);
+			if (cross == 0 && MinValue(a.x, b.x) <= point.x && point.x <= MaxValue(a.x, b.x) &&
+			    MinValue(a.y, b.y) <= point.y && point.y <= MaxValue(a.y, b.y)) {
+				return 0;
+			}
+			if ((a.y > point.y) != (b.y > point.y) && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+				inside = !inside;
+			}
+		}
+		return inside ? 1 : -1;
+	}
+
+	// Returns true if the inner ring lies inside the outer ring. Inner rings often touch their outer ring, so the
+	// decision is made on the first vertex (or segment midpoint) that does not lie on the boundary of the outer ring.
+	static bool RingContainsRing(const vector<VertexXY> &outer, const vector<VertexXY> &inner) {
+		for (auto &vertex : inner) {
+			const auto location = RingLocate(outer, vertex);
+			if (location != 0) {
+				return location > 0;
+			}
+		}
+		for (idx_t i = 0; i + 1 < inner.size(); i++) {
+			const VertexXY midpoint {(inner[i].x + inner[i + 1].x) / 2, (inner[i].y + inner[i + 1].y) / 2};
+			const auto location = RingLocate(outer, midpoint);
+			if (location != 0) {
+				return location > 0;
+			}
+		}
+		// The inner ring lies on the boundary of the outer ring
+		return true;
+	}
+
+	static double RingArea(const vector<VertexXY> &ring) {
+		double area = 0;
+		for (idx_t i = 0; i + 1 < ring.size(); i++) {
+			area += ring[i].x * ring[i + 1].y - ring[i + 1].x * ring[i].y;
+		}
+		return std::abs(area) / 2;
 	}
 
 	// Returns true if done (all dense nodes have been read)
-	bool ScanDenseNodes(DataChunk &output, idx_t &index, idx_t capacity) {
+	bool ScanDenseNodes(idx_t &index, idx_t capacity) {
 		// Write multiple nodes at once as long as we have capacity
-		auto nodes_to_write = capacity - index;
-		auto nodes_to_read = std::min(nodes_to_write, dense_node_ids.size() - dense_node_index);
+		while (index < capacity && dense_node_index < dense_node_ids.size()) {
+			auto id = dense_node_ids[dense_node_index];
+			auto has_tags = !dense_node_tags.empty() && dense_node_tag_entries[dense_node_index].length != 0;
+			auto tag_entry = has_tags ? dense_node_tag_entries[dense_node_index] : list_entry_t {0, 0};
 
-		auto kind_data = FlatVector::GetData<uint8_t>(output.data[0]);
-		auto id_data = FlatVector::GetData<int64_t>(output.data[1]);
-		auto lat_data = FlatVector::GetData<double>(output.data[4]);
-		auto lon_data = FlatVector::GetData<double>(output.data[5]);
+			if (!pushdown.HasId(id) || !HasRequiredKeys(tag_entry)) {
+				dense_node_index++;
+				continue;
+			}
 
-		for (idx_t i = 0; i < nodes_to_read; i++) {
-			auto id = dense_node_ids[dense_node_index];
+			auto lat = 0.000000001 * (lat_offset + (granularity * dense_node_lats[dense_node_index]));
+			auto lon = 0.000000001 * (lon_offset + (granularity * dense_node_lons[dense_node_index]));
+
+			SetValue<uint8_t>(OSM_KIND, index, 0);
+			SetValue<int64_t>(OSM_ID, index, id);
+			SetValue<double>(OSM_LAT, index, lat);
+			SetValue<double>(OSM_LON, index, lon);
 
-			id_data[index] = id;
-			kind_data[index] = 0;
-			lat_data[index] = 0.000000001 * (lat_offset + (granularity * dense_node_lats[dense_node_index]));
-			lon_data[index] = 0.000000001 * (lon_offset + (granularity * dense_node_lons[dense_node_index]));
+			if (columns[OSM_GEOMETRY]) {
+				WriteNodeGeometry(index, lat, lon);
+			}
 
-			// Do we have tags in this block?
-			if (!dense_node_tags.empty()) {
-				auto entry = dense_node_tag_entries[dense_node_index];
-				if (entry.length != 0) {
+			// Do we have tags for this node?
+			if (columns[OSM_TAGS]) {
+				auto &tags = *columns[OSM_TAGS];
+				if (has_tags) {
 					// Dense nodes tags are stored as a list of key/value pairs,
 					// therefore we need to divide the length by 2 to get the number of tags
-					auto tag_count = entry.length / 2;
+					auto tag_count = tag_entry.length / 2;
 
-					auto total_tags = ListVector::GetListSize(output.data[2]);
-					ListVector::Reserve(output.data[2], total_tags + tag_count);
-					ListVector::SetListSize(output.data[2], total_tags + tag_count);
-					auto &tag_entry = ListVector::GetData(output.data[2])[index];
+					auto total_tags = ListVector::GetListSize(tags);
+					ListVector::Reserve(tags, total_tags + tag_count);
+					ListVector::SetListSize(tags, total_tags + tag_count);
+					auto &list_entry = ListVector::GetData(tags)[index];
 
-					tag_entry.offset = total_tags;
-					tag_entry.length = tag_count;
+					list_entry.offset = total_tags;
+					list_entry.length = tag_count;
 
-					auto &key_vector = MapVector::GetKeys(output.data[2]);
-					auto &value_vector = MapVector::GetValues(output.data[2]);
+					auto &key_vector = MapVector::GetKeys(tags);
+					auto &value_vector = MapVector::GetValues(tags);
 
-					idx_t t = entry.offset;
-					idx_t r = tag_entry.offset;
+					idx_t t = tag_entry.offset;
+					idx_t r = list_entry.offset;
 					for (idx_t i = 0; i < tag_count; i++) {
 
 						auto key_id = dense_node_tags[t];
@@ -768,39 +1981,48 @@ struct LocalState : LocalTableFunctionState {
 						r += 1;
 					}
 				} else {
-					FlatVector::SetNull(output.data[2], index, true);
+					FlatVector::SetNull(tags, index, true);
 				}
-			} else {
-				FlatVector::SetNull(output.data[2], index, true);
 			}
-			FlatVector::SetNull(output.data[3], index, true);
 
-			// No ref types or roles for dense nodes
-			FlatVector::SetNull(output.data[6], index, true);
-			FlatVector::SetNull(output.data[7], index, true);
+			// No refs, ref types or roles for dense nodes
+			SetNull(OSM_REFS, index);
+			SetNull(OSM_REF_ROLES, index);
+			SetNull(OSM_REF_TYPES, index);
 
 			dense_node_index++;
 			index++;
 		}
-		if (dense_node_index >= dense_node_ids.size()) {
-			return true;
+		return dense_node_index >= dense_node_ids.size();
+	}
+
+	// The tags of a dense node are key/value pairs in dense_node_tags
+	bool HasRequiredKeys(const list_entry_t &tag_entry) const {
+		for (auto key : required_keys) {
+			auto found = false;
+			for (idx_t t = tag_entry.offset; t < tag_entry.offset + tag_entry.length; t += 2) {
+				if (dense_node_tags[t] == key) {
+					found = true;
+					break;
+				}
+			}
+			if (!found) {
+				return false;
+			}
 		}
-		return false;
+		return true;
 	}
 };
 
 static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
                                                      GlobalTableFunctionState *global_state) {
-	// auto &bind_data = (BindData &)*input.bind_data;
+	auto &bind_data = (BindData &)*input.bind_data;
 	auto &global = (GlobalState &)*global_state;
 
-	auto blob = global.GetNextBlob(context.client);
-	if (blob == nullptr) {
+	auto result = make_uniq<LocalState>(context.client, bind_data.pushdown, input.column_ids, global.index.get());
+	if (!result->TryNextBlock(context.client, global)) {
 		return nullptr;
 	}
-	auto block = DecompressBlob(context.client, *blob);
-
-	auto result = make_uniq<LocalState>(std::move(block));
 	return std::move(result);
 }
 
@@ -816,15 +2038,14 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 	idx_t row_id = 0;
 	idx_t capacity = STANDARD_VECTOR_SIZE;
 
+	// The geometries are serialized into the output, so the arena only needs to live for this chunk
+	local_state.arena.Reset();
+	local_state.SetOutput(output);
+
 	while (row_id < capacity) {
-		bool done = local_state.TryRead(output, row_id, capacity);
-		if (done) {
-			auto next = global_state.GetNextBlob(context);
-			if (next.get() == nullptr) {
-				break;
-			}
-			auto next_block = DecompressBlob(context, *next);
-			local_state.SetBlock(std::move(next_block));
+		bool done = local_state.TryRead(row_id, capacity);
+		if (done && !local_state.TryNextBlock(context, global_state)) {
+			break;
 		}
 	}
 	output.SetCardinality(row_id);
@@ -866,7 +2087,13 @@ static constexpr DocTag DOC_TAGS[] = {{"ext", "spatial"}};
 static constexpr const char *DOC_DESCRIPTION = R"(
     The `ST_ReadOsm()` table function enables reading compressed OpenStreetMap data directly from a `.osm.pbf file.`
 
-    This function uses multithreading and zero-copy protobuf parsing which makes it a lot faster than using the `ST_Read()` OSM driver, however it only outputs the raw OSM data (Nodes, Ways, Relations), without constructing any geometries. For simple node entities (like PoI's) you can trivially construct POINT geometries, but it is also possible to construct LINESTRING and POLYGON geometries by manually joining refs and nodes together in SQL, although with available memory usually being a limiting factor.
+    This function uses multithreading and zero-copy protobuf parsing which makes it a lot faster than using the `ST_Read()` OSM driver, however by default it only outputs the raw OSM data (Nodes, Ways, Relations), without constructing any geometries. For simple node entities (like PoI's) you can trivially construct POINT geometries, but it is also possible to construct LINESTRING and POLYGON geometries by manually joining refs and nodes together in SQL, although with available memory usually being a limiting factor.
+
+    Passing `build_geometry := true` adds a `geometry` column, built while reading the file. Nodes become POINTs and ways become LINESTRINGs, or POLYGONs if they are closed and tagged as an area (e.g. with `building`, `landuse` or `area=yes`). Multipolygon and boundary relations become POLYGONs or MULTIPOLYGONs assembled from their outer and inner member ways, other relations get a NULL geometry. To resolve the refs, the file is first read once, in parallel, to store the location of every node and the refs of every member way of a multipolygon in sorted arrays, which are kept by the buffer manager and spill to disk when they don't fit in memory. This requires the nodes and ways in the file to be sorted by id, which is the case for all common extracts. Nodes missing from the file (e.g. because they were clipped from an extract) are skipped.
+    The file is read in parallel: the headers of all blobs are read first, after which each thread claims `read_ahead` (default 8) adjacent blobs at a time and fetches them with a single read. Larger values mean fewer, larger reads, which helps on network storage.
+    Only the selected columns are materialized. Filters on `kind`, `id` and tag keys (e.g. `tags['highway'][1] IS NOT NULL`) are also used while reading: groups of entities of another kind are skipped without being parsed, and blocks whose string table doesn't contain a required tag key are skipped entirely.
+    Blobs can be uncompressed, or compressed with zlib, zstd or lz4. Each thread reuses its decompression state across blobs.
+
     The `ST_ReadOSM()` function also provides a "replacement scan" to enable reading from a file directly as if it were a table. This is just syntax sugar for calling `ST_ReadOSM()` though. Example:
 
     ```sql
@@ -897,6 +2124,10 @@ static constexpr const char *DOC_EXAMPLE = R"(
 //------------------------------------------------------------------------------
 void CoreTableFunctions::RegisterOsmTableFunction(DatabaseInstance &db) {
 	TableFunction read("ST_ReadOSM", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
+	read.named_parameters["build_geometry"] = LogicalType::BOOLEAN;
+	read.named_parameters["read_ahead"] = LogicalType::INTEGER;
+	read.projection_pushdown = true;
+	read.pushdown_complex_filter = PushdownComplexFilter;
 
 	read.get_batch_index = GetBatchIndex;
 	read.table_scan_progress = Progress;
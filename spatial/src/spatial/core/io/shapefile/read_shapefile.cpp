@@ -176,17 +176,62 @@ static unique_ptr<FunctionData> Bind(ClientContext &context, TableFunctionBindIn
 // Init Global
 //------------------------------------------------------------------------------
 
+// The number of records each thread claims at once. The .shx index has the offset of every record,
+// so the records of a morsel can be read without looking at the ones before it.
+static constexpr idx_t SHAPEFILE_MORSEL_SIZE = STANDARD_VECTOR_SIZE * 4;
+
 struct ShapefileGlobalState : public GlobalTableFunctionState {
-	int shape_idx;
+	idx_t shape_count;
+	idx_t max_threads;
+	atomic<idx_t> next_record;
+	vector<idx_t> column_ids;
+
+	explicit ShapefileGlobalState(ClientContext &context, idx_t shape_count, vector<idx_t> column_ids_p)
+	    : shape_count(shape_count), next_record(0), column_ids(std::move(column_ids_p)) {
+		auto morsel_count = (shape_count + SHAPEFILE_MORSEL_SIZE - 1) / SHAPEFILE_MORSEL_SIZE;
+		max_threads = MaxValue<idx_t>(1, MinValue<idx_t>(context.db->NumberOfThreads(), morsel_count));
+	}
+
+	idx_t MaxThreads() const override {
+		return max_threads;
+	}
+
+	// Claim the next morsel of records, returns false if all records have been claimed
+	bool TryClaimRecords(idx_t &begin, idx_t &end) {
+		begin = next_record.fetch_add(SHAPEFILE_MORSEL_SIZE);
+		if (begin >= shape_count) {
+			return false;
+		}
+		end = MinValue<idx_t>(begin + SHAPEFILE_MORSEL_SIZE, shape_count);
+		return true;
+	}
+};
+
+static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
+	auto result = make_uniq<ShapefileGlobalState>(context, bind_data.shape_count, input.column_ids);
+	return std::move(result);
+}
+
+//------------------------------------------------------------------------------
+// Init Local
+//------------------------------------------------------------------------------
+
+struct ShapefileLocalState : public LocalTableFunctionState {
 	SHPHandlePtr shp_handle;
 	DBFHandlePtr dbf_handle;
 	ArenaAllocator arena;
-	vector<idx_t> column_ids;
 
-	explicit ShapefileGlobalState(ClientContext &context, const string &file_name, vector<idx_t> column_ids_p)
-	    : shape_idx(0), arena(BufferAllocator::Get(context)), column_ids(std::move(column_ids_p)) {
+	// The records of the current morsel, [record_idx, record_end) have not been read yet
+	idx_t record_idx;
+	idx_t record_end;
+	idx_t batch_index;
+
+	explicit ShapefileLocalState(ClientContext &context, const string &file_name)
+	    : arena(BufferAllocator::Get(context)), record_idx(0), record_end(0), batch_index(0) {
 		auto &fs = FileSystem::GetFileSystem(context);
 
+		// Every thread opens its own handles, so that they can read without coordinating
 		shp_handle = OpenSHPFile(fs, file_name);
 
 		// Remove file extension and replace with .dbf
@@ -196,9 +241,10 @@ struct ShapefileGlobalState : public GlobalTableFunctionState {
 	}
 };
 
-static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext &context, TableFunctionInitInput &input) {
+static unique_ptr<LocalTableFunctionState> InitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                     GlobalTableFunctionState *global_state) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
-	auto result = make_uniq<ShapefileGlobalState>(context, bind_data.file_name, input.column_ids);
+	auto result = make_uniq<ShapefileLocalState>(context.client, bind_data.file_name);
 	return std::move(result);
 }
 
@@ -487,13 +533,23 @@ static void ConvertAttributeVector(Vector &result, int record_start, idx_t count
 static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
 	auto &bind_data = input.bind_data->Cast<ShapefileBindData>();
 	auto &gstate = input.global_state->Cast<ShapefileGlobalState>();
+	auto &lstate = input.local_state->Cast<ShapefileLocalState>();
 
 	// Reset the buffer allocator
-	gstate.arena.Reset();
+	lstate.arena.Reset();
+
+	// Claim the next morsel once the current one is done
+	if (lstate.record_idx >= lstate.record_end) {
+		if (!gstate.TryClaimRecords(lstate.record_idx, lstate.record_end)) {
+			output.SetCardinality(0);
+			return;
+		}
+		lstate.batch_index = lstate.record_idx / SHAPEFILE_MORSEL_SIZE;
+	}
 
 	// Calculate how many record we can fit in the output
-	auto output_size = std::min<int>(STANDARD_VECTOR_SIZE, bind_data.shape_count - gstate.shape_idx);
-	int record_start = gstate.shape_idx;
+	auto output_size = MinValue<idx_t>(STANDARD_VECTOR_SIZE, lstate.record_end - lstate.record_idx);
+	auto record_start = UnsafeNumericCast<int>(lstate.record_idx);
 	for (auto col_idx = 0; col_idx < output.ColumnCount(); col_idx++) {
 
 		// Projected column indices
@@ -501,17 +557,17 @@ static void Execute(ClientContext &context, TableFunctionInput &input, DataChunk
 
 		auto &col_vec = output.data[col_idx];
 		if (col_vec.GetType() == GeoTypes::GEOMETRY()) {
-			ConvertGeometryVector(col_vec, record_start, output_size, gstate.shp_handle.get(), gstate.arena,
+			ConvertGeometryVector(col_vec, record_start, output_size, lstate.shp_handle.get(), lstate.arena,
 			                      bind_data.shape_type);
 		} else {
 			// The geometry is always last, so we can use the projected column index directly
 			auto field_idx = projected_col_idx;
-			ConvertAttributeVector(col_vec, record_start, output_size, gstate.dbf_handle.get(), (int)field_idx,
+			ConvertAttributeVector(col_vec, record_start, output_size, lstate.dbf_handle.get(), (int)field_idx,
 			                       bind_data.attribute_encoding);
 		}
 	}
-	// Update the shape index
-	gstate.shape_idx += output_size;
+	// Update the record index
+	lstate.record_idx += output_size;
 
 	// Set the cardinality of the output
 	output.SetCardinality(output_size);
@@ -527,7 +583,17 @@ static double GetProgress(ClientContext &context, const FunctionData *bind_data_
 	auto &gstate = global_state->Cast<ShapefileGlobalState>();
 	auto &bind_data = bind_data_p->Cast<ShapefileBindData>();
 
-	return (double)gstate.shape_idx / (double)bind_data.shape_count;
+	if (bind_data.shape_count == 0) {
+		return 1.0;
+	}
+	auto claimed = MinValue<idx_t>(gstate.next_record, gstate.shape_count);
+	return (double)claimed / (double)bind_data.shape_count;
+}
+
+static idx_t GetBatchIndex(ClientContext &context, const FunctionData *bind_data_p,
+                           LocalTableFunctionState *local_state, GlobalTableFunctionState *global_state) {
+	auto &lstate = local_state->Cast<ShapefileLocalState>();
+	return lstate.batch_index;
 }
 
 static unique_ptr<NodeStatistics> GetCardinality(ClientContext &context, const FunctionData *data) {
@@ -560,11 +626,12 @@ static unique_ptr<TableRef> GetReplacementScan(ClientContext &context, Replaceme
 // Register table function
 //------------------------------------------------------------------------------
 void CoreTableFunctions::RegisterShapefileTableFunction(DatabaseInstance &db) {
-	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal);
+	TableFunction read_func("ST_ReadSHP", {LogicalType::VARCHAR}, Execute, Bind, InitGlobal, InitLocal);
 
 	read_func.named_parameters["encoding"] = LogicalType::VARCHAR;
 	read_func.table_scan_progress = GetProgress;
 	read_func.cardinality = GetCardinality;
+	read_func.get_batch_index = GetBatchIndex;
 	read_func.projection_pushdown = true;
 	ExtensionUtil::RegisterFunction(db, read_func);
 
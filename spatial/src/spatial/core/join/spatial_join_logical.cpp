@@ -0,0 +1,160 @@
+#include "spatial/core/join/spatial_join_logical.hpp"
+
+#include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
+#include "duckdb/common/serializer/deserializer.hpp"
+#include "duckdb/common/serializer/serializer.hpp"
+#include "duckdb/execution/column_binding_resolver.hpp"
+#include "duckdb/execution/operator/order/physical_order.hpp"
+#include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+#include "spatial/core/join/spatial_join_physical.hpp"
+#include "spatial/core/types.hpp"
+
+namespace spatial {
+
+namespace core {
+
+LogicalSpatialJoin::LogicalSpatialJoin(vector<idx_t> probe_projection_ids_p, vector<idx_t> build_projection_ids_p,
+                                       bool build_is_left_p)
+    : LogicalExtensionOperator(), probe_projection_ids(std::move(probe_projection_ids_p)),
+      build_projection_ids(std::move(build_projection_ids_p)), build_is_left(build_is_left_p) {
+}
+
+vector<ColumnBinding> LogicalSpatialJoin::GetColumnBindings() {
+	const auto probe_child_bindings = children[0]->GetColumnBindings();
+	const auto build_child_bindings = children[1]->GetColumnBindings();
+
+	vector<ColumnBinding> probe_bindings;
+	for (auto &idx : probe_projection_ids) {
+		probe_bindings.push_back(probe_child_bindings[idx]);
+	}
+	vector<ColumnBinding> build_bindings;
+	for (auto &idx : build_projection_ids) {
+		build_bindings.push_back(build_child_bindings[idx]);
+	}
+
+	// Emit the columns in the same order as the join we replaced
+	auto &first = build_is_left ? build_bindings : probe_bindings;
+	auto &second = build_is_left ? probe_bindings : build_bindings;
+	first.insert(first.end(), second.begin(), second.end());
+	return first;
+}
+
+void LogicalSpatialJoin::ResolveTypes() {
+	vector<LogicalType> probe_types;
+	for (auto &idx : probe_projection_ids) {
+		probe_types.push_back(children[0]->types[idx]);
+	}
+	vector<LogicalType> build_types;
+	for (auto &idx : build_projection_ids) {
+		build_types.push_back(children[1]->types[idx]);
+	}
+
+	auto &first = build_is_left ? build_types : probe_types;
+	auto &second = build_is_left ? probe_types : build_types;
+	types = first;
+	types.insert(types.end(), second.begin(), second.end());
+}
+
+void LogicalSpatialJoin::ResolveColumnBindings(ColumnBindingResolver &res, vector<ColumnBinding> &bindings) {
+	// Resolve the children first
+	res.VisitOperator(*children[0]);
+	const auto probe_bindings = bindings;
+	res.VisitOperator(*children[1]);
+	const auto build_bindings = bindings;
+
+	// The predicate is evaluated on the probe columns followed by the build columns
+	bindings = probe_bindings;
+	bindings.insert(bindings.end(), build_bindings.begin(), build_bindings.end());
+	res.VisitExpression(&expressions[0]);
+
+	// The keys are evaluated on their own side of the join only
+	bindings = probe_bindings;
+	res.VisitExpression(&expressions[1]);
+	bindings = build_bindings;
+	res.VisitExpression(&expressions[2]);
+
+	// Parent operators see the projected output of the join
+	bindings = GetColumnBindings();
+}
+
+// Sort the build side along a hilbert curve, so that we can pack the RTree over the build rows in the order we
+// receive them, and so that rows that are close in space end up in the same chunks of the build collection.
+static unique_ptr<PhysicalOperator> CreateOrderByHilbert(ClientContext &context, const Expression &build_key,
+                                                         unique_ptr<PhysicalOperator> build) {
+	auto &catalog = Catalog::GetSystemCatalog(context);
+
+	auto &hilbert_func_entry = catalog.GetEntry(context, CatalogType::SCALAR_FUNCTION_ENTRY, DEFAULT_SCHEMA, "ST_Hilbert")
+	                               .Cast<ScalarFunctionCatalogEntry>();
+	auto hilbert_func = hilbert_func_entry.functions.GetFunctionByArguments(context, {GeoTypes::GEOMETRY()});
+
+	vector<unique_ptr<Expression>> hilbert_args;
+	hilbert_args.push_back(build_key.Copy());
+	auto hilbert_expr = make_uniq_base<Expression, BoundFunctionExpression>(LogicalType::UINTEGER, hilbert_func,
+	                                                                        std::move(hilbert_args), nullptr);
+
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(OrderType::ASCENDING, OrderByNullType::NULLS_LAST, std::move(hilbert_expr));
+
+	vector<idx_t> projections;
+	for (idx_t i = 0; i < build->types.size(); i++) {
+		projections.push_back(i);
+	}
+
+	auto order = make_uniq<PhysicalOrder>(build->types, std::move(orders), std::move(projections),
+	                                      build->estimated_cardinality);
+	order->children.push_back(std::move(build));
+	return std::move(order);
+}
+
+unique_ptr<PhysicalOperator> LogicalSpatialJoin::CreatePlan(ClientContext &context, PhysicalPlanGenerator &generator) {
+	D_ASSERT(children.size() == 2);
+	D_ASSERT(expressions.size() == 3);
+
+	const auto probe_column_count = children[0]->types.size();
+	auto probe_plan = generator.CreatePlan(std::move(children[0]));
+	auto build_plan = CreateOrderByHilbert(context, *expressions[2], generator.CreatePlan(std::move(children[1])));
+
+	// Map every output column to its position in the joined (probe + build) chunk
+	vector<idx_t> probe_columns = probe_projection_ids;
+	vector<idx_t> build_columns;
+	for (auto &idx : build_projection_ids) {
+		build_columns.push_back(probe_column_count + idx);
+	}
+	auto &first = build_is_left ? build_columns : probe_columns;
+	auto &second = build_is_left ? probe_columns : build_columns;
+	first.insert(first.end(), second.begin(), second.end());
+
+	return make_uniq<PhysicalSpatialJoin>(*this, std::move(probe_plan), std::move(build_plan), std::move(first),
+	                                      std::move(expressions[0]), std::move(expressions[1]),
+	                                      std::move(expressions[2]), estimated_cardinality);
+}
+
+//------------------------------------------------------------------------------
+// (De)Serialization
+//------------------------------------------------------------------------------
+void LogicalSpatialJoin::Serialize(Serializer &writer) const {
+	LogicalExtensionOperator::Serialize(writer);
+	writer.WritePropertyWithDefault(300, "operator_type", string("logical_spatial_join"));
+	writer.WritePropertyWithDefault(400, "probe_projection_ids", probe_projection_ids);
+	writer.WritePropertyWithDefault(401, "build_projection_ids", build_projection_ids);
+	writer.WritePropertyWithDefault(402, "build_is_left", build_is_left);
+	writer.WritePropertyWithDefault(403, "expressions", expressions);
+}
+
+unique_ptr<LogicalExtensionOperator> LogicalSpatialJoin::Deserialize(Deserializer &reader) {
+	auto probe_projection_ids = reader.ReadPropertyWithDefault<vector<idx_t>>(400, "probe_projection_ids");
+	auto build_projection_ids = reader.ReadPropertyWithDefault<vector<idx_t>>(401, "build_projection_ids");
+	const auto build_is_left = reader.ReadPropertyWithDefault<bool>(402, "build_is_left");
+	auto expressions = reader.ReadPropertyWithDefault<vector<unique_ptr<Expression>>>(403, "expressions");
+
+	auto result = make_uniq<LogicalSpatialJoin>(std::move(probe_projection_ids), std::move(build_projection_ids),
+	                                            build_is_left);
+	result->expressions = std::move(expressions);
+	return std::move(result);
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -0,0 +1,554 @@
+#include "spatial/core/join/spatial_join_physical.hpp"
+
+#include "duckdb/common/types/column/column_data_collection.hpp"
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+#include "spatial/core/geometry/bbox.hpp"
+#include "spatial/core/geometry/geometry_type.hpp"
+#include "spatial/core/util/managed_collection.hpp"
+#include "spatial/core/util/math.hpp"
+
+namespace spatial {
+
+namespace core {
+
+//-------------------------------------------------------------
+// Packed RTree
+//-------------------------------------------------------------
+// The bounding box of a build row, and the position of the row in the build collection
+struct SpatialJoinEntry {
+	Box2D<float> bounds;
+	idx_t row_idx;
+};
+
+// A static RTree packed bottom-up from the bounding boxes of the build rows, in the order they were sunk.
+// The leaves hold one entry per build row. They make up almost all of the tree, so they are kept in buffer managed
+// blocks that can be spilled to disk, like the build rows themselves. Every node of the upper levels covers
+// NODE_CAPACITY consecutive boxes of the level below, so the tree needs no pointers.
+struct SpatialJoinTree {
+	static constexpr idx_t NODE_CAPACITY = 16;
+
+	explicit SpatialJoinTree(BufferManager &manager) : leaves(manager) {
+	}
+
+	ManagedCollection<SpatialJoinEntry> leaves;
+	ManagedCollectionAppendState append_state;
+	//! levels[0] covers the leaves, levels[N > 0] covers levels[N - 1]. The last level holds the root.
+	vector<vector<Box2D<float>>> levels;
+
+	void Append(const SpatialJoinEntry *begin, const SpatialJoinEntry *end) {
+		if (leaves.Count() == 0) {
+			leaves.InitializeAppend(append_state);
+			levels.resize(1);
+		}
+		auto &parents = levels[0];
+		for (auto entry = begin; entry != end; entry++) {
+			const auto parent_idx = (leaves.Count() + (entry - begin)) / NODE_CAPACITY;
+			if (parent_idx == parents.size()) {
+				parents.emplace_back();
+			}
+			parents[parent_idx].Union(entry->bounds);
+		}
+		leaves.Append(append_state, begin, end);
+	}
+
+	idx_t Count() const {
+		return leaves.Count();
+	}
+
+	void Build() {
+		// Unpin the last leaf block, so that it can be spilled as well
+		append_state.handle.Destroy();
+
+		while (levels.back().size() > 1) {
+			const auto &prev = levels.back();
+			vector<Box2D<float>> next((prev.size() + NODE_CAPACITY - 1) / NODE_CAPACITY);
+			for (idx_t i = 0; i < prev.size(); i++) {
+				next[i / NODE_CAPACITY].Union(prev[i]);
+			}
+			levels.push_back(std::move(next));
+		}
+	}
+};
+
+// Depth-first search through the packed tree, resumable so that we can yield once the candidate buffer is full
+class SpatialJoinTreeScanner {
+public:
+	void Init(const SpatialJoinTree &tree, const Box2D<float> &query_p) {
+		stack.clear();
+		query = query_p;
+		const auto top = tree.levels.size();
+		if (tree.levels[top - 1][0].Intersects(query)) {
+			stack.emplace_back(top, 0);
+		}
+	}
+
+	bool IsDone() const {
+		return stack.empty();
+	}
+
+	// Scan at most 'capacity' build row indexes into the given buffer
+	idx_t Scan(const SpatialJoinTree &tree, idx_t *result, idx_t capacity) {
+		idx_t count = 0;
+		while (!stack.empty() && count < capacity) {
+			const auto entry = stack.back();
+			stack.pop_back();
+
+			const auto level = entry.first;
+			const auto index = entry.second;
+			if (level == 0) {
+				// A matching leaf, the index is the build row
+				result[count++] = index;
+				continue;
+			}
+
+			// Push the intersecting children in reverse, so that they are visited in order
+			const auto begin = index * SpatialJoinTree::NODE_CAPACITY;
+			if (level == 1) {
+				const auto end = MinValue<idx_t>(begin + SpatialJoinTree::NODE_CAPACITY, tree.Count());
+				for (idx_t i = end; i-- > begin;) {
+					const auto leaf = GetLeaf(tree, i);
+					if (leaf.bounds.Intersects(query)) {
+						stack.emplace_back(0, leaf.row_idx);
+					}
+				}
+				continue;
+			}
+			const auto &children = tree.levels[level - 2];
+			const auto end = MinValue<idx_t>(begin + SpatialJoinTree::NODE_CAPACITY, children.size());
+			for (idx_t i = end; i-- > begin;) {
+				if (children[i].Intersects(query)) {
+					stack.emplace_back(level - 1, i);
+				}
+			}
+		}
+		return count;
+	}
+
+private:
+	SpatialJoinEntry GetLeaf(const SpatialJoinTree &tree, idx_t leaf_idx) {
+		// Keep the last leaf block pinned, consecutive lookups are likely to hit the same block
+		const auto block_idx = leaf_idx / tree.leaves.BlockCapacity();
+		if (block_idx != pinned_block_idx) {
+			idx_t item_count;
+			pinned_block = tree.leaves.PinBlock(block_idx, item_count);
+			pinned_block_idx = block_idx;
+		}
+		const auto block_offset = leaf_idx % tree.leaves.BlockCapacity();
+		return Load<SpatialJoinEntry>(pinned_block.Ptr() + block_offset * sizeof(SpatialJoinEntry));
+	}
+
+	Box2D<float> query;
+	//! Pairs of (level, index), level 0 are matching leaves with the index of their build row
+	vector<pair<idx_t, idx_t>> stack;
+
+	BufferHandle pinned_block;
+	idx_t pinned_block_idx = DConstants::INVALID_INDEX;
+};
+
+static bool TryGetFloatBounds(const geometry_t &geom, Box2D<float> &result) {
+	Box2D<double> bbox;
+	if (!geom.TryGetCachedBounds(bbox)) {
+		return false;
+	}
+	result.min.x = MathUtil::DoubleToFloatDown(bbox.min.x);
+	result.min.y = MathUtil::DoubleToFloatDown(bbox.min.y);
+	result.max.x = MathUtil::DoubleToFloatUp(bbox.max.x);
+	result.max.y = MathUtil::DoubleToFloatUp(bbox.max.y);
+	return true;
+}
+
+//-------------------------------------------------------------
+// Physical Spatial Join
+//-------------------------------------------------------------
+PhysicalSpatialJoin::PhysicalSpatialJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> probe,
+                                         unique_ptr<PhysicalOperator> build, vector<idx_t> output_columns,
+                                         unique_ptr<Expression> predicate, unique_ptr<Expression> probe_key,
+                                         unique_ptr<Expression> build_key, idx_t estimated_cardinality)
+    // Declare this operators as a EXTENSION operator
+    : PhysicalJoin(op, PhysicalOperatorType::EXTENSION, JoinType::INNER, estimated_cardinality),
+      build_types(build->types), output_columns(std::move(output_columns)), predicate(std::move(predicate)),
+      probe_key(std::move(probe_key)), build_key(std::move(build_key)) {
+
+	join_types = probe->types;
+	join_types.insert(join_types.end(), build_types.begin(), build_types.end());
+
+	children.push_back(std::move(probe));
+	children.push_back(std::move(build));
+}
+
+//-------------------------------------------------------------
+// Global Sink State
+//-------------------------------------------------------------
+// The build rows and their bounding boxes of a single batch of the sorted build side
+struct SpatialJoinBatch {
+	SpatialJoinBatch(BufferManager &manager, const vector<LogicalType> &types)
+	    : collection(make_uniq<ColumnDataCollection>(manager, types)), bounds(manager) {
+		collection->InitializeAppend(collection_append_state);
+		// Start out small, most batches are only a few vectors large
+		bounds.InitializeAppend(bounds_append_state, STANDARD_VECTOR_SIZE);
+	}
+
+	//! As we append sequentially, row 'i' of the batch is always stored in chunk 'i / STANDARD_VECTOR_SIZE'
+	unique_ptr<ColumnDataCollection> collection;
+	ColumnDataAppendState collection_append_state;
+
+	ManagedCollection<Box2D<float>> bounds;
+	ManagedCollectionAppendState bounds_append_state;
+};
+
+class SpatialJoinGlobalState final : public GlobalSinkState {
+public:
+	SpatialJoinGlobalState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : buffer_manager(BufferManager::GetBufferManager(context)),
+	      collection(make_uniq<ColumnDataCollection>(buffer_manager, op.build_types)), tree(buffer_manager) {
+	}
+
+	BufferManager &buffer_manager;
+
+	//! Guards the batches while sinking
+	mutex lock;
+	//! The sunk batches, in batch index order
+	map<idx_t, unique_ptr<SpatialJoinBatch>> batches;
+
+	//! The build rows of all batches. These are buffer managed, and spill to disk if they do not fit in memory.
+	//! Every chunk holds at most STANDARD_VECTOR_SIZE rows, so the row index of a build row is
+	//! 'chunk_idx * STANDARD_VECTOR_SIZE + offset_in_chunk'.
+	unique_ptr<ColumnDataCollection> collection;
+
+	//! The packed RTree over the build rows
+	SpatialJoinTree tree;
+};
+
+unique_ptr<GlobalSinkState> PhysicalSpatialJoin::GetGlobalSinkState(ClientContext &context) const {
+	return make_uniq<SpatialJoinGlobalState>(context, *this);
+}
+
+//-------------------------------------------------------------
+// Local Sink State
+//-------------------------------------------------------------
+class SpatialJoinLocalState final : public LocalSinkState {
+public:
+	SpatialJoinLocalState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : buffer_manager(BufferManager::GetBufferManager(context)), build_executor(context, *op.build_key) {
+		build_keys.Initialize(context, {op.build_key->return_type});
+	}
+
+	BufferManager &buffer_manager;
+
+	ExpressionExecutor build_executor;
+	DataChunk build_keys;
+
+	//! The batch we are currently sinking
+	optional_idx batch_index;
+	unique_ptr<SpatialJoinBatch> batch;
+};
+
+unique_ptr<LocalSinkState> PhysicalSpatialJoin::GetLocalSinkState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinLocalState>(context.client, *this);
+}
+
+// Hand the current batch over to the global state
+static void FlushBatch(SpatialJoinGlobalState &gstate, SpatialJoinLocalState &lstate) {
+	if (!lstate.batch) {
+		return;
+	}
+	lstate.batch->collection_append_state.current_chunk_state.handles.clear();
+	lstate.batch->bounds_append_state.handle.Destroy();
+	if (lstate.batch->collection->Count() != 0) {
+		lock_guard<mutex> guard(gstate.lock);
+		gstate.batches[lstate.batch_index.GetIndex()] = std::move(lstate.batch);
+	}
+	lstate.batch.reset();
+}
+
+//-------------------------------------------------------------
+// Sink
+//-------------------------------------------------------------
+SinkResultType PhysicalSpatialJoin::Sink(ExecutionContext &context, DataChunk &chunk, OperatorSinkInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+
+	if (chunk.size() == 0) {
+		return SinkResultType::NEED_MORE_INPUT;
+	}
+
+	// Start a new batch if we moved on to a new one
+	const auto batch_index = lstate.partition_info.batch_index.GetIndex();
+	if (!lstate.batch || lstate.batch_index.GetIndex() != batch_index) {
+		FlushBatch(gstate, lstate);
+		lstate.batch_index = batch_index;
+		lstate.batch = make_uniq<SpatialJoinBatch>(lstate.buffer_manager, build_types);
+	}
+	auto &batch = *lstate.batch;
+
+	lstate.build_keys.Reset();
+	lstate.build_executor.Execute(chunk, lstate.build_keys);
+
+	UnifiedVectorFormat format;
+	lstate.build_keys.data[0].ToUnifiedFormat(chunk.size(), format);
+	const auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(format);
+
+	// Rows with a NULL or empty geometry can not satisfy the predicate, so we dont need to keep them around
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	Box2D<float> bounds[STANDARD_VECTOR_SIZE];
+	idx_t count = 0;
+	for (idx_t i = 0; i < chunk.size(); i++) {
+		const auto idx = format.sel->get_index(i);
+		if (!format.validity.RowIsValid(idx) || !TryGetFloatBounds(geom_data[idx], bounds[count])) {
+			continue;
+		}
+		sel.set_index(count++, i);
+	}
+
+	if (count == 0) {
+		return SinkResultType::NEED_MORE_INPUT;
+	}
+	if (count != chunk.size()) {
+		chunk.Slice(sel, count);
+	}
+	batch.collection->Append(batch.collection_append_state, chunk);
+	batch.bounds.Append(batch.bounds_append_state, bounds, bounds + count);
+
+	return SinkResultType::NEED_MORE_INPUT;
+}
+
+//-------------------------------------------------------------
+// Combine
+//-------------------------------------------------------------
+SinkCombineResultType PhysicalSpatialJoin::Combine(ExecutionContext &context, OperatorSinkCombineInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+	auto &lstate = input.local_state.Cast<SpatialJoinLocalState>();
+	FlushBatch(gstate, lstate);
+	return SinkCombineResultType::FINISHED;
+}
+
+//-------------------------------------------------------------
+// Finalize
+//-------------------------------------------------------------
+SinkFinalizeType PhysicalSpatialJoin::Finalize(Pipeline &pipeline, Event &event, ClientContext &context,
+                                               OperatorSinkFinalizeInput &input) const {
+	auto &gstate = input.global_state.Cast<SpatialJoinGlobalState>();
+
+	if (gstate.batches.empty()) {
+		// Nothing to join with
+		return SinkFinalizeType::NO_OUTPUT_POSSIBLE;
+	}
+
+	// Concatenate the batches in order. The build side arrives sorted along a hilbert curve, so we can pack the
+	// tree straight away.
+	Box2D<float> bounds[STANDARD_VECTOR_SIZE];
+	SpatialJoinEntry entries[STANDARD_VECTOR_SIZE];
+	for (auto &entry : gstate.batches) {
+		auto &batch = *entry.second;
+		const auto chunk_offset = gstate.collection->ChunkCount();
+
+		ManagedCollectionScanState scan_state;
+		batch.bounds.InitializeScan(scan_state, true);
+		idx_t batch_row_idx = 0;
+		while (true) {
+			const auto count = batch.bounds.Scan(scan_state, bounds, bounds + STANDARD_VECTOR_SIZE);
+			if (count == 0) {
+				break;
+			}
+			for (idx_t i = 0; i < count; i++) {
+				const auto chunk_idx = chunk_offset + batch_row_idx / STANDARD_VECTOR_SIZE;
+				entries[i].bounds = bounds[i];
+				entries[i].row_idx = chunk_idx * STANDARD_VECTOR_SIZE + batch_row_idx % STANDARD_VECTOR_SIZE;
+				batch_row_idx++;
+			}
+			gstate.tree.Append(entries, entries + count);
+		}
+		D_ASSERT(batch_row_idx == batch.collection->Count());
+
+		gstate.collection->Combine(*batch.collection);
+		entry.second.reset();
+	}
+	gstate.batches.clear();
+
+	gstate.tree.Build();
+	return SinkFinalizeType::READY;
+}
+
+//-------------------------------------------------------------
+// Operator State
+//-------------------------------------------------------------
+struct SpatialJoinCandidate {
+	idx_t build_idx;
+	idx_t probe_idx;
+};
+
+class SpatialJoinState final : public CachingOperatorState {
+public:
+	SpatialJoinState(ClientContext &context, const PhysicalSpatialJoin &op)
+	    : probe_executor(context, *op.probe_key), predicate_executor(context, *op.predicate),
+	      fetch_sel(STANDARD_VECTOR_SIZE), probe_sel(STANDARD_VECTOR_SIZE), match_sel(STANDARD_VECTOR_SIZE) {
+		probe_keys.Initialize(context, {op.probe_key->return_type});
+		fetch_chunk.Initialize(context, op.build_types);
+		build_chunk.Initialize(context, op.build_types);
+		join_chunk.InitializeEmpty(op.join_types);
+	}
+
+	ExpressionExecutor probe_executor;
+	ExpressionExecutor predicate_executor;
+
+	//! The probe geometries of the current input chunk, and their bounding boxes
+	DataChunk probe_keys;
+	Box2D<float> probe_bounds[STANDARD_VECTOR_SIZE];
+	bool probe_valid[STANDARD_VECTOR_SIZE];
+	bool probe_initialized = false;
+
+	//! The input row currently being probed, and the tree scan for it (if not yet exhausted)
+	idx_t probe_idx = 0;
+	bool scan_active = false;
+	SpatialJoinTreeScanner scanner;
+
+	//! The candidate pairs collected for the current output chunk
+	idx_t scan_buffer[STANDARD_VECTOR_SIZE];
+	SpatialJoinCandidate candidates[STANDARD_VECTOR_SIZE];
+
+	//! The chunk of the build collection currently held in fetch_chunk
+	idx_t fetched_chunk_idx = DConstants::INVALID_INDEX;
+	DataChunk fetch_chunk;
+
+	SelectionVector fetch_sel;
+	SelectionVector probe_sel;
+	SelectionVector match_sel;
+
+	DataChunk build_chunk;
+	DataChunk join_chunk;
+
+public:
+	void InitializeProbe(DataChunk &input) {
+		probe_keys.Reset();
+		probe_executor.Execute(input, probe_keys);
+
+		UnifiedVectorFormat format;
+		probe_keys.data[0].ToUnifiedFormat(input.size(), format);
+		const auto geom_data = UnifiedVectorFormat::GetData<geometry_t>(format);
+
+		for (idx_t i = 0; i < input.size(); i++) {
+			const auto idx = format.sel->get_index(i);
+			probe_valid[i] = format.validity.RowIsValid(idx) && TryGetFloatBounds(geom_data[idx], probe_bounds[i]);
+		}
+
+		probe_idx = 0;
+		scan_active = false;
+		probe_initialized = true;
+	}
+
+	void Reset() {
+		probe_idx = 0;
+		scan_active = false;
+		probe_initialized = false;
+	}
+};
+
+unique_ptr<OperatorState> PhysicalSpatialJoin::GetOperatorState(ExecutionContext &context) const {
+	return make_uniq<SpatialJoinState>(context.client, *this);
+}
+
+//-------------------------------------------------------------
+// Execute
+//-------------------------------------------------------------
+OperatorResultType PhysicalSpatialJoin::ExecuteInternal(ExecutionContext &context, DataChunk &input, DataChunk &chunk,
+                                                        GlobalOperatorState &gstate_p, OperatorState &state_p) const {
+	auto &gstate = sink_state->Cast<SpatialJoinGlobalState>();
+	auto &state = state_p.Cast<SpatialJoinState>();
+	auto &tree = gstate.tree;
+
+	if (!state.probe_initialized) {
+		state.InitializeProbe(input);
+	}
+
+	// Collect up to a vector of candidate (probe row, build row) pairs, possibly spanning multiple probe rows
+	idx_t candidate_count = 0;
+	while (candidate_count < STANDARD_VECTOR_SIZE && state.probe_idx < input.size()) {
+		if (!state.scan_active) {
+			if (!state.probe_valid[state.probe_idx]) {
+				state.probe_idx++;
+				continue;
+			}
+			state.scanner.Init(tree, state.probe_bounds[state.probe_idx]);
+			state.scan_active = true;
+		}
+
+		const auto scan_count =
+		    state.scanner.Scan(tree, state.scan_buffer, STANDARD_VECTOR_SIZE - candidate_count);
+		for (idx_t i = 0; i < scan_count; i++) {
+			state.candidates[candidate_count + i] = {state.scan_buffer[i], state.probe_idx};
+		}
+		candidate_count += scan_count;
+
+		if (state.scanner.IsDone()) {
+			// Move on to the next probe row
+			state.scan_active = false;
+			state.probe_idx++;
+		}
+	}
+
+	chunk.SetCardinality(0);
+
+	if (candidate_count != 0) {
+		// Gather the candidate build rows. Sort the candidates by build row first, so that we only have to fetch
+		// every chunk of the build collection once.
+		std::sort(state.candidates, state.candidates + candidate_count,
+		          [](const SpatialJoinCandidate &a, const SpatialJoinCandidate &b) { return a.build_idx < b.build_idx; });
+
+		state.build_chunk.Reset();
+		idx_t offset = 0;
+		while (offset < candidate_count) {
+			const auto chunk_idx = state.candidates[offset].build_idx / STANDARD_VECTOR_SIZE;
+
+			idx_t end = offset;
+			while (end < candidate_count && state.candidates[end].build_idx / STANDARD_VECTOR_SIZE == chunk_idx) {
+				state.fetch_sel.set_index(end - offset, state.candidates[end].build_idx % STANDARD_VECTOR_SIZE);
+				state.probe_sel.set_index(end, state.candidates[end].probe_idx);
+				end++;
+			}
+
+			if (state.fetched_chunk_idx != chunk_idx) {
+				state.fetch_chunk.Reset();
+				gstate.collection->FetchChunk(chunk_idx, state.fetch_chunk);
+				state.fetched_chunk_idx = chunk_idx;
+			}
+
+			for (idx_t col_idx = 0; col_idx < build_types.size(); col_idx++) {
+				VectorOperations::Copy(state.fetch_chunk.data[col_idx], state.build_chunk.data[col_idx],
+				                       state.fetch_sel, end - offset, 0, offset);
+			}
+			offset = end;
+		}
+		state.build_chunk.SetCardinality(candidate_count);
+
+		// Assemble the joined chunk: the probe columns followed by the build columns
+		const auto probe_column_count = input.ColumnCount();
+		for (idx_t i = 0; i < probe_column_count; i++) {
+			state.join_chunk.data[i].Slice(input.data[i], state.probe_sel, candidate_count);
+		}
+		for (idx_t i = 0; i < build_types.size(); i++) {
+			state.join_chunk.data[probe_column_count + i].Reference(state.build_chunk.data[i]);
+		}
+		state.join_chunk.SetCardinality(candidate_count);
+
+		// Evaluate the exact predicate and emit the matching pairs
+		const auto match_count = state.predicate_executor.SelectExpression(state.join_chunk, state.match_sel);
+		for (idx_t i = 0; i < output_columns.size(); i++) {
+			chunk.data[i].Slice(state.join_chunk.data[output_columns[i]], state.match_sel, match_count);
+		}
+		chunk.SetCardinality(match_count);
+	}
+
+	if (state.probe_idx >= input.size()) {
+		// All input rows have been probed
+		state.Reset();
+		return OperatorResultType::NEED_MORE_INPUT;
+	}
+	return OperatorResultType::HAVE_MORE_OUTPUT;
+}
+
+} // namespace core
+
+} // namespace spatial
@@ -4,6 +4,7 @@
 #include "spatial/common.hpp"
 #include "spatial/core/functions/aggregate.hpp"
 #include "spatial/core/functions/cast.hpp"
+#include "spatial/core/functions/common.hpp"
 #include "spatial/core/functions/scalar.hpp"
 #include "spatial/core/functions/table.hpp"
 #include "spatial/core/functions/macros.hpp"
@@ -22,12 +23,15 @@ void CoreModule::Register(DatabaseInstance &db) {
 	CoreTableFunctions::Register(db);
 	CoreAggregateFunctions::Register(db);
 	CoreScalarMacros::Register(db);
+	GeometryFunctionLocalState::Register(db);
 
 	// RTree index
 	RTreeModule::RegisterIndex(db);
 	RTreeModule::RegisterIndexScan(db);
+	RTreeModule::RegisterIndexKNNScan(db);
 	RTreeModule::RegisterIndexPlanCreate(db);
 	RTreeModule::RegisterIndexPlanScan(db);
+	RTreeModule::RegisterIndexPlanJoin(db);
 	RTreeModule::RegisterIndexPragmas(db);
 
 	// Register the optimizer extensions
@@ -1,6 +1,11 @@
 #include "duckdb/catalog/catalog_entry/scalar_function_catalog_entry.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/optimizer/column_binding_replacer.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
 #include "duckdb/planner/expression/bound_conjunction_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
@@ -10,8 +15,10 @@
 #include "duckdb/planner/operator/logical_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/planner/operator/logical_join.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
 #include "spatial/common.hpp"
 #include "spatial/core/types.hpp"
+#include "spatial/core/join/spatial_join_logical.hpp"
 #include "spatial/core/optimizer_rules.hpp"
 
 namespace spatial {
@@ -22,14 +29,24 @@ namespace core {
 // Range Join Spatial Predicate Rewriter
 //------------------------------------------------------------------------------
 //
-//	Rewrites joins on spatial predicates to range joins on their bounding boxes
-//  combined with a spatial predicate filter. This turns the joins from a
+//	Rewrites joins on spatial predicates between two GEOMETRY arguments into a
+//  dedicated spatial join, which packs the smaller side into a temporary RTree
+//  and probes it with the bounding boxes of the other side.
+//
+//  Joins on other argument types are rewritten to range joins on their bounding
+//  boxes combined with a spatial predicate filter. This turns the joins from a
 //  blockwise-nested loop join into a inequality join + filter, which is much
 //  faster.
 //
 //	All spatial predicates (except st_disjoint) imply an intersection of the
 //  bounding boxes of the two geometries.
 //
+//  The extent of each side is computed once per row in a projection below the
+//  join, and the four range conditions only extract its coordinates.
+//
+//  Joins where one side is a table with an RTree index on the join column are
+//  turned into index joins before this rule runs (see rtree_index_plan_join.cpp)
+//
 class RangeJoinSpatialPredicateRewriter : public OptimizerExtension {
 public:
 	RangeJoinSpatialPredicateRewriter() {
@@ -79,8 +96,89 @@ public:
 		return true;
 	}
 
-	static void TryOptimize(ClientContext &context, OptimizerExtensionInfo *info, unique_ptr<LogicalOperator> &plan) {
+	static vector<idx_t> GetProjectionIds(LogicalOperator &child, const vector<idx_t> &projection_map) {
+		if (!projection_map.empty()) {
+			return projection_map;
+		}
+		vector<idx_t> result;
+		const auto column_count = child.GetColumnBindings().size();
+		for (idx_t i = 0; i < column_count; i++) {
+			result.push_back(i);
+		}
+		return result;
+	}
+
+	// Project the extent of the join key on top of the child, so that it is computed only once per row instead of once
+	// per join condition. Returns a reference to the projected extent. The projection passes through all columns of
+	// the child under new bindings, the old bindings are added to the replacements.
+	static unique_ptr<Expression> ProjectExtent(Binder &binder, unique_ptr<LogicalOperator> &child,
+	                                            unique_ptr<Expression> extent,
+	                                            vector<ReplacementBinding> &replacements) {
+		child->ResolveOperatorTypes();
+		const auto bindings = child->GetColumnBindings();
+		const auto table_index = binder.GenerateTableIndex();
+
+		vector<unique_ptr<Expression>> select_list;
+		for (idx_t i = 0; i < bindings.size(); i++) {
+			select_list.push_back(make_uniq<BoundColumnRefExpression>(child->types[i], bindings[i]));
+			replacements.emplace_back(bindings[i], ColumnBinding(table_index, i));
+		}
+		auto extent_type = extent->return_type;
+		select_list.push_back(std::move(extent));
+
+		auto projection = make_uniq<LogicalProjection>(table_index, std::move(select_list));
+		projection->children.push_back(std::move(child));
+		projection->ResolveOperatorTypes();
+		child = std::move(projection);
+
+		return make_uniq<BoundColumnRefExpression>(std::move(extent_type), ColumnBinding(table_index, bindings.size()));
+	}
+
+	static unique_ptr<LogicalOperator> CreateSpatialJoin(LogicalAnyJoin &any_join, unique_ptr<Expression> left_pred_expr,
+	                                                     unique_ptr<Expression> right_pred_expr) {
+		auto &left = *any_join.children[0];
+		auto &right = *any_join.children[1];
+
+		// Build the temporary RTree over the smaller side. By default thats the right side.
+		const auto build_is_left = left.has_estimated_cardinality && right.has_estimated_cardinality &&
+		                           left.estimated_cardinality < right.estimated_cardinality;
+
+		auto left_projection_ids = GetProjectionIds(left, any_join.left_projection_map);
+		auto right_projection_ids = GetProjectionIds(right, any_join.right_projection_map);
+
+		unique_ptr<LogicalSpatialJoin> join;
+		unique_ptr<Expression> probe_key;
+		unique_ptr<Expression> build_key;
+		if (build_is_left) {
+			join = make_uniq<LogicalSpatialJoin>(std::move(right_projection_ids), std::move(left_projection_ids), true);
+			join->children.push_back(std::move(any_join.children[1]));
+			join->children.push_back(std::move(any_join.children[0]));
+			probe_key = std::move(right_pred_expr);
+			build_key = std::move(left_pred_expr);
+		} else {
+			join = make_uniq<LogicalSpatialJoin>(std::move(left_projection_ids), std::move(right_projection_ids), false);
+			join->children.push_back(std::move(any_join.children[0]));
+			join->children.push_back(std::move(any_join.children[1]));
+			probe_key = std::move(left_pred_expr);
+			build_key = std::move(right_pred_expr);
+		}
+
+		join->expressions.push_back(std::move(any_join.condition));
+		join->expressions.push_back(std::move(probe_key));
+		join->expressions.push_back(std::move(build_key));
+
+		if (any_join.has_estimated_cardinality) {
+			join->estimated_cardinality = any_join.estimated_cardinality;
+			join->has_estimated_cardinality = true;
+		}
+		join->ResolveOperatorTypes();
+		return std::move(join);
+	}
+
+	static void TryOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &root,
+	                        unique_ptr<LogicalOperator> &plan) {
 
+		auto &context = input.context;
 		auto &op = *plan;
 
 		// Look for ANY_JOIN operators
@@ -143,6 +241,13 @@ public:
 						std::swap(left_pred_expr, right_pred_expr);
 					}
 
+					// If both sides are GEOMETRY, we can use the dedicated spatial join
+					if (left_pred_expr->return_type == GeoTypes::GEOMETRY() &&
+					    right_pred_expr->return_type == GeoTypes::GEOMETRY()) {
+						plan = CreateSpatialJoin(any_join, std::move(left_pred_expr), std::move(right_pred_expr));
+						return;
+					}
+
 					// Lookup the st_xmin, st_xmax, st_ymin, st_ymax functions in the catalog
 					auto &catalog = Catalog::GetSystemCatalog(context);
 
@@ -188,17 +293,29 @@ public:
 					auto ymax_func_right =
 					    ymax_func_set.functions.GetFunctionByArguments(context, {extent_func_right.return_type});
 
-					// Create the new join condition
+					// Compute the extents of both sides once per row
 					vector<unique_ptr<Expression>> left_extent_args;
-					left_extent_args.push_back(left_pred_expr->Copy());
-					auto left_extent = make_uniq<BoundFunctionExpression>(
+					// The extent functions only take GEOMETRY, so other geometry types are cast first
+					left_extent_args.push_back(BoundCastExpression::AddCastToType(
+					    context, left_pred_expr->Copy(), extent_func_left.arguments[0]));
+					auto left_extent_expr = make_uniq<BoundFunctionExpression>(
 					    GeoTypes::BOX_2D(), std::move(extent_func_left), std::move(left_extent_args), nullptr);
 
 					vector<unique_ptr<Expression>> right_extent_args;
-					right_extent_args.push_back(right_pred_expr->Copy());
-					auto right_extent = make_uniq<BoundFunctionExpression>(
+					right_extent_args.push_back(BoundCastExpression::AddCastToType(
+					    context, right_pred_expr->Copy(), extent_func_right.arguments[0]));
+					auto right_extent_expr = make_uniq<BoundFunctionExpression>(
 					    GeoTypes::BOX_2D(), std::move(extent_func_right), std::move(right_extent_args), nullptr);
 
+					vector<ReplacementBinding> replacements;
+					auto &binder = input.optimizer.binder;
+					auto left_extent =
+					    ProjectExtent(binder, any_join.children[0], std::move(left_extent_expr), replacements);
+					auto right_extent =
+					    ProjectExtent(binder, any_join.children[1], std::move(right_extent_expr), replacements);
+
+					// Create the new join condition
+
 					// Left
 					vector<unique_ptr<Expression>> left_xmin_args;
 					left_xmin_args.push_back(left_extent->Copy());
@@ -252,30 +369,50 @@ public:
 					AddComparison(new_join, std::move(a_y_max), std::move(b_y_min),
 					              ExpressionType::COMPARE_GREATERTHANOREQUALTO);
 
+					// Don't emit the extents from the join
+					for (idx_t i = 0; i + 1 < any_join.children[0]->types.size(); i++) {
+						new_join->left_projection_map.push_back(i);
+					}
+					for (idx_t i = 0; i + 1 < any_join.children[1]->types.size(); i++) {
+						new_join->right_projection_map.push_back(i);
+					}
+
 					new_join->children = std::move(any_join.children);
 					if (any_join.has_estimated_cardinality) {
 						new_join->estimated_cardinality = any_join.estimated_cardinality;
 						new_join->has_estimated_cardinality = true;
 					}
 
+					auto &join_ref = *new_join;
 					auto filter = make_uniq<LogicalFilter>(std::move(any_join.condition));
 					filter->children.push_back(std::move(new_join));
 
 					plan = std::move(filter);
+
+					// The filter and everything above the join now have to reference the columns of the projections
+					ColumnBindingReplacer replacer;
+					replacer.replacement_bindings = std::move(replacements);
+					replacer.stop_operator = join_ref;
+					replacer.VisitOperator(*root);
 				}
 			}
 		}
 	}
 
-	static void Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	static void OptimizeRecursive(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &root,
+	                              unique_ptr<LogicalOperator> &plan) {
 
-		TryOptimize(input.context, input.info.get(), plan);
+		TryOptimize(input, root, plan);
 
 		// Recursively optimize the children
 		for (auto &child : plan->children) {
-			Optimize(input, child);
+			OptimizeRecursive(input, root, child);
 		}
 	}
+
+	static void Optimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+		OptimizeRecursive(input, plan, plan);
+	}
 };
 
 //------------------------------------------------------------------------------
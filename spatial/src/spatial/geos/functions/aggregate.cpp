@@ -12,30 +12,38 @@ namespace spatial {
 
 namespace geos {
 
-struct GEOSAggState {
-	GEOSGeometry *geom = nullptr;
-	GEOSContextHandle_t context = nullptr;
+//------------------------------------------------------------------------
+// Context
+//------------------------------------------------------------------------
+// GEOS contexts only hold the error handlers and messages, geometries are not tied to the context that created them.
+// So instead of creating a context for every aggregate state (i.e. every group), each thread lazily creates a single
+// context that all the states use while they are processed by that thread.
+struct GEOSAggContext {
+	GEOSContextHandle_t handle;
 
-	~GEOSAggState() {
-		if (geom) {
-			GEOSGeom_destroy_r(context, geom);
-			geom = nullptr;
-		}
-		if (context) {
-			GEOS_finish_r(context);
-			context = nullptr;
-		}
+	GEOSAggContext() : handle(GEOS_init_r()) {
+	}
+	~GEOSAggContext() {
+		GEOS_finish_r(handle);
+	}
+
+	static GEOSContextHandle_t Get() {
+		static thread_local GEOSAggContext context;
+		return context.handle;
 	}
 };
 
 //------------------------------------------------------------------------
 // INTERSECTION
 //------------------------------------------------------------------------
+struct GEOSAggState {
+	GEOSGeometry *geom;
+};
+
 struct IntersectionAggFunction {
 	template <class STATE>
 	static void Initialize(STATE &state) {
 		state.geom = nullptr;
-		state.context = GEOS_init_r();
 	}
 
 	template <class STATE, class OP>
@@ -43,25 +51,27 @@ struct IntersectionAggFunction {
 		if (!source.geom) {
 			return;
 		}
+		auto context = GEOSAggContext::Get();
 		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
+			target.geom = GEOSGeom_clone_r(context, source.geom);
 			return;
 		}
 		auto curr = target.geom;
-		target.geom = GEOSIntersection_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
+		target.geom = GEOSIntersection_r(context, curr, source.geom);
+		GEOSGeom_destroy_r(context, curr);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
 	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
+		auto context = GEOSAggContext::Get();
 		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
+			state.geom = DeserializeGEOSGeometry(input, context);
 		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
+			auto next = DeserializeGEOSGeometry(input, context);
 			auto curr = state.geom;
-			state.geom = GEOSIntersection_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
+			state.geom = GEOSIntersection_r(context, curr, next);
+			GEOSGeom_destroy_r(context, next);
+			GEOSGeom_destroy_r(context, curr);
 		}
 	}
 
@@ -69,7 +79,7 @@ struct IntersectionAggFunction {
 	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
 		// There is no point in doing anything else, intersection is idempotent
 		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
+			state.geom = DeserializeGEOSGeometry(input, GEOSAggContext::Get());
 		}
 	}
 
@@ -78,20 +88,16 @@ struct IntersectionAggFunction {
 		if (!state.geom) {
 			finalize_data.ReturnNull();
 		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			target = SerializeGEOSGeometry(finalize_data.result, state.geom, GEOSAggContext::Get());
 		}
 	}
 
 	template <class STATE>
 	static void Destroy(STATE &state, AggregateInputData &) {
 		if (state.geom) {
-			GEOSGeom_destroy_r(state.context, state.geom);
+			GEOSGeom_destroy_r(GEOSAggContext::Get(), state.geom);
 			state.geom = nullptr;
 		}
-		if (state.context) {
-			GEOS_finish_r(state.context);
-			state.context = nullptr;
-		}
 	}
 
 	static bool IgnoreNull() {
@@ -102,68 +108,193 @@ struct IntersectionAggFunction {
 //------------------------------------------------------------------------
 // UNION
 //------------------------------------------------------------------------
+// Unioning each row into the accumulated result is quadratic in the complexity of the result. Instead we buffer the
+// input geometries and union them in batches using the cascaded GEOSUnaryUnion. The batch results are merged like a
+// binary counter, level i holds the union of 2^i batches, so every geometry takes part in O(log n) unions.
+//
+// The state is a plain struct and its arrays are allocated in the aggregate arena, so that grouped aggregates with
+// many (small) groups don't pay for a heap allocation per group.
+struct GEOSUnionAggState {
+	static constexpr uint32_t BATCH_SIZE = 1024;
+
+	//! The input geometries that have not been unioned yet
+	GEOSGeometry **buffer;
+	uint32_t buffer_count;
+	uint32_t buffer_capacity;
+	//! The unions of the previous batches, level i is either null or the union of 2^i batches
+	GEOSGeometry **levels;
+	uint32_t level_count;
+	uint32_t level_capacity;
+	//! The union of everything, set by Finish
+	GEOSGeometry *result;
+
+	void Initialize() {
+		buffer = nullptr;
+		buffer_count = 0;
+		buffer_capacity = 0;
+		levels = nullptr;
+		level_count = 0;
+		level_capacity = 0;
+		result = nullptr;
+	}
+
+	bool IsEmpty() const {
+		if (result || buffer_count != 0) {
+			return false;
+		}
+		for (uint32_t i = 0; i < level_count; i++) {
+			if (levels[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static GEOSGeometry **Grow(ArenaAllocator &arena, GEOSGeometry **array, uint32_t &capacity, uint32_t min_capacity) {
+		if (capacity >= min_capacity) {
+			return array;
+		}
+		const auto old_size = capacity * sizeof(GEOSGeometry *);
+		capacity = MaxValue<uint32_t>(capacity * 2, MaxValue<uint32_t>(min_capacity, 4));
+		const auto new_size = capacity * sizeof(GEOSGeometry *);
+		if (!array) {
+			return reinterpret_cast<GEOSGeometry **>(arena.AllocateAligned(new_size));
+		}
+		return reinterpret_cast<GEOSGeometry **>(
+		    arena.ReallocateAligned(reinterpret_cast<data_ptr_t>(array), old_size, new_size));
+	}
+
+	void Add(ArenaAllocator &arena, GEOSContextHandle_t context, GEOSGeometry *geom) {
+		buffer = Grow(arena, buffer, buffer_capacity, buffer_count + 1);
+		buffer[buffer_count++] = geom;
+		if (buffer_count >= BATCH_SIZE) {
+			Flush(arena, context);
+		}
+	}
+
+	//! Union the geometries in the array, takes ownership of the geometries
+	static GEOSGeometry *UnaryUnion(GEOSContextHandle_t context, GEOSGeometry **geoms, uint32_t count) {
+		if (count == 1) {
+			return geoms[0];
+		}
+		auto collection = GEOSGeom_createCollection_r(context, GEOS_GEOMETRYCOLLECTION, geoms, count);
+		auto result = GEOSUnaryUnion_r(context, collection);
+		GEOSGeom_destroy_r(context, collection);
+		return result;
+	}
+
+	//! Union the buffered geometries and merge the result into the levels
+	void Flush(ArenaAllocator &arena, GEOSContextHandle_t context) {
+		if (buffer_count == 0) {
+			return;
+		}
+		auto geom = UnaryUnion(context, buffer, buffer_count);
+		buffer_count = 0;
+
+		uint32_t level = 0;
+		for (; level < level_count && levels[level]; level++) {
+			auto merged = GEOSUnion_r(context, levels[level], geom);
+			GEOSGeom_destroy_r(context, levels[level]);
+			GEOSGeom_destroy_r(context, geom);
+			levels[level] = nullptr;
+			geom = merged;
+		}
+		if (level == level_count) {
+			levels = Grow(arena, levels, level_capacity, level_count + 1);
+			level_count++;
+		}
+		levels[level] = geom;
+	}
+
+	//! Union everything into a single geometry. The result stays owned by the state, so the state can be finalized more
+	//! than once, e.g. by window functions or repeated finalization of a combined state.
+	//! The arrays of the state are not grown here, they live in the aggregate arena and the finalize allocator is not
+	//! guaranteed to outlive the state.
+	const GEOSGeometry *Finish(GEOSContextHandle_t context) {
+		vector<GEOSGeometry *> geoms;
+		if (result) {
+			geoms.push_back(result);
+		}
+		for (uint32_t i = 0; i < level_count; i++) {
+			if (levels[i]) {
+				geoms.push_back(levels[i]);
+				levels[i] = nullptr;
+			}
+		}
+		geoms.insert(geoms.end(), buffer, buffer + buffer_count);
+		buffer_count = 0;
+		result = UnaryUnion(context, geoms.data(), static_cast<uint32_t>(geoms.size()));
+		return result;
+	}
+
+	void Destroy(GEOSContextHandle_t context) {
+		for (uint32_t i = 0; i < buffer_count; i++) {
+			GEOSGeom_destroy_r(context, buffer[i]);
+		}
+		buffer_count = 0;
+		for (uint32_t i = 0; i < level_count; i++) {
+			if (levels[i]) {
+				GEOSGeom_destroy_r(context, levels[i]);
+			}
+		}
+		level_count = 0;
+		if (result) {
+			GEOSGeom_destroy_r(context, result);
+			result = nullptr;
+		}
+	}
+};
 
 struct UnionAggFunction {
 	template <class STATE>
 	static void Initialize(STATE &state) {
-		state.geom = nullptr;
-		state.context = GEOS_init_r();
+		state.Initialize();
 	}
 
 	template <class STATE, class OP>
 	static void Combine(const STATE &source, STATE &target, AggregateInputData &data) {
-		if (!source.geom) {
-			return;
+		// The partial results of each thread end up in the buffer of the target, and are unioned together by the
+		// cascaded union, which merges them as a balanced tree.
+		auto context = GEOSAggContext::Get();
+		for (uint32_t i = 0; i < source.buffer_count; i++) {
+			target.Add(data.allocator, context, GEOSGeom_clone_r(context, source.buffer[i]));
 		}
-		if (!target.geom) {
-			target.geom = GEOSGeom_clone_r(target.context, source.geom);
-			return;
+		for (uint32_t i = 0; i < source.level_count; i++) {
+			if (source.levels[i]) {
+				target.Add(data.allocator, context, GEOSGeom_clone_r(context, source.levels[i]));
+			}
+		}
+		if (source.result) {
+			target.Add(data.allocator, context, GEOSGeom_clone_r(context, source.result));
 		}
-		auto curr = target.geom;
-		target.geom = GEOSUnion_r(target.context, curr, source.geom);
-		GEOSGeom_destroy_r(target.context, curr);
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
-	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &) {
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		} else {
-			auto next = DeserializeGEOSGeometry(input, state.context);
-			auto curr = state.geom;
-			state.geom = GEOSUnion_r(state.context, curr, next);
-			GEOSGeom_destroy_r(state.context, next);
-			GEOSGeom_destroy_r(state.context, curr);
-		}
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg) {
+		auto context = GEOSAggContext::Get();
+		state.Add(agg.input.allocator, context, DeserializeGEOSGeometry(input, context));
 	}
 
 	template <class INPUT_TYPE, class STATE, class OP>
-	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &, idx_t count) {
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &agg, idx_t count) {
 		// There is no point in doing anything else, union is idempotent
-		if (!state.geom) {
-			state.geom = DeserializeGEOSGeometry(input, state.context);
-		}
+		Operation<INPUT_TYPE, STATE, OP>(state, input, agg);
 	}
 
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
-		if (!state.geom) {
+		if (state.IsEmpty()) {
 			finalize_data.ReturnNull();
 		} else {
-			target = SerializeGEOSGeometry(finalize_data.result, state.geom, state.context);
+			auto context = GEOSAggContext::Get();
+			auto geom = state.Finish(context);
+			target = SerializeGEOSGeometry(finalize_data.result, geom, context);
 		}
 	}
 
 	template <class STATE>
 	static void Destroy(STATE &state, AggregateInputData &) {
-		if (state.geom) {
-			GEOSGeom_destroy_r(state.context, state.geom);
-			state.geom = nullptr;
-		}
-		if (state.context) {
-			GEOS_finish_r(state.context);
-			state.context = nullptr;
-		}
+		state.Destroy(GEOSAggContext::Get());
 	}
 
 	static bool IgnoreNull() {
@@ -206,7 +337,7 @@ void GeosAggregateFunctions::Register(DatabaseInstance &db) {
 
 	AggregateFunctionSet st_union_agg("ST_Union_Agg");
 	st_union_agg.AddFunction(
-	    AggregateFunction::UnaryAggregateDestructor<GEOSAggState, geometry_t, geometry_t, UnionAggFunction>(
+	    AggregateFunction::UnaryAggregateDestructor<GEOSUnionAggState, geometry_t, geometry_t, UnionAggFunction>(
 	        core::GeoTypes::GEOMETRY(), core::GeoTypes::GEOMETRY()));
 
 	ExtensionUtil::RegisterFunction(db, st_union_agg);
@@ -11,7 +11,7 @@ namespace spatial {
 namespace geos {
 
 static bool WKBToWKTCast(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	auto ctx = GeosContextWrapper();
+	GeosContextWrapper ctx;
 	auto reader = ctx.CreateWKBReader();
 	auto writer = ctx.CreateWKTWriter();
 	writer.SetTrim(true);
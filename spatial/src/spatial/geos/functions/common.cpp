@@ -1,13 +1,165 @@
 #include "spatial/common.hpp"
 #include "spatial/geos/functions/common.hpp"
 
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/extension_util.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
 namespace spatial {
 
 namespace geos {
 
 using namespace spatial::core;
 
-GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context) : ctx(), arena(BufferAllocator::Get(context)) {
+//------------------------------------------------------------------------------
+// Prepared Geometry Cache
+//------------------------------------------------------------------------------
+// The cache statistics of all threads of a database, kept in the object cache of the database instance
+struct GEOSPreparedCacheStats final : public ObjectCacheEntry {
+	atomic<idx_t> hits {0};
+	atomic<idx_t> misses {0};
+
+	static string ObjectType() {
+		return "spatial_geos_prepared_cache_stats";
+	}
+
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	static shared_ptr<GEOSPreparedCacheStats> Get(ClientContext &context) {
+		return ObjectCache::GetObjectCache(context).GetOrCreate<GEOSPreparedCacheStats>(ObjectType());
+	}
+};
+
+GEOSPreparedCache::GEOSPreparedCache(idx_t capacity, shared_ptr<GEOSPreparedCacheStats> stats_p)
+    : capacity(capacity), stats(std::move(stats_p)) {
+}
+
+GEOSPreparedCache::~GEOSPreparedCache() {
+	stats->hits += hits;
+	stats->misses += misses;
+
+	// The prepared geometries reference the geometries, so destroy them first
+	for (auto &entry : entries) {
+		entry.prepared.reset();
+	}
+}
+
+const GEOSPreparedGeometry *GEOSPreparedCache::Get(GeosContextWrapper &ctx, const geometry_t &blob) {
+	if (capacity == 0) {
+		return nullptr;
+	}
+
+	// Preparing a point doesn't make anything faster
+	if (blob.GetType() == GeometryType::POINT) {
+		return nullptr;
+	}
+
+	const string_t data = blob;
+	const auto hash = Hash(data.GetData(), data.GetSize());
+	tick++;
+
+	for (auto &entry : entries) {
+		if (entry.hash != hash) {
+			continue;
+		}
+		entry.last_used = tick;
+
+		if (entry.prepared && entry.blob.size() == data.GetSize() &&
+		    memcmp(entry.blob.data(), data.GetData(), data.GetSize()) == 0) {
+			hits++;
+			return entry.prepared.get();
+		}
+
+		// We've seen this geometry before (or it's a hash collision), prepare it now
+		misses++;
+		entry.prepared.reset();
+		entry.blob = string(data.GetData(), data.GetSize());
+		entry.geom = ctx.Deserialize(blob);
+		entry.prepared = make_uniq_geos(ctx.GetCtx(), GEOSPrepare_r(ctx.GetCtx(), entry.geom.get()));
+		return entry.prepared.get();
+	}
+
+	// First time we see this geometry, only remember the hash
+	misses++;
+	if (entries.size() < capacity) {
+		entries.emplace_back();
+		auto &entry = entries.back();
+		entry.hash = hash;
+		entry.last_used = tick;
+		return nullptr;
+	}
+
+	// Evict the least recently used entry
+	auto &entry = *std::min_element(entries.begin(), entries.end(),
+	                                [](const Entry &a, const Entry &b) { return a.last_used < b.last_used; });
+	entry.prepared.reset();
+	entry.geom.reset();
+	entry.blob.clear();
+	entry.hash = hash;
+	entry.last_used = tick;
+	return nullptr;
+}
+
+static unique_ptr<FunctionData> PreparedCacheStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	names.emplace_back("hits");
+	return_types.emplace_back(LogicalType::UBIGINT);
+
+	names.emplace_back("misses");
+	return_types.emplace_back(LogicalType::UBIGINT);
+
+	return nullptr;
+}
+
+struct PreparedCacheStatsState final : public GlobalTableFunctionState {
+	bool done = false;
+};
+
+static unique_ptr<GlobalTableFunctionState> PreparedCacheStatsInit(ClientContext &context,
+                                                                   TableFunctionInitInput &input) {
+	return make_uniq<PreparedCacheStatsState>();
+}
+
+static void PreparedCacheStatsExecute(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<PreparedCacheStatsState>();
+	if (state.done) {
+		return;
+	}
+	auto stats = GEOSPreparedCacheStats::Get(context);
+	output.data[0].SetValue(0, Value::UBIGINT(stats->hits.load()));
+	output.data[1].SetValue(0, Value::UBIGINT(stats->misses.load()));
+	output.SetCardinality(1);
+	state.done = true;
+}
+
+void GEOSPreparedCache::Register(DatabaseInstance &db) {
+	TableFunction stats_function("geos_prepared_cache_stats", {}, PreparedCacheStatsExecute, PreparedCacheStatsBind,
+	                             PreparedCacheStatsInit);
+	ExtensionUtil::RegisterFunction(db, stats_function);
+
+	auto &config = DBConfig::GetConfig(db);
+	config.AddExtensionOption(SIZE_SETTING,
+	                          "The number of geometries each thread keeps prepared when evaluating spatial predicates "
+	                          "on non-constant arguments. Set to 0 to disable the cache.",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_SIZE));
+}
+
+//------------------------------------------------------------------------------
+// Function Local State
+//------------------------------------------------------------------------------
+static idx_t GetPreparedCacheSize(ClientContext &context) {
+	Value size;
+	if (context.TryGetCurrentSetting(GEOSPreparedCache::SIZE_SETTING, size)) {
+		return size.GetValue<uint64_t>();
+	}
+	return GEOSPreparedCache::DEFAULT_SIZE;
+}
+
+GEOSFunctionLocalState::GEOSFunctionLocalState(ClientContext &context)
+    : ctx(), arena(BufferAllocator::Get(context)),
+      cache(GetPreparedCacheSize(context), GEOSPreparedCacheStats::Get(context)) {
 	// TODO: Set GEOS error handler
 	// GEOSContext_setErrorMessageHandler_r()
 }
@@ -35,4 +187,4 @@ GEOSFunctionLocalState &GEOSFunctionLocalState::ResetAndGet(ExpressionState &sta
 
 } // namespace geos
 
-} // namespace spatial
\ No newline at end of file
+} // namespace spatial
@@ -21,7 +21,8 @@ static void CoveredByFunction(DataChunk &args, ExpressionState &state, Vector &r
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCoveredBy_r,
-	                                                GEOSPreparedCoveredBy_r);
+	                                                GEOSPreparedCoveredBy_r, PointInPolygon::TryCoveredBy,
+	                                                GEOSPreparedCovers_r);
 }
 
 //------------------------------------------------------------------------------
@@ -21,7 +21,7 @@ static void CoversFunction(DataChunk &args, ExpressionState &state, Vector &resu
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteNonSymmetricPreparedBinary(lstate, left, right, count, result, GEOSCovers_r,
-	                                                GEOSPreparedCovers_r);
+	                                                GEOSPreparedCovers_r, PointInPolygon::TryCovers);
 }
 
 //------------------------------------------------------------------------------
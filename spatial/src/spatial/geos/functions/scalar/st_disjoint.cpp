@@ -20,8 +20,9 @@ static void DisjointFunction(DataChunk &args, ExpressionState &state, Vector &re
 	auto &left = args.data[0];
 	auto &right = args.data[1];
 	auto count = args.size();
+	// Geometries with disjoint bounding boxes are disjoint
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSDisjoint_r,
-	                                             GEOSPreparedDisjoint_r);
+	                                             GEOSPreparedDisjoint_r, nullptr, true);
 }
 
 //------------------------------------------------------------------------------
@@ -21,7 +21,7 @@ static void IntersectsFunction(DataChunk &args, ExpressionState &state, Vector &
 	auto &right = args.data[1];
 	auto count = args.size();
 	GEOSExecutor::ExecuteSymmetricPreparedBinary(lstate, left, right, count, result, GEOSIntersects_r,
-	                                             GEOSPreparedIntersects_r);
+	                                             GEOSPreparedIntersects_r, PointInPolygon::TryIntersects);
 }
 
 //------------------------------------------------------------------------------
@@ -25,6 +25,9 @@ class GEOSDeserializer final : GeometryProcessor<GEOSGeometry *> {
 private:
 	GEOSContextHandle_t ctx;
 	vector<double> aligned_buffer;
+	//! Scratch space for the rings of polygons and the parts of collections. Nested geometries push their parts on
+	//! top of their parent's and pop them again before returning, so this is used as a stack.
+	vector<GEOSGeometry *> parts;
 
 private:
 	GEOSCoordSeq_t *HandleVertexData(const VertexData &vertices) {
@@ -43,8 +46,10 @@ private:
 			auto vertex_data = reinterpret_cast<const double *>(data_ptr);
 			if (!IsPointerAligned<double>(data_ptr)) {
 				// If the pointer is not aligned we need to copy the data to an aligned buffer before passing it to GEOS
-				aligned_buffer.clear();
-				aligned_buffer.resize(count * n_dims);
+				// The buffer is only ever grown, so this doesn't allocate once we've seen the largest ring
+				if (aligned_buffer.size() < count * n_dims) {
+					aligned_buffer.resize(count * n_dims);
+				}
 				memcpy(aligned_buffer.data(), data_ptr, count * vertex_size);
 				vertex_data = aligned_buffer.data();
 			}
@@ -76,15 +81,15 @@ private:
 		if (num_rings == 0) {
 			return GEOSGeom_createEmptyPolygon_r(ctx);
 		} else {
-			// TODO: Make a vector here instead of using new
-			auto geoms = new GEOSGeometry *[num_rings];
+			const auto offset = parts.size();
 			for (uint32_t i = 0; i < num_rings; i++) {
 				auto vertices = state.Next();
 				auto seq = HandleVertexData(vertices);
-				geoms[i] = GEOSGeom_createLinearRing_r(ctx, seq);
+				parts.push_back(GEOSGeom_createLinearRing_r(ctx, seq));
 			}
-			auto result = GEOSGeom_createPolygon_r(ctx, geoms[0], geoms + 1, num_rings - 1);
-			delete[] geoms;
+			auto rings = parts.data() + offset;
+			auto result = GEOSGeom_createPolygon_r(ctx, rings[0], rings + 1, num_rings - 1);
+			parts.resize(offset);
 			return result;
 		}
 	}
@@ -108,12 +113,14 @@ private:
 		if (item_count == 0) {
 			return GEOSGeom_createEmptyCollection_r(ctx, collection_type);
 		} else {
-			auto geoms = new GEOSGeometry *[item_count];
+			const auto offset = parts.size();
 			for (uint32_t i = 0; i < item_count; i++) {
-				geoms[i] = state.Next();
+				// The item pops its own parts before returning, so this always lands right after the previous item
+				auto item = state.Next();
+				parts.push_back(item);
 			}
-			auto result = GEOSGeom_createCollection_r(ctx, collection_type, geoms, item_count);
-			delete[] geoms;
+			auto result = GEOSGeom_createCollection_r(ctx, collection_type, parts.data() + offset, item_count);
+			parts.resize(offset);
 			return result;
 		}
 	}
@@ -123,7 +130,8 @@ public:
 	}
 
 	GeometryPtr Execute(const geometry_t &geom) {
-		return GeometryPtr {Process(geom)};
+		parts.clear();
+		return GeometryPtr {Process(geom), GeosDeleter<GEOSGeometry> {ctx}};
 	}
 };
 
@@ -132,9 +140,21 @@ GEOSGeometry *DeserializeGEOSGeometry(const geometry_t &blob, GEOSContextHandle_
 	return deserializer.Execute(blob).release();
 }
 
+GeosContextWrapper::GeosContextWrapper() {
+	ctx = GEOS_init_r();
+	GEOSContext_setErrorMessageHandler_r(ctx, ErrorHandler, (void *)nullptr);
+}
+
+GeosContextWrapper::~GeosContextWrapper() {
+	deserializer.reset();
+	GEOS_finish_r(ctx);
+}
+
 GeometryPtr GeosContextWrapper::Deserialize(const geometry_t &blob) {
-	GEOSDeserializer deserializer(ctx);
-	return deserializer.Execute(blob);
+	if (!deserializer) {
+		deserializer = make_uniq<GEOSDeserializer>(ctx);
+	}
+	return deserializer->Execute(blob);
 }
 
 //-------------------------------------------------------------------
@@ -2,6 +2,7 @@
 #include "spatial/geos/functions/aggregate.hpp"
 #include "spatial/geos/functions/scalar.hpp"
 #include "spatial/geos/functions/cast.hpp"
+#include "spatial/geos/functions/common.hpp"
 
 #include "spatial/common.hpp"
 
@@ -13,6 +14,7 @@ void GeosModule::Register(DatabaseInstance &db) {
 	GEOSScalarFunctions::Register(db);
 	GeosAggregateFunctions::Register(db);
 	GeosCastFunctions::Register(db);
+	GEOSPreparedCache::Register(db);
 }
 
 } // namespace geos